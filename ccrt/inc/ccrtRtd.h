@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccrtRtd.h                                                                   Copyright CERN 2015
+
+  License:  This program is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Converter status real-time display for ccrt
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    The real-time thread calls ccrtRtdSample() every iteration to copy the values to display from
+            reg_conv into a snapshot protected by a sequence counter.  The real-time thread never waits:
+            if the background thread is reading the snapshot while it is being written, the reader sees
+            the counter change and tries again.  The background thread calls ccrtRtdRefresh() which
+            updates the display at the configured refresh period using the libterm RTD, so only the
+            characters that have changed are sent to the terminal.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCRTRTD_H
+#define CCRTRTD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libreg.h"
+#include "libterm.h"
+
+// Constants
+
+#define CCRT_RTD_NUM_LINES              2               // Number of status lines
+#define CCRT_RTD_DEFAULT_PERIOD_MS      100             // Default refresh period in milliseconds
+
+// Snapshot of the values displayed
+
+struct ccrt_rtd_data
+{
+    enum reg_mode       reg_mode;                       // Regulation mode
+    float               ref;                            // Field or current reference (or voltage in REG_VOLTAGE)
+    float               meas;                           // Field or current measurement (or voltage in REG_VOLTAGE)
+    float               err;                            // Regulation error
+    float               max_abs_err;                    // Max absolute regulation error
+    float               v_ref;                          // Voltage reference after limits
+    uint32_t            ref_clip;                       // Reference is being clipped
+    uint32_t            ref_rate;                       // Reference rate of change is being clipped
+    bool                meas_trip;                      // Measurement trip limit exceeded
+    bool                meas_low;                       // Measurement below low threshold
+    bool                meas_zero;                      // Measurement below zero threshold
+    bool                err_warning;                    // Regulation error warning
+    bool                err_fault;                      // Regulation error fault
+    uint32_t            iter_time_us;                   // Time taken by the last iteration
+    uint32_t            max_iter_time_us;               // Longest iteration since the last refresh
+    uint32_t            iter_period_us;                 // Iteration period
+};
+
+// Function declarations
+
+void     ccrtRtdInit    (uint32_t refresh_period_ms);
+void     ccrtRtdSample  (const struct reg_conv *conv, uint32_t iter_time_us);
+bool     ccrtRtdRead    (struct ccrt_rtd_data *data);
+void     ccrtRtdReset   (uint16_t first_row, uint16_t num_cols);
+int      ccrtRtdTimeout (void);
+void     ccrtRtdRefresh (FILE *file);
+
+#endif
+
+// EOF
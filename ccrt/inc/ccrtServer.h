@@ -0,0 +1,53 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccrtServer.h                                                                Copyright CERN 2015
+
+  License:  This program is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Multi-session console server for ccrt
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    The server accepts console sessions on a Unix-domain socket and/or a loopback TCP port.
+            Each session has its own libterm terminal, so it has its own line editor and history.
+            All the sockets are served by one background thread using epoll, so the sessions never
+            block the real-time thread.  Command lines are passed to the callback in the server thread.
+
+            A session can be opened with, for example:
+
+                socat -,raw,echo=0 unix-connect:/tmp/ccrt.sock
+                socat -,raw,echo=0 tcp:localhost:7000
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCRTSERVER_H
+#define CCRTSERVER_H
+
+#include <stdint.h>
+
+#include "libterm.h"
+
+// Constants
+
+#define CCRT_SERVER_MAX_SESSIONS        16              // Maximum number of simultaneous sessions
+#define CCRT_SERVER_NUM_COLUMNS         80              // Terminal width assumed for sessions
+#define CCRT_SERVER_BUF_LEN             4096            // Maximum number of characters read at once
+#define CCRT_SERVER_OUT_BUF_LEN         65536           // Output buffered for a session that is slow to read
+
+// Function declarations
+
+int32_t ccrtServerStart(const char *unix_path, uint16_t tcp_port, char prompt,
+                        void (*term_line)(struct term *term, char *line, uint16_t line_len));
+
+#endif
+
+// EOF
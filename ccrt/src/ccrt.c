@@ -30,17 +30,23 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <termios.h>
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 
 #include "libterm.h"                    // Include libterm header file
+#include "ccrtServer.h"
+#include "ccrtRtd.h"
 
 // Constants
 
 #define PROMPT          '>'             // Prompt can only be a single character
-#define N_RTD_LINES     3               // Number of real-time display lines
+#define KEYBOARD_BUF_LEN 4096           // Maximum number of keyboard characters read at once
+#define N_RTD_LINES     5               // Number of real-time display lines
+#define RTD_STATUS      4               // First converter status line row (from bottom)
 #define RTD_RULER       2               // Ruler line row (from bottom)
 #define RTD_REPORT      1               // Report line for new character (from bottom)
 #define RTD_RESULT      0               // Resulting input line (from bottom)
@@ -49,6 +55,7 @@
 
 struct termios stdin_config;            // Original stdin configuration used by ResetStdinConfig()
 struct winsize window;                  // Window size is window.ws_row x window.ws_col
+struct reg_conv conv;                   // Converter regulation structure shown in the status lines
 
 /*---------------------------------------------------------------------------------------------------------*/
 static void ResetStdinConfig(void)
@@ -124,6 +131,10 @@ static void ResetTerm(void)
            (uint16_t)(window.ws_row - RTD_REPORT));
 
     fflush(stdout);
+
+    // Converter status lines are redrawn completely at the next refresh
+
+    ccrtRtdReset(window.ws_row - RTD_STATUS, window.ws_col);
 }
 /*---------------------------------------------------------------------------------------------------------*/
 static void SigWinch(int sig)
@@ -153,12 +164,54 @@ void ProcessLine(char *line, uint16_t line_len)
 
 }
 /*---------------------------------------------------------------------------------------------------------*/
+static void ProcessSessionLine(struct term *term, char *line, uint16_t line_len)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is called in the server thread for each line entered in a console session.  It must only
+  write to the session's terminal stream.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    fprintf(term->file, "\r\nLine length: %3hu  Line: %s", line_len, line);
+}
+/*---------------------------------------------------------------------------------------------------------*/
 int main(int argc, char **argv)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    int            keyboard_ch;
+    char           keyboard_buf[KEYBOARD_BUF_LEN];
+    ssize_t        num_chars;
+    char          *ctrl_c;
     uint16_t       term_level;
     struct termios stdin_config_raw;
+    const char    *unix_path = NULL;
+    uint16_t       tcp_port  = 0;
+    uint32_t       refresh_period_ms = CCRT_RTD_DEFAULT_PERIOD_MS;
+    struct pollfd  stdin_poll = { .fd = STDIN_FILENO, .events = POLLIN };
+    int            option;
+
+    // Start the console server if a Unix-domain socket (-u path) or loopback TCP port (-p port) is given.
+    // The converter status refresh period can be set in milliseconds (-r period).
+
+    while((option = getopt(argc, argv, "u:p:r:")) != -1)
+    {
+        switch(option)
+        {
+        case 'u':   unix_path = optarg;                 break;
+        case 'p':   tcp_port  = atoi(optarg);           break;
+        case 'r':   refresh_period_ms = atoi(optarg);   break;
+        default:    fprintf(stderr, "usage: %s [-u unix_socket_path] [-p tcp_port] [-r refresh_period_ms]\n",
+                            argv[0]);
+                    exit(1);
+        }
+    }
+
+    conv.reg_mode = REG_NONE;
+
+    ccrtRtdInit(refresh_period_ms);
+
+    if((unix_path != NULL || tcp_port != 0) &&
+        ccrtServerStart(unix_path, tcp_port, PROMPT, ProcessSessionLine) != 0)
+    {
+        exit(1);
+    }
 
     // Catch SIGWINCH
 
@@ -189,32 +242,51 @@ int main(int argc, char **argv)
 
     for(;;)
     {
-        // Wait for the next keyboard character
+        // Refresh the converter status lines when due. ccrt has no real-time thread yet, so the
+        // snapshot is taken here - once there is one, it must call ccrtRtdSample() every iteration.
+
+        ccrtRtdSample(&conv, 0);
+        ccrtRtdRefresh(stdout);
+
+        // Wait for the next keyboard characters - a paste arrives as one chunk
 
         fflush(stdout);
 
-        keyboard_ch = getchar();
+        if(poll(&stdin_poll, 1, ccrtRtdTimeout()) <= 0)
+        {
+            continue;
+        }
 
-        // Report character value in the info zone on the terminal
+        num_chars = read(STDIN_FILENO, keyboard_buf, sizeof(keyboard_buf));
+
+        if(num_chars <= 0)
+        {
+            continue;
+        }
+
+        // Report the last character value in the info zone on the terminal
 
         printf(TERM_SAVE_POS TERM_CSI "%hu;21" TERM_GOTO TERM_CSI TERM_BOLD TERM_SGR "%3u" TERM_RESTORE_POS,
-                (uint16_t)(window.ws_row - RTD_REPORT), keyboard_ch);
+                (uint16_t)(window.ws_row - RTD_REPORT), (unsigned char)keyboard_buf[num_chars-1]);
+
+        // Catch CTRL-C to exit after processing the characters before it
 
-        // Catch CTRL-C to exit
+        ctrl_c = memchr(keyboard_buf, 0x03, num_chars);
 
-        if(keyboard_ch == 0x03)
+        if(ctrl_c != NULL)
         {
+            TermChars(keyboard_buf, ctrl_c - keyboard_buf);
             printf("\nExiting\n");
             exit(0);
         }
 
         // Give characters to libterm to be processed
 
-        term_level = TermChar(keyboard_ch);
+        term_level = TermChars(keyboard_buf, num_chars);
 
         // Check for ESC pressed twice - this will appear as ESC at terminal level zero
 
-        if(term_level == 0 && keyboard_ch == TERM_ESC)
+        if(term_level == 0 && keyboard_buf[num_chars-1] == TERM_ESC)
         {
             ResetTerm();
         }
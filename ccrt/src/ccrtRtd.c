@@ -0,0 +1,236 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccrtRtd.c                                                                   Copyright CERN 2015
+
+  License:  This program is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Converter status real-time display for ccrt
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    The sequence counter is odd while the real-time thread is writing the snapshot.  The reader
+            copies the snapshot and accepts it only if the counter was even and did not change.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include <time.h>
+
+#include "ccrtRtd.h"
+
+// Constants
+
+#define READ_RETRIES            8               // Attempts to read a consistent snapshot before giving up
+
+// Static variables
+
+static struct ccrt_rtd
+{
+    uint32_t                seq;                // Sequence counter - odd while the snapshot is being written
+    uint32_t                reset_max_f;        // Set by the reader to restart max_iter_time_us
+    struct ccrt_rtd_data    data;               // Snapshot written by the real-time thread
+    struct ccrt_rtd_data    display;            // Last consistent snapshot read by the background thread
+    uint32_t                refresh_period_ms;  // Display refresh period
+    struct timespec         next_refresh;       // Time of the next refresh (CLOCK_MONOTONIC)
+    struct term_rtd         term_rtd;           // libterm RTD with the shadow screen
+} rtd;
+
+/*---------------------------------------------------------------------------------------------------------*/
+static int32_t ccrtRtdMsUntil(const struct timespec *t)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return((t->tv_sec - now.tv_sec) * 1000 + (t->tv_nsec - now.tv_nsec) / 1000000);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void ccrtRtdInit(uint32_t refresh_period_ms)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function sets the refresh period.  It must be called before the real-time thread starts sampling.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    memset(&rtd, 0, sizeof(rtd));
+
+    rtd.refresh_period_ms = refresh_period_ms > 0 ? refresh_period_ms : CCRT_RTD_DEFAULT_PERIOD_MS;
+    rtd.data.reg_mode     = REG_NONE;
+    rtd.display.reg_mode  = REG_NONE;
+
+    clock_gettime(CLOCK_MONOTONIC, &rtd.next_refresh);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void ccrtRtdSample(const struct reg_conv *conv, uint32_t iter_time_us)
+/*---------------------------------------------------------------------------------------------------------*\
+  This real-time function copies the values to display into the snapshot.  It takes a constant time and
+  never waits for the background thread.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    const struct reg_conv_signal *signal = conv->reg_signal;
+    uint32_t                      seq    = rtd.seq;                     // Only this thread writes seq
+
+    // Make the counter odd before changing the snapshot
+
+    __atomic_store_n(&rtd.seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if(__atomic_load_n(&rtd.reset_max_f, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&rtd.reset_max_f, 0, __ATOMIC_RELAXED);
+        rtd.data.max_iter_time_us = 0;
+    }
+
+    rtd.data.reg_mode       = conv->reg_mode;
+    rtd.data.ref_clip       = conv->flags.ref_clip;
+    rtd.data.ref_rate       = conv->flags.ref_rate;
+    rtd.data.v_ref          = conv->v.ref_limited;
+    rtd.data.iter_time_us   = iter_time_us;
+    rtd.data.iter_period_us = conv->iter_period_us;
+
+    if(iter_time_us > rtd.data.max_iter_time_us)
+    {
+        rtd.data.max_iter_time_us = iter_time_us;
+    }
+
+    if(conv->reg_mode == REG_VOLTAGE || signal == NULL)
+    {
+        rtd.data.ref         = conv->v.ref_limited;
+        rtd.data.meas        = conv->v.meas;
+        rtd.data.err         = conv->v.err.err;
+        rtd.data.max_abs_err = conv->v.err.max_abs_err;
+        rtd.data.err_warning = conv->v.err.warning.flag;
+        rtd.data.err_fault   = conv->v.err.fault.flag;
+        rtd.data.meas_trip   = false;
+        rtd.data.meas_low    = false;
+        rtd.data.meas_zero   = false;
+    }
+    else
+    {
+        rtd.data.ref         = conv->ref_limited;
+        rtd.data.meas        = conv->meas;
+        rtd.data.err         = signal->err.err;
+        rtd.data.max_abs_err = signal->err.max_abs_err;
+        rtd.data.err_warning = signal->err.warning.flag;
+        rtd.data.err_fault   = signal->err.fault.flag;
+        rtd.data.meas_trip   = signal->lim_meas.flags.trip;
+        rtd.data.meas_low    = signal->lim_meas.flags.low;
+        rtd.data.meas_zero   = signal->lim_meas.flags.zero;
+    }
+
+    // Make the counter even again to publish the snapshot
+
+    __atomic_store_n(&rtd.seq, seq + 2, __ATOMIC_RELEASE);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+bool ccrtRtdRead(struct ccrt_rtd_data *data)
+/*---------------------------------------------------------------------------------------------------------*\
+  This background function copies a consistent snapshot into data.  It returns false if the snapshot
+  changed during every attempt, in which case data is not changed.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccrt_rtd_data    copy;
+    uint32_t                seq;
+    uint32_t                retries;
+
+    for(retries = 0 ; retries < READ_RETRIES ; retries++)
+    {
+        seq = __atomic_load_n(&rtd.seq, __ATOMIC_ACQUIRE);
+
+        if((seq & 1) == 0)
+        {
+            copy = rtd.data;
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+            if(__atomic_load_n(&rtd.seq, __ATOMIC_RELAXED) == seq)
+            {
+                *data = copy;
+                return(true);
+            }
+        }
+    }
+
+    return(false);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void ccrtRtdReset(uint16_t first_row, uint16_t num_cols)
+/*---------------------------------------------------------------------------------------------------------*\
+  This background function positions the status lines at first_row and forces them to be redrawn at the
+  next refresh.  It must be called whenever the terminal is reset or resized.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    TermRtdInit(&rtd.term_rtd, first_row, CCRT_RTD_NUM_LINES, num_cols);
+
+    clock_gettime(CLOCK_MONOTONIC, &rtd.next_refresh);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+int ccrtRtdTimeout(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function returns the number of milliseconds until the next refresh is due, for use as a poll()
+  timeout.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    int32_t ms = ccrtRtdMsUntil(&rtd.next_refresh);
+
+    return(ms > 0 ? ms : 0);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void ccrtRtdRefresh(FILE *file)
+/*---------------------------------------------------------------------------------------------------------*\
+  This background function updates the status lines if the refresh is due.  If a consistent snapshot
+  cannot be read, the previous values are shown again.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    static const char * const mode_name[] = { "VOLTAGE", "CURRENT", "FIELD", "NONE" };
+    struct ccrt_rtd_data     *d = &rtd.display;
+    struct term_rtd          *t = &rtd.term_rtd;
+
+    if(ccrtRtdMsUntil(&rtd.next_refresh) > 0)
+    {
+        return;
+    }
+
+    // Schedule the next refresh - if the background thread fell behind, restart from now
+
+    rtd.next_refresh.tv_nsec += (rtd.refresh_period_ms % 1000) * 1000000;
+    rtd.next_refresh.tv_sec  += (rtd.refresh_period_ms / 1000) + rtd.next_refresh.tv_nsec / 1000000000;
+    rtd.next_refresh.tv_nsec %= 1000000000;
+
+    if(ccrtRtdMsUntil(&rtd.next_refresh) < 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &rtd.next_refresh);
+    }
+
+    if(ccrtRtdRead(d))
+    {
+        __atomic_store_n(&rtd.reset_max_f, 1, __ATOMIC_RELAXED);
+    }
+
+    // Print the status into the next screen and send the cells that changed
+
+    TermRtdPrintf(t, 0, 0, "%-7s REF:%11.4E MEAS:%11.4E ERR:%10.3E/%9.2E V:%11.4E",
+                  d->reg_mode <= REG_NONE ? mode_name[d->reg_mode] : "?",
+                  d->ref, d->meas, d->err, d->max_abs_err, d->v_ref);
+
+    TermRtdPrintf(t, 1, 0, "%-5s %-5s %-5s %-5s %-5s %-5s %-6s ITER:%5u/%5u/%5u us",
+                  d->ref_clip    ? "CLIP"    : "-",
+                  d->ref_rate    ? "RATE"    : "-",
+                  d->meas_trip   ? "TRIP"    : "-",
+                  d->meas_low    ? "LOW"     : "-",
+                  d->meas_zero   ? "ZERO"    : "-",
+                  d->err_warning ? "WARN"    : "-",
+                  d->err_fault   ? "FAULT"   : "-",
+                  d->iter_time_us, d->max_iter_time_us, d->iter_period_us);
+
+    TermRtdUpdate(t, file);
+}
+// EOF
@@ -0,0 +1,388 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccrtServer.c                                                                Copyright CERN 2015
+
+  License:  This program is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Multi-session console server for ccrt
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    Each epoll event carries an index: indexes below CCRT_SERVER_MAX_SESSIONS identify a session
+            and the listening sockets follow.  Sessions are held in a static array so no memory is
+            allocated apart from the stdio stream for each session.
+
+            The session sockets are non-blocking.  Each session's stdio stream writes into its output
+            buffer, which is sent after every event.  Anything that cannot be sent is left in the buffer
+            and EPOLLOUT is enabled until it drains, so a slow client never stalls the other sessions.
+            A session whose output buffer overflows is closed.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#define _GNU_SOURCE                                             // For accept4() and fopencookie()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ccrtServer.h"
+
+// Constants
+
+#define LISTEN_UNIX             CCRT_SERVER_MAX_SESSIONS        // epoll index for Unix-domain listener
+#define LISTEN_TCP              (CCRT_SERVER_MAX_SESSIONS+1)    // epoll index for TCP listener
+#define LISTEN_BACKLOG          8                               // Pending connections per listener
+#define CTRL_C                  0x03                            // Closes a session
+
+// Static variables
+
+static struct ccrt_server
+{
+    int          epoll_fd;                                      // epoll instance for all the sockets
+    int          listen_fd[2];                                  // Unix-domain and TCP listening sockets
+    char         prompt;                                        // Prompt character for the sessions
+    void        (*term_line)(struct term *term, char *line, uint16_t line_len);
+
+    struct ccrt_server_session
+    {
+        int          fd;                                        // Session socket (-1 if slot is free)
+        uint32_t     idx;                                       // Session index (epoll event data)
+        bool         is_epollout;                               // EPOLLOUT is enabled because output is pending
+        bool         is_overflow;                               // Output was lost because out_buf was full
+        size_t       out_len;                                   // Number of characters in out_buf
+        struct term  term;                                      // Line editor state for the session
+        char         out_buf[CCRT_SERVER_OUT_BUF_LEN];          // Output waiting to be sent
+    } session[CCRT_SERVER_MAX_SESSIONS];
+} server;
+
+/*---------------------------------------------------------------------------------------------------------*/
+static int ccrtServerListen(int fd, struct sockaddr *addr, socklen_t addr_len, uint32_t idx)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function binds and listens on a socket and adds it to the epoll set.  It returns the socket, or -1
+  on error.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct epoll_event  event = { .events = EPOLLIN, .data.u32 = idx };
+    int                 one   = 1;
+
+    if(fd < 0)
+    {
+        perror("socket");
+        return(-1);
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if(bind(fd, addr, addr_len) < 0 || listen(fd, LISTEN_BACKLOG) < 0 ||
+       epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        perror("ccrtServerListen");
+        close(fd);
+        return(-1);
+    }
+
+    return(fd);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static ssize_t ccrtServerWrite(void *cookie, const char *buf, size_t size)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is the write function of the session's stdio stream.  It appends the characters to the
+  session's output buffer and never blocks.  If the buffer is full, the session is marked for closing.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccrt_server_session *session = cookie;
+
+    if(size > CCRT_SERVER_OUT_BUF_LEN - session->out_len)
+    {
+        session->is_overflow = true;
+    }
+    else
+    {
+        memcpy(&session->out_buf[session->out_len], buf, size);
+        session->out_len += size;
+    }
+
+    return(size);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccrtServerClose(struct ccrt_server_session *session)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+
+    fclose(session->term.file);
+    close(session->fd);
+
+    session->fd = -1;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccrtServerSend(struct ccrt_server_session *session)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function sends as much of the session's pending output as the socket will accept without blocking.
+  EPOLLOUT is enabled while output remains so that the rest is sent when the client is ready.  The session
+  is closed if the client has gone or has not read its output for too long.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct epoll_event  event = { .data.u32 = session->idx };
+    ssize_t             num_chars;
+
+    fflush(session->term.file);
+
+    if(session->is_overflow)
+    {
+        ccrtServerClose(session);
+        return;
+    }
+
+    if(session->out_len > 0)
+    {
+        num_chars = send(session->fd, session->out_buf, session->out_len, MSG_NOSIGNAL);
+
+        if(num_chars < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            ccrtServerClose(session);
+            return;
+        }
+
+        if(num_chars > 0)
+        {
+            session->out_len -= num_chars;
+            memmove(session->out_buf, &session->out_buf[num_chars], session->out_len);
+        }
+    }
+
+    if(session->is_epollout != (session->out_len > 0))
+    {
+        session->is_epollout = (session->out_len > 0);
+
+        event.events = session->is_epollout ? EPOLLIN | EPOLLOUT : EPOLLIN;
+
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccrtServerAccept(int listen_fd)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function accepts a new session and initialises its terminal.  If all the session slots are in use,
+  the connection is refused with a message.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    static const char           busy[] = "ccrt: too many sessions\r\n";
+    cookie_io_functions_t       io     = { .write = ccrtServerWrite };
+    struct epoll_event          event  = { .events = EPOLLIN };
+    struct ccrt_server_session *session;
+    FILE                       *file;
+    uint32_t                    idx;
+    int                         fd;
+
+    if((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) < 0)
+    {
+        return;
+    }
+
+    for(idx = 0 ; idx < CCRT_SERVER_MAX_SESSIONS && server.session[idx].fd >= 0 ; idx++);
+
+    if(idx == CCRT_SERVER_MAX_SESSIONS || (file = fopencookie(&server.session[idx], "w", io)) == NULL)
+    {
+        if(send(fd, busy, sizeof(busy) - 1, MSG_NOSIGNAL) < 0) {}
+        close(fd);
+        return;
+    }
+
+    session        = &server.session[idx];
+    event.data.u32 = idx;
+
+    if(epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        fclose(file);
+        close(fd);
+        return;
+    }
+
+    session->fd          = fd;
+    session->idx         = idx;
+    session->is_epollout = false;
+    session->is_overflow = false;
+    session->out_len     = 0;
+
+    TermLibInitR(&session->term, file, server.term_line, server.prompt);
+
+    session->term.user = session;
+
+    TermInitR(&session->term, CCRT_SERVER_NUM_COLUMNS);
+
+    fputc(server.prompt, file);
+
+    ccrtServerSend(session);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccrtServerRead(struct ccrt_server_session *session)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function passes the characters received on a session to its terminal and sends the output.  The
+  session is closed if the client disconnects or sends CTRL-C.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char        buf[CCRT_SERVER_BUF_LEN];
+    char       *ctrl_c;
+    ssize_t     num_chars;
+
+    num_chars = read(session->fd, buf, sizeof(buf));
+
+    if(num_chars < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        return;
+    }
+
+    if(num_chars <= 0)
+    {
+        ccrtServerClose(session);
+        return;
+    }
+
+    if((ctrl_c = memchr(buf, CTRL_C, num_chars)) != NULL)
+    {
+        TermCharsR(&session->term, buf, ctrl_c - buf);
+        ccrtServerClose(session);
+        return;
+    }
+
+    TermCharsR(&session->term, buf, num_chars);
+
+    ccrtServerSend(session);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void *ccrtServerThread(void *arg)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is the body of the server thread.  It waits for activity on any socket and serves it.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct epoll_event  events[CCRT_SERVER_MAX_SESSIONS + 2];
+    uint32_t            idx;
+    int                 num_events;
+    int                 i;
+
+    for(;;)
+    {
+        num_events = epoll_wait(server.epoll_fd, events, CCRT_SERVER_MAX_SESSIONS + 2, -1);
+
+        for(i = 0 ; i < num_events ; i++)
+        {
+            idx = events[i].data.u32;
+
+            if(idx >= CCRT_SERVER_MAX_SESSIONS)
+            {
+                ccrtServerAccept(server.listen_fd[idx - LISTEN_UNIX]);
+            }
+            else
+            {
+                // Pending output is sent first, and a session closed while sending is not read
+
+                if(server.session[idx].fd >= 0 && (events[i].events & EPOLLOUT))
+                {
+                    ccrtServerSend(&server.session[idx]);
+                }
+
+                if(server.session[idx].fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                {
+                    ccrtServerRead(&server.session[idx]);
+                }
+            }
+        }
+    }
+
+    return(NULL);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+int32_t ccrtServerStart(const char *unix_path, uint16_t tcp_port, char prompt,
+                        void (*term_line)(struct term *term, char *line, uint16_t line_len))
+/*---------------------------------------------------------------------------------------------------------*\
+  This function starts the console server on the Unix-domain socket unix_path (if not NULL) and on the
+  loopback TCP port tcp_port (if not zero).  Each command line received by a session is passed to
+  term_line() in the server thread, with term->user pointing to the session.  Output from the callback
+  should be written to term->file.  The function returns 0 on success or -1 on error.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct sockaddr_un  addr_un;
+    struct sockaddr_in  addr_in;
+    pthread_t           thread;
+    uint32_t            idx;
+
+    server.prompt       = prompt;
+    server.term_line    = term_line;
+    server.listen_fd[0] = -1;
+    server.listen_fd[1] = -1;
+
+    for(idx = 0 ; idx < CCRT_SERVER_MAX_SESSIONS ; idx++)
+    {
+        server.session[idx].fd = -1;
+    }
+
+    // A session that disconnects while output is pending must not kill the process
+
+    signal(SIGPIPE, SIG_IGN);
+
+    if((server.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        perror("epoll_create1");
+        return(-1);
+    }
+
+    if(unix_path != NULL)
+    {
+        memset(&addr_un, 0, sizeof(addr_un));
+        addr_un.sun_family = AF_UNIX;
+        strncpy(addr_un.sun_path, unix_path, sizeof(addr_un.sun_path) - 1);
+
+        unlink(unix_path);
+
+        if((server.listen_fd[0] = ccrtServerListen(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0),
+                                  (struct sockaddr *)&addr_un, sizeof(addr_un), LISTEN_UNIX)) < 0)
+        {
+            return(-1);
+        }
+    }
+
+    if(tcp_port != 0)
+    {
+        memset(&addr_in, 0, sizeof(addr_in));
+        addr_in.sin_family      = AF_INET;
+        addr_in.sin_port        = htons(tcp_port);
+        addr_in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if((server.listen_fd[1] = ccrtServerListen(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0),
+                                  (struct sockaddr *)&addr_in, sizeof(addr_in), LISTEN_TCP)) < 0)
+        {
+            return(-1);
+        }
+    }
+
+    if(pthread_create(&thread, NULL, ccrtServerThread, NULL) != 0)
+    {
+        perror("pthread_create");
+        return(-1);
+    }
+
+    pthread_detach(thread);
+
+    return(0);
+}
+// EOF
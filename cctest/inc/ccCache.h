@@ -0,0 +1,55 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     cctest/inc/ccCache.h                                                        Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Header file for cctest pre-rendered reference cache functions
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCCACHE_H
+#define CCCACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libfg.h"
+
+// Constants
+
+#define CC_CACHE_MAX_ITERS      10000000            // Max number of iterations rendered for one cycle selector
+#define CC_CACHE_TIME_TOL       1.0E-3              // Max time offset from an iteration (fraction of iter period)
+
+// Pre-rendered reference for one cycle selector
+
+struct cccache
+{
+    bool                        is_valid;               // Cache is valid for the current parameters
+    uint32_t                    function;               // REF FUNCTION that was rendered
+    float                       iter_period;            // Iteration period used for rendering
+    uint32_t                    num_iters;              // Number of iterations rendered
+    uint32_t                    max_iters;              // Number of iterations allocated in the buffers
+    float                      *ref;                    // Reference for each iteration
+    uint8_t                    *status;                 // Function generation status for each iteration
+};
+
+// Function declarations
+
+struct cccache *ccCacheGet       (uint32_t cyc_sel);
+bool            ccCacheRead      (struct cccache *cache, double ref_time, float *ref, enum fg_gen_status *fg_gen_status);
+void            ccCacheInvalidate(uint32_t cyc_sel_from, uint32_t cyc_sel_to);
+
+#endif
+// EOF
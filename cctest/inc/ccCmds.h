@@ -79,8 +79,11 @@ uint32_t ccCmdsCd    (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsPwd   (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsRead  (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsSave  (uint32_t cmd_idx, char **remaining_line);
+uint32_t ccCmdsImport(uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsDebug (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsRun   (uint32_t cmd_idx, char **remaining_line);
+uint32_t ccCmdsSweep (uint32_t cmd_idx, char **remaining_line);
+uint32_t ccCmdsMc    (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsPar   (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsExit  (uint32_t cmd_idx, char **remaining_line);
 uint32_t ccCmdsQuit  (uint32_t cmd_idx, char **remaining_line);
@@ -114,8 +117,11 @@ enum cccmds_enum
     CMD_PWD,
     CMD_READ,
     CMD_SAVE,
+    CMD_IMPORT,
     CMD_DEBUG,
     CMD_RUN,
+    CMD_SWEEP,
+    CMD_MC,
     CMD_EXIT,
     CMD_QUIT,
 
@@ -161,8 +167,11 @@ CCCMDS_EXT struct cccmds cmds[] // The order must match enum cccmds_enum (above)
     { "PWD",     ccCmdsPwd  , NULL        , "           Print current directory"                                },
     { "READ",    ccCmdsRead , NULL        , "[filename] Read parameters from named file or from stdin"          },
     { "SAVE",    ccCmdsSave , NULL        , "filename   Save all parameters in named file"                      },
+    { "IMPORT",  ccCmdsImport, NULL       , "[file fmt] Print, import (CSV|FLOAT|DOUBLE|FGTABLE) or remove (NONE) a TABLE" },
     { "DEBUG",   ccCmdsDebug, NULL        , "           Print all debug variables"                              },
     { "RUN",     ccCmdsRun  , NULL        , "           Run function generation test or converter simulation"   },
+    { "SWEEP",   ccCmdsSweep, NULL        , "[args]     Print, define, RUN or RESET a parameter sweep"          },
+    { "MC",      ccCmdsMc   , NULL        , "[args]     Print, define, RUN, REPLAY or RESET a Monte Carlo analysis" },
     { "EXIT",    ccCmdsExit , NULL        , "           Exit from current file or quit when from stdin"         },
     { "QUIT",    ccCmdsQuit , NULL        , "           Quit program immediately"                               },
     { NULL }
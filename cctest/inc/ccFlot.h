@@ -37,6 +37,35 @@
 // Constants
 
 #define FLOT_PATH               "../.."
+#define FLOT_MIP_MAX_LEVELS     16                  // Max number of levels in the min/max pyramid (level 0 is raw)
+#define FLOT_MIP_FACTOR         4                   // Number of samples per bin between successive levels
+#define FLOT_MIP_PAGE_POINTS    2000                // Max bins per signal embedded in the page or loaded on zoom
+#define FLOT_MIP_NAME_LEN       28                  // Signal name length in the sidecar file signal descriptor
+
+// Min/max pyramid sidecar file header - all fields are little endian and naturally aligned
+// The header is followed by num_sigs signal descriptors and then the levels. Level 0 records contain
+// one float per signal. Level n records contain a min/max pair of floats per signal for a bin of
+// FLOT_MIP_FACTOR^n samples. Records are interleaved by signal so that level 0 can be streamed, and so that
+// the page can fetch a range of records of one level, for all signals, with a single HTTP Range request.
+
+struct flot_mip_header
+{
+    char                        magic[8];                               // "CCMIP1"
+    uint32_t                    header_size;                            // Header + signal descriptors (bytes)
+    uint32_t                    num_sigs;                               // Number of analog signals
+    uint32_t                    num_levels;                             // Number of levels in the pyramid
+    uint32_t                    factor;                                 // FLOT_MIP_FACTOR
+    double                      time0;                                  // Time of the first sample
+    double                      period;                                 // Sample period (negative for reverse time)
+    uint64_t                    num_records[FLOT_MIP_MAX_LEVELS];       // Number of records per level
+    uint64_t                    offset     [FLOT_MIP_MAX_LEVELS];       // File offset of each level (bytes)
+};
+
+struct flot_mip_signal
+{
+    char                        name[FLOT_MIP_NAME_LEN];                // Signal name (null terminated)
+    float                       time_offset;                            // Time offset for trace
+};
 
 // Globals
 
@@ -44,6 +73,9 @@ CCFLOT_EXT uint32_t flot_index;      // Index into flot buffers
 
 // Function declarations
 
+uint32_t ccFlotMipInit       (char *mip_filename);
+void     ccFlotMipStore      (double time);
+void     ccFlotMipFree       (void);
 void     ccFlot              (FILE *f, char *filename);
 
 #endif
@@ -0,0 +1,61 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     cctest/inc/ccFmt.h                                                          Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Header file for cctest fast float formatting and buffered output functions
+
+  Notes:    ccFmtExp() and ccFmtFixed() produce exactly the same text as printf("%.*E") and
+            printf("%.*f") in the C locale. Values that are too close to a rounding boundary to be
+            resolved with double precision arithmetic are passed to snprintf().
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCFMT_H
+#define CCFMT_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Constants
+
+#define CC_FMT_BUF_LEN          (1024*1024)         // Output buffer length
+#define CC_FMT_MAX_FIELD        400                 // Max length of one formatted value (%.15f of DBL_MAX is 326)
+#define CC_FMT_MAX_PRECISION    15                  // Max precision supported by the fast path
+
+// Output buffer structure
+
+struct ccfmt_out
+{
+    FILE                       *f;                      // Output stream
+    char                       *p;                      // Next free character in buf
+    uint64_t                    num_bytes;              // Number of bytes written to f
+    char                        buf[CC_FMT_BUF_LEN];    // Output buffer
+};
+
+// Function declarations
+
+char    *ccFmtExp               (char *p, double value, uint32_t precision);
+char    *ccFmtFixed             (char *p, double value, uint32_t precision);
+void     ccFmtOutInit           (struct ccfmt_out *out, FILE *f);
+void     ccFmtOutFlush          (struct ccfmt_out *out);
+void     ccFmtOutExp            (struct ccfmt_out *out, double value, uint32_t precision);
+void     ccFmtOutFixed          (struct ccfmt_out *out, double value, uint32_t precision);
+void     ccFmtOutChar           (struct ccfmt_out *out, char c);
+void     ccFmtOutString         (struct ccfmt_out *out, const char *s);
+void     ccFmtOutPrintf         (struct ccfmt_out *out, const char *format, ...);
+
+#endif
+// EOF
@@ -0,0 +1,45 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     cctest/inc/ccMonteCarlo.h                                                   Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Header file for cctest Monte Carlo tolerance analysis functions
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCMONTECARLO_H
+#define CCMONTECARLO_H
+
+#include <stdint.h>
+
+#include "ccPars.h"
+
+// Constants
+
+#define CC_MC_MAX_VARIATIONS    16                  // Max number of varied parameters
+#define CC_MC_MAX_RUNS          1000000             // Max number of runs
+#define CC_MC_NUM_WORST         5                   // Number of worst runs reported
+#define CC_MC_NUM_FAILED        10                  // Number of failed run seeds reported
+
+// Function declarations
+
+uint32_t ccMonteCarloAddVariation   (uint32_t cmd_idx, struct ccpars *par, char **remaining_line);
+void     ccMonteCarloReset          (void);
+void     ccMonteCarloPrint          (void);
+uint32_t ccMonteCarloRun            (uint32_t num_runs, uint32_t first_seed);
+uint32_t ccMonteCarloReplay         (uint32_t seed);
+
+#endif
+// EOF
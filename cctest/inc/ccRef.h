@@ -35,6 +35,7 @@
 // Function prototypes
 
 enum fg_gen_status ccRefDirectGen       (struct fg_table *pars, const double *time, float *ref);
+enum fg_gen_status ccRefStreamGen       (struct fg_stream *pars, const double *time, float *ref);
 
 enum fg_error      ccRefInitDIRECT      (struct fg_meta *fg_meta, uint32_t cyc_sel);
 enum fg_error      ccRefInitPLEP        (struct fg_meta *fg_meta, uint32_t cyc_sel);
@@ -48,6 +49,7 @@ enum fg_error      ccRefInitCOSINE      (struct fg_meta *fg_meta, uint32_t cyc_s
 enum fg_error      ccRefInitLTRIM       (struct fg_meta *fg_meta, uint32_t cyc_sel);
 enum fg_error      ccRefInitCTRIM       (struct fg_meta *fg_meta, uint32_t cyc_sel);
 enum fg_error      ccRefInitPULSE       (struct fg_meta *fg_meta, uint32_t cyc_sel);
+enum fg_error      ccRefInitSTREAM      (struct fg_meta *fg_meta, uint32_t cyc_sel);
 
 // Reference functions structure
 
@@ -58,24 +60,26 @@ struct fgfunc
     size_t                   size_of_pars;
     enum fg_error           (*init_func)(struct fg_meta *fg_meta, uint32_t cyc_sel);
     enum fg_gen_status      (*fgen_func)();
+    enum fg_gen_status      (*feval_func)();        // Stateless libfg Eval function (NULL if none)
 };
 
 CCREF_EXT struct fgfunc funcs[]  // Must be in enum fg_types order (in ref.h)
 #ifdef GLOBALS
 = {
-    {   0,          NULL,             0,                       NULL,            NULL           },
-    {   CMD_TABLE, (char *)&fg_table, sizeof(struct fg_table), ccRefInitTABLE,  ccRefDirectGen },
-    {   CMD_PLEP,  (char *)&fg_plep,  sizeof(struct fg_plep),  ccRefInitPLEP,   fgPlepGen      },
-    {   CMD_RAMP,  (char *)&fg_ramp,  sizeof(struct fg_ramp),  ccRefInitRAMP,   fgRampGen      },
-    {   CMD_PPPL,  (char *)&fg_pppl,  sizeof(struct fg_pppl),  ccRefInitPPPL,   fgPpplGen      },
-    {   CMD_TABLE, (char *)&fg_table, sizeof(struct fg_table), ccRefInitTABLE,  fgTableGen     },
-    {   CMD_TEST,  (char *)&fg_test,  sizeof(struct fg_test),  ccRefInitSTEPS,  fgTestGen      },
-    {   CMD_TEST,  (char *)&fg_test,  sizeof(struct fg_test),  ccRefInitSQUARE, fgTestGen      },
-    {   CMD_TEST,  (char *)&fg_test,  sizeof(struct fg_test),  ccRefInitSINE,   fgTestGen      },
-    {   CMD_TEST,  (char *)&fg_test,  sizeof(struct fg_test),  ccRefInitCOSINE, fgTestGen      },
-    {   CMD_TRIM,  (char *)&fg_trim,  sizeof(struct fg_trim),  ccRefInitLTRIM,  fgTrimGen      },
-    {   CMD_TRIM,  (char *)&fg_trim,  sizeof(struct fg_trim),  ccRefInitCTRIM,  fgTrimGen      },
-    {   CMD_TRIM,  (char *)&fg_pulse, sizeof(struct fg_trim),  ccRefInitPULSE,  fgTrimGen      },
+    {   0,          NULL,              0,                        NULL,            NULL,           NULL        },
+    {   CMD_TABLE, (char *)&fg_table,  sizeof(struct fg_table),  ccRefInitTABLE,  ccRefDirectGen, NULL        },
+    {   CMD_PLEP,  (char *)&fg_plep,   sizeof(struct fg_plep),   ccRefInitPLEP,   fgPlepGen,      fgPlepEval  },
+    {   CMD_RAMP,  (char *)&fg_ramp,   sizeof(struct fg_ramp),   ccRefInitRAMP,   fgRampGen,      fgRampEval  },
+    {   CMD_PPPL,  (char *)&fg_pppl,   sizeof(struct fg_pppl),   ccRefInitPPPL,   fgPpplGen,      fgPpplEval  },
+    {   CMD_TABLE, (char *)&fg_table,  sizeof(struct fg_table),  ccRefInitTABLE,  fgTableGen,     fgTableEval },
+    {   CMD_TEST,  (char *)&fg_test,   sizeof(struct fg_test),   ccRefInitSTEPS,  fgTestGen,      fgTestEval  },
+    {   CMD_TEST,  (char *)&fg_test,   sizeof(struct fg_test),   ccRefInitSQUARE, fgTestGen,      fgTestEval  },
+    {   CMD_TEST,  (char *)&fg_test,   sizeof(struct fg_test),   ccRefInitSINE,   fgTestGen,      fgTestEval  },
+    {   CMD_TEST,  (char *)&fg_test,   sizeof(struct fg_test),   ccRefInitCOSINE, fgTestGen,      fgTestEval  },
+    {   CMD_TRIM,  (char *)&fg_trim,   sizeof(struct fg_trim),   ccRefInitLTRIM,  fgTrimGen,      fgTrimEval  },
+    {   CMD_TRIM,  (char *)&fg_trim,   sizeof(struct fg_trim),   ccRefInitCTRIM,  fgTrimGen,      fgTrimEval  },
+    {   CMD_TRIM,  (char *)&fg_pulse,  sizeof(struct fg_trim),   ccRefInitPULSE,  fgTrimGen,      fgTrimEval  },
+    {   CMD_TABLE, (char *)&fg_stream, sizeof(struct fg_stream), ccRefInitSTREAM, ccRefStreamGen, NULL        },
 }
 #endif
 ;
@@ -58,8 +58,8 @@ struct ccrun_vars
     double                          cycle_duration;                     // Cycle duration including run delay
     enum fg_gen_status            (*fgen_func)();                       // Function to generate the active reference
     void                           *fgen_pars;                          // Parameter structure for active reference
-    struct fg_limits               *fg_limits;                          // Pointer to NULL or ccrun.fgen_limits
-    struct fg_limits                fgen_limits;                        // Pointer to fg_limits (b/i/v)
+    struct fg_limits               *fg_limits[CC_NUM_CYC_SELS];         // Pointers to NULL or ccrun.fgen_limits[cyc_sel]
+    struct fg_limits                fgen_limits[CC_NUM_CYC_SELS];       // Function generation limits (b/i/v) for each cycle selector
     struct reg_lim_ref              fg_lim_v_ref;                       // Libreg voltage measurement limits structure for fg converter limits
 
     struct ccrun_cycle
@@ -85,6 +85,31 @@ struct ccrun_vars
         struct fg_ramp              pars;                               // Libfg parameters for pre-function ramps
     } prefunc;
 
+    struct ccrun_stats
+    {
+        uint32_t                    num_err_samples;                    // Number of regulation error samples during functions
+        double                      sum_err2;                           // Sum of the squares of the regulation error samples
+        float                       max_abs_err;                        // Max absolute regulation error for all functions
+        uint32_t                    num_ref_clip;                       // Number of iterations with field/current reference clipped
+        uint32_t                    num_ref_rate_clip;                  // Number of iterations with field/current reference rate clipped
+        uint32_t                    num_v_ref_clip;                     // Number of iterations with voltage reference clipped
+        uint32_t                    num_v_ref_rate_clip;                // Number of iterations with voltage reference rate clipped
+        uint32_t                    num_err_warning;                    // Number of iterations with a regulation error warning
+        uint32_t                    num_err_fault;                      // Number of iterations with a regulation error fault
+    } stats;
+
+    struct ccrun_eval_check
+    {
+        uint32_t                    num_checks;                         // Number of iterations where the Eval function was checked
+        uint32_t                    num_errors;                         // Number of iterations where Eval differed from Gen
+        uint32_t                    cyc_sel;                            // Cycle selector of the first difference
+        double                      ref_time;                           // Reference time of the first difference
+        float                       gen_ref;                            // Gen reference at the first difference
+        float                       eval_ref;                           // Eval reference at the first difference
+        enum fg_gen_status          gen_status;                         // Gen status at the first difference
+        enum fg_gen_status          eval_status;                        // Eval status at the first difference
+    } eval_check;
+
     struct ccrun_dyn_eco
     {
         struct fg_plep              pars;                               // Dynamic economy plep parameters
@@ -107,6 +132,7 @@ CCRUN_EXT struct ccrun_vars ccrun;
 void    ccRunSimulation         (void);
 void    ccRunFuncGen            (void);
 void    ccRunFuncGenReverseTime (void);
+uint32_t ccRunEvalCheckReport   (void);
 
 #endif
 
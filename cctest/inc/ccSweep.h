@@ -0,0 +1,59 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     cctest/inc/ccSweep.h                                                        Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Header file for cctest parallel parameter sweep functions
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCSWEEP_H
+#define CCSWEEP_H
+
+#include <stdint.h>
+
+#include "ccPars.h"
+#include "ccRun.h"
+
+// Constants
+
+#define CC_SWEEP_MAX_AXES       8                   // Max number of swept parameters
+#define CC_SWEEP_MAX_POINTS     1000000             // Max number of points in the sweep grid
+#define CC_SWEEP_MAX_WORKERS    64                  // Max number of parallel worker processes
+#define CC_SWEEP_MAX_VALUE_LEN  32                  // Max length of a swept parameter value
+
+// Result of one run, returned by the worker process through a pipe
+
+struct ccsweep_result
+{
+    uint32_t                    point_idx;              // Index of the point in the sweep
+    uint32_t                    exit_status;            // EXIT_SUCCESS or EXIT_FAILURE
+    uint32_t                    is_pc_tripped;          // Voltage source tripped during the run
+    float                       modulus_margin;         // Modulus margin of the operational RST regulator
+    struct ccrun_stats          stats;                  // Run statistics
+};
+
+// Function declarations
+
+uint32_t ccSweepAddAxis         (uint32_t cmd_idx, struct ccpars *par, char **remaining_line);
+void     ccSweepReset           (void);
+void     ccSweepPrint           (void);
+uint32_t ccSweepRun             (void);
+uint32_t ccSweepRunParallel     (uint32_t num_points,
+                                 uint32_t (*init_point)(uint32_t point_idx),
+                                 void (*store_result)(struct ccsweep_result *result));
+
+#endif
+// EOF
@@ -0,0 +1,53 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     cctest/inc/ccTable.h                                                        Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Header file for cctest TABLE import functions
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef CCTABLE_H
+#define CCTABLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Constants
+
+#define CC_TABLE_MAX_THREADS        16              // Max number of threads used to parse a CSV file
+#define CC_TABLE_MIN_CHUNK          (1 << 20)       // Min number of bytes of CSV per thread
+#define CC_TABLE_BLOCK_SIZE         (1 << 24)       // Bytes read from a file at a time (MAX_THREADS * MIN_CHUNK)
+#define CC_TABLE_MAX_POINTS         0x40000000      // Max number of points in an imported table
+
+// Imported table file formats
+
+enum cctable_format
+{
+    CC_TABLE_CSV,                                   // Text lines: time,ref (comma, semicolon or white space)
+    CC_TABLE_FLOAT,                                 // Binary time,ref pairs of native 32-bit floats
+    CC_TABLE_DOUBLE,                                // Binary time,ref pairs of native 64-bit doubles
+    CC_TABLE_FGTABLE,                               // libfg table file, memory-mapped (see libfg/table_file.h)
+};
+
+// Function declarations
+
+uint32_t ccTableImport          (uint32_t cyc_sel, char *filename, enum cctable_format format);
+void     ccTableRemove          (uint32_t cyc_sel);
+void     ccTablePrint           (FILE *f);
+void     ccTableGet             (uint32_t cyc_sel, float **ref, uint32_t *ref_num_els, float **time, uint32_t *time_num_els);
+
+#endif
+// EOF
@@ -27,6 +27,7 @@
 #include "ccTest.h"
 #include "ccPars.h"
 #include "libfg/table.h"
+#include "libfg/stream.h"
 
 // GLOBALS is defined in source file where global variables should be defined
 
@@ -40,6 +41,10 @@
 
 CCPARS_TABLE_EXT struct fg_table fg_table[CC_NUM_CYC_SELS];
 
+// Libfg STREAM parameter structures - STREAM functions are fed with the TABLE points
+
+CCPARS_TABLE_EXT struct fg_stream fg_stream[CC_NUM_CYC_SELS];
+
 // Table data structure
 
 #define TABLE_LEN       10000
@@ -89,10 +89,16 @@ struct ccpars_global
     enum reg_err_rate           reg_err_rate;               // Regulation error rate control
     enum reg_enabled_disabled   fg_limits;                  // Enable limits for function generator initialisation
     enum reg_enabled_disabled   sim_load;                   // Enable load simulation
+    enum reg_enabled_disabled   ref_cache;                  // Enable pre-rendered reference cache when SIM_LOAD is DISABLED
+    enum reg_enabled_disabled   eval_check;                 // Compare the libfg Eval function with the Gen function
+    uint32_t                    arm_threads;                // Number of threads used to arm the reference functions
     enum reg_enabled_disabled   stop_on_error;              // Enable stop on error - this will stop reading the file
     enum cc_csv_format          csv_format;                 // CSV output data format
     enum reg_enabled_disabled   flot_output;                // FLOT webplot output control (ENABLED or DISABLED)
+    enum reg_enabled_disabled   flot_mipmap;                // FLOT min/max pyramid sidecar file control (ENABLED or DISABLED)
     enum reg_enabled_disabled   debug_output;               // Debug output control (ENABLED or DISABLED)
+    uint32_t                    num_workers;                // Number of parallel worker processes for SWEEP and MC (0: one per CPU)
+    enum reg_enabled_disabled   worker_output;              // CSV, FLOT and debug output control for SWEEP and MC runs
     char *                      group;                      // Test group name (e.g. sandbox or tests)
     char *                      project;                    // Project name (e.g. SPS_MPS)
     char *                      file;                       // Results filename root (exclude .csv or .html)
@@ -114,10 +120,16 @@ CCPARS_GLOBAL_EXT struct ccpars_global ccpars_global
        REG_ERR_RATE_REGULATION,   // GLOBAL REG_ERR_RATE
        REG_DISABLED           ,   // GLOBAL FG_LIMITS
        REG_DISABLED           ,   // GLOBAL SIM_LOAD
+       REG_DISABLED           ,   // GLOBAL REF_CACHE
+       REG_DISABLED           ,   // GLOBAL EVAL_CHECK
+       1                      ,   // GLOBAL ARM_THREADS
        REG_ENABLED            ,   // GLOBAL STOP_ON_ERROR
        CC_NONE                ,   // GLOBAL CSV_FORMAT
        REG_ENABLED            ,   // GLOBAL FLOT_OUTPUT
+       REG_DISABLED           ,   // GLOBAL FLOT_MIPMAP
        REG_ENABLED            ,   // GLOBAL DEBUG_OUTPUT
+       0                      ,   // GLOBAL NUM_WORKERS
+       REG_DISABLED           ,   // GLOBAL WORKER_OUTPUT
 }
 #endif
 ;
@@ -139,10 +151,16 @@ enum global_pars_index_enum
     GLOBAL_REG_ERR_RATE      ,
     GLOBAL_FG_LIMITS         ,
     GLOBAL_SIM_LOAD          ,
+    GLOBAL_REF_CACHE         ,
+    GLOBAL_EVAL_CHECK        ,
+    GLOBAL_ARM_THREADS       ,
     GLOBAL_STOP_ON_ERROR     ,
     GLOBAL_CSV_FORMAT        ,
     GLOBAL_FLOT_OUTPUT       ,
+    GLOBAL_FLOT_MIPMAP       ,
     GLOBAL_DEBUG_OUTPUT      ,
+    GLOBAL_NUM_WORKERS       ,
+    GLOBAL_WORKER_OUTPUT     ,
     GLOBAL_GROUP             ,
     GLOBAL_PROJECT           ,
     GLOBAL_FILE
@@ -164,10 +182,16 @@ CCPARS_GLOBAL_EXT struct ccpars global_pars[]
     { "REG_ERR_RATE",    PAR_ENUM,     1,          enum_reg_err_rate,     { .u = &ccpars_global.reg_err_rate     }, 1, 0, 0                 },
     { "FG_LIMITS",       PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.fg_limits        }, 1, 0, 0                 },
     { "SIM_LOAD",        PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.sim_load         }, 1, 0, 0                 },
+    { "REF_CACHE",       PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.ref_cache        }, 1, 0, 0                 },
+    { "EVAL_CHECK",      PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.eval_check       }, 1, 0, 0                 },
+    { "ARM_THREADS",     PAR_UNSIGNED, 1,          NULL,                  { .u = &ccpars_global.arm_threads      }, 1, 0, 0                 },
     { "STOP_ON_ERROR",   PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.stop_on_error    }, 1, 0, 0                 },
     { "CSV_FORMAT",      PAR_ENUM,     1,          enum_csv_format,       { .u = &ccpars_global.csv_format       }, 1, 0, 0                 },
     { "FLOT_OUTPUT",     PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.flot_output      }, 1, 0, 0                 },
+    { "FLOT_MIPMAP",     PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.flot_mipmap      }, 1, 0, 0                 },
     { "DEBUG_OUTPUT",    PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.debug_output     }, 1, 0, 0                 },
+    { "NUM_WORKERS",     PAR_UNSIGNED, 1,          NULL,                  { .u = &ccpars_global.num_workers      }, 1, 0, 0                 },
+    { "WORKER_OUTPUT",   PAR_ENUM,     1,          enum_enabled_disabled, { .u = &ccpars_global.worker_output    }, 1, 0, 0                 },
     { "GROUP",           PAR_STRING,   1,          NULL,                  { .s = &ccpars_global.group            }, 1, 0, 0                 },
     { "PROJECT",         PAR_STRING,   1,          NULL,                  { .s = &ccpars_global.project          }, 1, 0, 0                 },
     { "FILE",            PAR_STRING,   1,          NULL,                  { .s = &ccpars_global.file             }, 1, 0, 0                 },
@@ -86,6 +86,7 @@ enum fg_types
     FG_LTRIM,
     FG_CTRIM,
     FG_PULSE,
+    FG_STREAM,
 };
 
 CCPARS_GLOBAL_EXT struct ccpars_enum enum_function_type[]
@@ -104,6 +105,7 @@ CCPARS_GLOBAL_EXT struct ccpars_enum enum_function_type[]
     { FG_LTRIM,       "LTRIM"  },
     { FG_CTRIM,       "CTRIM"  },
     { FG_PULSE,       "PULSE"  },
+    { FG_STREAM,      "STREAM" },
     { 0,               NULL    },
 }
 #endif
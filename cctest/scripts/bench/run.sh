@@ -0,0 +1,39 @@
+#!/bin/bash
+#
+# Output benchmark: measures the rate at which cctest writes CSV and FLOT output for a long run
+#
+# Usage: run.sh [path to cctest]
+#
+# The rate is the output file size divided by the elapsed time for the whole run, so it includes the
+# simulation. Run once without output to measure the simulation time alone.
+
+cd `dirname $0`
+
+cctest=${1:-../../`uname -s`/`uname -m`/cctest}
+
+results=../../results
+
+bench()
+{
+    local label=$1
+    local file=$2
+    shift 2
+
+    local start=`date +%s.%N`
+    "$cctest" "$@" "read bench.cct" "global file $label" "run" > /dev/null
+    local end=`date +%s.%N`
+
+    local bytes=0
+
+    if [ -n "$file" ]; then
+        bytes=`stat -c %s "$file"`
+    fi
+
+    echo "$label $start $end $bytes" | awk '{ t = $3 - $2; printf("%-10s %8.3f s %9.1f MB %8.1f MB/s\n", $1, t, $4/1E6, t > 0 ? $4/1E6/t : 0) }'
+}
+
+bench none ""                                      "global csv_format none"     "global flot_output disabled"
+bench csv  $results/csv/bench/output/csv.csv       "global csv_format standard" "global flot_output disabled"
+bench flot $results/webplots/bench/output/flot.html "global csv_format none"     "global flot_output enabled" "global flot_points_max 1100000"
+
+# EOF
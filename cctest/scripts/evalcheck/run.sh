@@ -0,0 +1,40 @@
+#!/bin/bash
+#
+# Eval check: replays the .cct files of the tests and sandbox scripts with GLOBAL EVAL_CHECK ENABLED, so that
+# the stateless libfg Eval functions are compared with the Gen functions on every iteration of every function
+#
+# Usage: run.sh [path to cctest]
+#
+# CSV, FLOT and debug output are disabled. The script returns 1 if Eval differed from Gen in any run.
+
+cd `dirname $0`
+
+cctest=${1:-`pwd`/../../`uname -s`/`uname -m`/cctest}
+
+num_runs=0
+num_failed=0
+
+for script in ../tests/*/run.sh ../sandbox/*/run.sh
+do
+    dir=`dirname $script`
+
+    for cct in `grep -o 'read [^"]*' $script | cut -d' ' -f2`
+    do
+        result=`cd $dir && "$cctest" "global eval_check enabled" "global flot_output disabled" \
+                                     "global debug_output disabled" "read $cct" 2>&1 | grep "Eval"`
+
+        num_runs=$((num_runs + `echo "$result" | grep -c "Eval check"`))
+
+        if echo "$result" | grep -q "Eval differs"; then
+            echo "$dir/$cct:"
+            echo "$result" | grep "Eval differs"
+            num_failed=$((num_failed + 1))
+        fi
+    done
+done
+
+echo "$num_runs runs checked : $num_failed files with differences"
+
+[ $num_failed -eq 0 ]
+
+# EOF
@@ -0,0 +1,13 @@
+#!/bin/bash
+#
+cd `dirname $0`
+
+source ../../run_header.sh
+
+# STREAM tests
+
+$cctest "global csv_format $csv_format" "read stream.cct"
+
+>&2 echo $0 complete
+
+# EOF
@@ -0,0 +1,13 @@
+#!/bin/bash
+#
+cd `dirname $0`
+
+source ../../run_header.sh
+
+# Parameter sweep example
+
+$cctest "global csv_format $csv_format" "read sweep.cct"
+
+>&2 echo $0 complete
+
+# EOF
@@ -0,0 +1,231 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccCache.c                                                                   Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  cctest pre-rendered reference cache functions
+
+  Notes:    When GLOBAL REF_CACHE is ENABLED, ccRunFuncGen() plays each armed function from a buffer
+            rendered once per cycle selector at the iteration period, instead of calling the libfg
+            generator on every iteration of every cycle. The function is rendered on a copy of its libfg
+            parameters so the armed function is not disturbed. The cache is invalidated by ccParsGet()
+            and by IMPORT when parameters that could change the function are set. If a reference time
+            does not fall on an iteration of the cached function, the function is generated live.
+            The first cycle is identical to live generation. Later cycles are read at the nearest
+            iteration, so they are free of the rounding of the single precision iteration time that
+            affects live generation. DIRECT, RAMP and STREAM are always generated live: a DIRECT reference
+            can change during the cycle, a RAMP continues from the state left by its previous cycle and a
+            STREAM consumes its points as they are generated.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ccCmds.h"
+#include "ccTest.h"
+#include "ccRef.h"
+#include "ccRun.h"
+#include "ccCache.h"
+
+static struct cccache cccache[CC_NUM_CYC_SELS];
+
+
+
+static uint32_t ccCacheResize(struct cccache *cache, uint32_t min_iters)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will enlarge the cache buffers to at least min_iters iterations, doubling their size so that
+  a function that is longer than expected does not cause a realloc on every iteration. The old buffers are
+  kept if realloc fails, so they are neither leaked nor lost.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    max_iters = cache->max_iters < CC_CACHE_MAX_ITERS / 2 ? 2 * cache->max_iters : CC_CACHE_MAX_ITERS;
+    float      *ref;
+    uint8_t    *status;
+
+    if(max_iters < min_iters)
+    {
+        max_iters = min_iters;
+    }
+
+    if((ref = realloc(cache->ref, max_iters * sizeof(float))) != NULL)
+    {
+        cache->ref = ref;
+    }
+
+    if((status = realloc(cache->status, max_iters * sizeof(uint8_t))) != NULL)
+    {
+        cache->status = status;
+    }
+
+    if(ref == NULL || status == NULL)
+    {
+        return(EXIT_FAILURE);
+    }
+
+    cache->max_iters = max_iters;
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static uint32_t ccCacheRender(struct cccache *cache, uint32_t cyc_sel)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will render the armed function of the cycle selector at every iteration until the end of
+  the function, as seen by ccRunFuncGen(), followed by the stop delay in case it is the last cycle. The
+  meta duration is only used to size the buffers because the end of a RAMP depends on its rate limit.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct fgfunc  *func      = &funcs[cache->function];
+    double          end_time  = ccpars_global.run_delay + ccrun.fg_meta[cyc_sel].duration;
+    uint32_t        num_iters = CC_CACHE_MAX_ITERS;
+    bool            is_ended  = false;
+    uint32_t        iter_idx;
+    double          ref_time;
+    float           ref;
+    char           *pars;
+
+    pars = malloc(func->size_of_pars);
+
+    if(pars == NULL || ccCacheResize(cache, 2 + (uint32_t)fmin(end_time / cache->iter_period, CC_CACHE_MAX_ITERS)) == EXIT_FAILURE)
+    {
+        free(pars);
+        return(EXIT_FAILURE);
+    }
+
+    // Generate the function on a copy of its parameters because generation can change them (e.g. TABLE seg_idx)
+
+    memcpy(pars, func->fg_pars + func->size_of_pars * cyc_sel, func->size_of_pars);
+
+    // Times are calculated in the same way as iter_time in ccRunFuncGen(). The reference from the previous
+    // iteration is passed to the generator, as it is live, because RAMP uses it to follow a changed reference.
+
+    ref = ccrun.fg_meta[cyc_sel].range.start;
+
+    for(iter_idx = 0 ; iter_idx < num_iters ; iter_idx++)
+    {
+        if(iter_idx >= cache->max_iters && ccCacheResize(cache, iter_idx + 1) == EXIT_FAILURE)
+        {
+            free(pars);
+            return(EXIT_FAILURE);
+        }
+
+        ref_time = cache->iter_period * iter_idx;
+
+        cache->status[iter_idx] = func->fgen_func(pars, &ref_time, &ref);
+        cache->ref   [iter_idx] = ref;
+
+        if(is_ended == false && ref_time > end_time && cache->status[iter_idx] == FG_GEN_AFTER_FUNC)
+        {
+            is_ended  = true;
+            num_iters = (uint32_t)fmin(iter_idx + 2.0 + floor(ccpars_global.stop_delay / cache->iter_period), CC_CACHE_MAX_ITERS);
+        }
+    }
+
+    free(pars);
+
+    // A function that has not ended within CC_CACHE_MAX_ITERS iterations is generated live
+
+    if(is_ended == false)
+    {
+        return(EXIT_FAILURE);
+    }
+
+    cache->num_iters = num_iters;
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+struct cccache *ccCacheGet(uint32_t cyc_sel)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will return the pre-rendered reference for the armed function of the cycle selector,
+  rendering it if the cache is not valid. It returns NULL if the cache is disabled or cannot be used.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cccache *cache    = &cccache[cyc_sel];
+    uint32_t        function = ccpars_ref[cyc_sel].function;
+
+    // DIRECT references can change during the cycle, a RAMP depends on the state left by its previous
+    // cycle and a STREAM consumes its points, so they are always generated live
+
+    if(ccpars_global.ref_cache != REG_ENABLED || funcs[function].fgen_func == ccRefDirectGen ||
+       funcs[function].fgen_func == fgRampGen || funcs[function].fgen_func == ccRefStreamGen)
+    {
+        return(NULL);
+    }
+
+    if(cache->is_valid && cache->function == function && cache->iter_period == conv.iter_period)
+    {
+        return(cache);
+    }
+
+    cache->is_valid    = false;
+    cache->function    = function;
+    cache->iter_period = conv.iter_period;
+
+    if(ccCacheRender(cache, cyc_sel) == EXIT_FAILURE)
+    {
+        return(NULL);
+    }
+
+    cache->is_valid = true;
+
+    return(cache);
+}
+
+
+
+bool ccCacheRead(struct cccache *cache, double ref_time, float *ref, enum fg_gen_status *fg_gen_status)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will read the reference from the cache if ref_time falls on a cached iteration. It returns
+  false if the reference must be generated live.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    double      iter_idx = nearbyint(ref_time / cache->iter_period);
+
+    if(iter_idx < 0.0 || iter_idx >= cache->num_iters ||
+       fabs(ref_time - iter_idx * cache->iter_period) > CC_CACHE_TIME_TOL * cache->iter_period)
+    {
+        return(false);
+    }
+
+    *ref           = cache->ref[(uint32_t)iter_idx];
+    *fg_gen_status = cache->status[(uint32_t)iter_idx];
+
+    return(true);
+}
+
+
+
+void ccCacheInvalidate(uint32_t cyc_sel_from, uint32_t cyc_sel_to)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will invalidate the cached references for a range of cycle selectors. The buffers are kept
+  so that they can be reused when the function is rendered again.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    cyc_sel;
+
+    for(cyc_sel = cyc_sel_from ; cyc_sel <= cyc_sel_to && cyc_sel < CC_NUM_CYC_SELS ; cyc_sel++)
+    {
+        cccache[cyc_sel].is_valid = false;
+    }
+}
+
+// EOF
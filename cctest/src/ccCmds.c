@@ -38,6 +38,9 @@
 #include "ccInit.h"
 #include "ccRun.h"
 #include "ccDebug.h"
+#include "ccSweep.h"
+#include "ccMonteCarlo.h"
+#include "ccTable.h"
 
 /*---------------------------------------------------------------------------------------------------------*/
 uint32_t ccCmdsHelp(uint32_t cmd_idx, char **remaining_line)
@@ -359,12 +362,101 @@ uint32_t ccCmdsSave(uint32_t cmd_idx, char **remaining_line)
         }
     }
 
+    // Imported tables replace TABLE REF and TIME so they must follow the TABLE parameters
+
+    fputs("\n# Imported Tables\n\n", f);
+
+    ccTablePrint(f);
+
     fputs("\n# EOF\n",f);
     fclose(f);
     puts("done.");
     return(EXIT_SUCCESS);
 }
 /*---------------------------------------------------------------------------------------------------------*/
+uint32_t ccCmdsImport(uint32_t cmd_idx, char **remaining_line)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will import a table from a file for the TABLE function of the command cycle selector
+  (0 by default). The imported table is used instead of the TABLE REF and TIME parameters, e.g.:
+
+  IMPORT                        Print the imported tables
+  IMPORT(2) waveform.csv        Import TABLE(2) from a CSV file of time,ref lines
+  IMPORT waveform.bin FLOAT     Import TABLE(0) from a binary file of time,ref pairs of floats
+  IMPORT waveform.fgt FGTABLE   Map TABLE(0) from a libfg table file without copying it
+  IMPORT(2) NONE                Remove the imported table so that TABLE(2) REF and TIME are used again
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char                   *filename;
+    char                   *arg;
+    uint32_t                cyc_sel = cctest.cyc_sel == CC_NO_INDEX ? 0 : cctest.cyc_sel;
+    enum cctable_format     format  = CC_TABLE_CSV;
+
+    if(cctest.array_idx != CC_NO_INDEX)
+    {
+        ccTestPrintError("unexpected command array index");
+        return(EXIT_FAILURE);
+    }
+
+    if(cyc_sel > CC_MAX_CYC_SEL)
+    {
+        ccTestPrintError("IMPORT requires a single cycle selector");
+        return(EXIT_FAILURE);
+    }
+
+    // If no arguments then print the imported tables
+
+    filename = ccTestGetArgument(remaining_line);
+
+    if(filename == NULL)
+    {
+        ccTablePrint(stdout);
+        return(EXIT_SUCCESS);
+    }
+
+    if(strcasecmp(filename, "NONE") == 0)
+    {
+        if(ccTestNoMoreArgs(remaining_line) == EXIT_FAILURE)
+        {
+            return(EXIT_FAILURE);
+        }
+
+        ccTableRemove(cyc_sel);
+        return(EXIT_SUCCESS);
+    }
+
+    // Get the optional file format
+
+    arg = ccTestGetArgument(remaining_line);
+
+    if(arg != NULL)
+    {
+        if(strcasecmp(arg, "FLOAT") == 0)
+        {
+            format = CC_TABLE_FLOAT;
+        }
+        else if(strcasecmp(arg, "DOUBLE") == 0)
+        {
+            format = CC_TABLE_DOUBLE;
+        }
+        else if(strcasecmp(arg, "FGTABLE") == 0)
+        {
+            format = CC_TABLE_FGTABLE;
+        }
+        else if(strcasecmp(arg, "CSV") != 0)
+        {
+            ccTestPrintError("invalid IMPORT format '%s' (CSV, FLOAT, DOUBLE or FGTABLE expected)", ccTestAbbreviatedArg(arg));
+            return(EXIT_FAILURE);
+        }
+
+        if(ccTestNoMoreArgs(remaining_line) == EXIT_FAILURE)
+        {
+            return(EXIT_FAILURE);
+        }
+    }
+
+    return(ccTableImport(cyc_sel, filename, format));
+}
+/*---------------------------------------------------------------------------------------------------------*/
 uint32_t ccCmdsDebug(uint32_t cmd_idx, char **remaining_line)
 /*---------------------------------------------------------------------------------------------------------*\
   This function will display the debug information for all the active parameters from the previous run.
@@ -390,7 +482,8 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
   and load.
 \*---------------------------------------------------------------------------------------------------------*/
 {
-    char *filename;
+    char     *filename;
+    uint32_t  exit_status;
 
     // No arguments expected
 
@@ -448,6 +541,45 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
 
     ccSigsInit();
 
+    // Open FLOT min/max pyramid sidecar file if required
+
+    if(ccpars_global.flot_output == REG_ENABLED && ccpars_global.flot_mipmap == REG_ENABLED)
+    {
+        char     mip_path[CC_PATH_LEN];
+        char     mip_filename[CC_PATH_LEN];
+        uint32_t mip_status;
+
+        if(snprintf(mip_path, CC_PATH_LEN, "%s/results/webplots/%s/%s",
+                    cctest.base_path,
+                    ccpars_global.group,
+                    ccpars_global.project) >= CC_PATH_LEN ||
+           snprintf(mip_filename, CC_PATH_LEN, "%s/%s.mip", mip_path, filename) >= CC_PATH_LEN)
+        {
+            ccTestPrintError("mipmap file path too long for '%s'", filename);
+            mip_status = EXIT_FAILURE;
+        }
+        else if(ccTestMakePath(mip_path) == EXIT_FAILURE)
+        {
+            mip_status = EXIT_FAILURE;
+        }
+        else
+        {
+            mip_status = ccFlotMipInit(mip_filename);
+        }
+
+        // The CSV file is already open, so close it if the sidecar file cannot be opened
+
+        if(mip_status == EXIT_FAILURE)
+        {
+            if(ccpars_global.csv_format != CC_NONE)
+            {
+                ccSigsFlush();
+                fclose(cctest.csv_file);
+            }
+            return(EXIT_FAILURE);
+        }
+    }
+
     // Run the test
 
     if(ccpars_global.sim_load == REG_ENABLED)
@@ -482,6 +614,7 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
 
     if(ccpars_global.csv_format != CC_NONE)
     {
+        ccSigsFlush();
         fclose(cctest.csv_file);
     }
 
@@ -500,6 +633,7 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
 
         if(ccTestMakePath(flot_path) == EXIT_FAILURE)
         {
+            ccFlotMipFree();
             return(EXIT_FAILURE);
         }
 
@@ -510,6 +644,7 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
         if(flot_file == NULL)
         {
              ccTestPrintError("opening file '%s' : %s (%d)", flot_filename, strerror(errno), errno);
+             ccFlotMipFree();
              return(EXIT_FAILURE);
         }
 
@@ -566,9 +701,207 @@ uint32_t ccCmdsRun(uint32_t cmd_idx, char **remaining_line)
         fclose(debug_file);
     }
 
-    // Report bad values that were sent to ccSigsStore()
+    // Report bad values that were sent to ccSigsStore() and differences between the Eval and Gen functions
+
+    exit_status = ccSigsReportBadValues();
+
+    if(ccRunEvalCheckReport() == EXIT_FAILURE)
+    {
+        exit_status = EXIT_FAILURE;
+    }
+
+    return(exit_status);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static uint32_t ccCmdsGetParameter(char *cmd_name, char *arg, char **remaining_line, uint32_t *par_cmd_idx, struct ccpars **par_matched)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will identify the parameter named by arg (the parameter command, which can be abbreviated)
+  and by the parameter name at the start of the remaining line. It is used by commands that act on other
+  commands' parameters, such as SWEEP and MC.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    size_t          arg_len = strlen(arg);
+    struct cccmds  *cmd;
+    int32_t         cmd_idx;
+    int32_t         idx;
+
+    for(cmd = cmds, cmd_idx = -1, idx = 0 ; cmd->name != NULL ; cmd++, idx++)
+    {
+        if(cmd->pars != NULL && strncasecmp(cmd->name, arg, arg_len) == 0)
+        {
+            if(cmd_idx != -1)
+            {
+                ccTestPrintError("ambiguous command '%s'", arg);
+                return(EXIT_FAILURE);
+            }
+
+            cmd_idx = idx;
+        }
+    }
+
+    if(cmd_idx < 0)
+    {
+        ccTestPrintError("unknown parameter command '%s'", ccTestAbbreviatedArg(arg));
+        return(EXIT_FAILURE);
+    }
+
+    if(*remaining_line == NULL)
+    {
+        ccTestPrintError("missing parameter name for %s %s", cmd_name, cmds[cmd_idx].name);
+        return(EXIT_FAILURE);
+    }
+
+    *par_cmd_idx = cmd_idx;
+
+    return(ccTestGetParName(cmd_idx, remaining_line, par_matched));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+uint32_t ccCmdsSweep(uint32_t cmd_idx, char **remaining_line)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will define, run or reset a parameter sweep, e.g.:
+
+  SWEEP                                 Print the swept parameters
+  SWEEP IREG AUXPOLE1_HZ 1 2 5 10       Sweep IREG AUXPOLE1_HZ with a list of values
+  SWEEP MEAS I_FIR_LENGTHS[0] 10:40:10  Sweep MEAS I_FIR_LENGTHS[0] from 10 to 40 in steps of 10
+  SWEEP RUN                             Run every point of the grid of swept parameters
+  SWEEP RESET                           Clear all swept parameters
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char           *arg;
+    struct ccpars  *par_matched;
+    uint32_t        par_cmd_idx;
+    bool            is_run;
+
+    // If no arguments then print the sweep definition
+
+    arg = ccTestGetArgument(remaining_line);
+
+    if(arg == NULL)
+    {
+        ccSweepPrint();
+        return(EXIT_SUCCESS);
+    }
+
+    // Run or reset the sweep
+
+    is_run = (strcasecmp(arg, "RUN") == 0);
+
+    if(is_run || strcasecmp(arg, "RESET") == 0)
+    {
+        if(ccTestNoMoreArgs(remaining_line) == EXIT_FAILURE)
+        {
+            return(EXIT_FAILURE);
+        }
+
+        if(is_run)
+        {
+            return(ccSweepRun());
+        }
+
+        ccSweepReset();
+        return(EXIT_SUCCESS);
+    }
+
+    // Otherwise the argument must be a parameter command
+
+    if(ccCmdsGetParameter(cmds[cmd_idx].name, arg, remaining_line, &par_cmd_idx, &par_matched) == EXIT_FAILURE)
+    {
+        return(EXIT_FAILURE);
+    }
+
+    return(ccSweepAddAxis(par_cmd_idx, par_matched, remaining_line));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+uint32_t ccCmdsMc(uint32_t cmd_idx, char **remaining_line)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will define, run, replay or reset a Monte Carlo tolerance analysis, e.g.:
+
+  MC                                    Print the varied parameters
+  MC LOAD SIM_TC_ERROR UNIFORM -0.1 0.1 Vary LOAD SIM_TC_ERROR uniformly between -0.1 and 0.1
+  MC PC BANDWIDTH GAUSSIAN 1000 50      Vary PC BANDWIDTH with a gaussian of mean 1000 and sigma 50
+  MC RUN 1000 [first_seed]              Run 1000 times with seeds first_seed (default 1) onwards
+  MC REPLAY seed                        Set the parameters for seed so that RUN reproduces the run
+  MC RESET                              Clear all varied parameters
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char           *arg;
+    struct ccpars  *par_matched;
+    uint32_t        par_cmd_idx;
+    uint32_t        value[2] = { 0, 1 };
+    uint32_t        num_values;
+    uint32_t        max_values;
+    char           *remaining_arg;
+    bool            is_run;
+
+    // If no arguments then print the Monte Carlo definition
+
+    arg = ccTestGetArgument(remaining_line);
+
+    if(arg == NULL)
+    {
+        ccMonteCarloPrint();
+        return(EXIT_SUCCESS);
+    }
+
+    if(strcasecmp(arg, "RESET") == 0)
+    {
+        if(ccTestNoMoreArgs(remaining_line) == EXIT_FAILURE)
+        {
+            return(EXIT_FAILURE);
+        }
+
+        ccMonteCarloReset();
+        return(EXIT_SUCCESS);
+    }
+
+    // RUN takes the number of runs and optionally the first seed, REPLAY takes the seed
+
+    is_run = (strcasecmp(arg, "RUN") == 0);
+
+    if(is_run || strcasecmp(arg, "REPLAY") == 0)
+    {
+        char *keyword = arg;
+
+        max_values = is_run ? 2 : 1;
+
+        for(num_values = 0 ; (arg = ccTestGetArgument(remaining_line)) != NULL ; num_values++)
+        {
+            unsigned long ul_value;
+
+            errno    = 0;
+            ul_value = strtoul(arg, &remaining_arg, 10);
+
+            if(num_values >= max_values || *arg == '-' || *remaining_arg != '\0' || errno != 0 || ul_value > UINT32_MAX)
+            {
+                ccTestPrintError("invalid argument for MC %s: '%s'", keyword, ccTestAbbreviatedArg(arg));
+                return(EXIT_FAILURE);
+            }
+
+            value[num_values] = (uint32_t)ul_value;
+        }
+
+        if(num_values == 0)
+        {
+            ccTestPrintError("missing %s for MC %s", max_values == 2 ? "number of runs" : "seed", keyword);
+            return(EXIT_FAILURE);
+        }
+
+        if(max_values == 2)
+        {
+            return(ccMonteCarloRun(value[0], value[1]));
+        }
+
+        return(ccMonteCarloReplay(value[0]));
+    }
+
+    // Otherwise the argument must be a parameter command
+
+    if(ccCmdsGetParameter(cmds[cmd_idx].name, arg, remaining_line, &par_cmd_idx, &par_matched) == EXIT_FAILURE)
+    {
+        return(EXIT_FAILURE);
+    }
 
-    return(ccSigsReportBadValues());
+    return(ccMonteCarloAddVariation(par_cmd_idx, par_matched, remaining_line));
 }
 /*---------------------------------------------------------------------------------------------------------*/
 uint32_t ccCmdsPar(uint32_t cmd_idx, char **remaining_line)
@@ -20,6 +20,9 @@
 \*---------------------------------------------------------------------------------------------------------*/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 
 #include "ccCmds.h"
 #include "ccTest.h"
@@ -27,11 +30,354 @@
 #include "ccSigs.h"
 #include "ccFlot.h"
 #include "ccDebug.h"
+#include "ccFmt.h"
+#include "ccTable.h"
 #include "flot.h"
 
+// Min/max pyramid level - level 0 is streamed to the sidecar file so only levels 1 and above are kept in memory
 
+struct flot_mip_level
+{
+    uint32_t                    count;                          // Number of samples accumulated in the current bin
+    uint64_t                    num_records;                    // Number of completed bins
+    uint64_t                    max_records;                    // Number of bins allocated
+    float                      *min_max;                        // Bins: [num_records][num_sigs][min,max]
+};
+
+// Min/max pyramid for the current run
+
+static struct flot_mip
+{
+    FILE                       *file;                           // Sidecar file (NULL when FLOT_MIPMAP is DISABLED)
+    struct flot_mip_header      header;                         // Sidecar file header
+    uint32_t                    sig_idx[NUM_SIGNALS];           // signals[] index for each pyramid signal
+    float                      *row;                            // Level 0 record for the current iteration
+    struct flot_mip_level       level[FLOT_MIP_MAX_LEVELS];     // Levels (level[0] is not used)
+    uint32_t                    embed_level;                    // Level embedded in the html page (0 = FLOT buffers)
+    double                      embed_period;                   // Bin period for embed_level
+} flot_mip;
+
+
+
+// FLOT page output buffer
+
+static struct ccfmt_out flot_out;
+
+
+
+static void ccFlotPoint(struct ccfmt_out *out, double time, double value)
+{
+    // Equivalent to fprintf(f,"[%.6f,%.7E],",time,value)
+
+    ccFmtOutChar (out, '[');
+    ccFmtOutFixed(out, time, 6);
+    ccFmtOutChar (out, ',');
+    ccFmtOutExp  (out, value, 7);
+    ccFmtOutChar (out, ']');
+    ccFmtOutChar (out, ',');
+}
+
+
+
+static void ccFlotDigitalPoint(struct ccfmt_out *out, double time, double value)
+{
+    // Equivalent to fprintf(f,"[%.6f,%.2f],",time,value)
+
+    ccFmtOutChar (out, '[');
+    ccFmtOutFixed(out, time, 6);
+    ccFmtOutChar (out, ',');
+    ccFmtOutFixed(out, value, 2);
+    ccFmtOutChar (out, ']');
+    ccFmtOutChar (out, ',');
+}
+
+
+
+uint32_t ccFlotMipInit(char *mip_filename)
+{
+    uint32_t                    sig_idx;
+    uint32_t                    mip_sig_idx;
+    struct flot_mip_signal      mip_signal;
+
+    memset(&flot_mip, 0, sizeof(flot_mip));
+
+    flot_mip.file = fopen(mip_filename, "wb");
+
+    if(flot_mip.file == NULL)
+    {
+         ccTestPrintError("opening file '%s' : %s (%d)", mip_filename, strerror(errno), errno);
+         return(EXIT_FAILURE);
+    }
+
+    // All enabled analog signals are included in the pyramid
+
+    for(sig_idx = 0 ; sig_idx < NUM_SIGNALS ; sig_idx++)
+    {
+        if(signals[sig_idx].control == REG_ENABLED && signals[sig_idx].type == ANALOG)
+        {
+            flot_mip.sig_idx[flot_mip.header.num_sigs++] = sig_idx;
+        }
+    }
+
+    flot_mip.row = (float *)calloc(flot_mip.header.num_sigs + 1, sizeof(float));
+
+    if(flot_mip.row == NULL)
+    {
+         ccTestPrintError("allocating mipmap row for %u signals", flot_mip.header.num_sigs);
+         ccFlotMipFree();
+         return(EXIT_FAILURE);
+    }
+
+    // Write a provisional header and the signal descriptors - the header is rewritten by ccFlotMipWrite()
+
+    strcpy(flot_mip.header.magic, "CCMIP1");
+
+    flot_mip.header.header_size = sizeof(struct flot_mip_header) + flot_mip.header.num_sigs * sizeof(struct flot_mip_signal);
+    flot_mip.header.factor      = FLOT_MIP_FACTOR;
+    flot_mip.header.period      = ccpars_global.reverse_time == REG_DISABLED ? conv.iter_period : -conv.iter_period;
+    flot_mip.header.offset[0]   = flot_mip.header.header_size;
+
+    fwrite(&flot_mip.header, sizeof(struct flot_mip_header), 1, flot_mip.file);
+
+    for(mip_sig_idx = 0 ; mip_sig_idx < flot_mip.header.num_sigs ; mip_sig_idx++)
+    {
+        sig_idx = flot_mip.sig_idx[mip_sig_idx];
+
+        memset(&mip_signal, 0, sizeof(mip_signal));
+        strncpy(mip_signal.name, signals[sig_idx].name, FLOT_MIP_NAME_LEN - 1);
+        mip_signal.time_offset = signals[sig_idx].time_offset;
+
+        fwrite(&mip_signal, sizeof(mip_signal), 1, flot_mip.file);
+    }
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static void ccFlotMipBin(uint32_t level_idx, const float *src, uint32_t src_stride);
+
+static void ccFlotMipEndBin(uint32_t level_idx)
+{
+    struct flot_mip_level *level = &flot_mip.level[level_idx];
+    float                 *bin   = level->min_max + 2 * flot_mip.header.num_sigs * level->num_records;
+
+    level->count = 0;
+    level->num_records++;
+
+    // Completed bin feeds the next level up
+
+    if(level_idx < (FLOT_MIP_MAX_LEVELS - 1))
+    {
+        ccFlotMipBin(level_idx + 1, bin, 2);
+    }
+}
+
+
+
+static void ccFlotMipBin(uint32_t level_idx, const float *src, uint32_t src_stride)
+{
+    struct flot_mip_level *level    = &flot_mip.level[level_idx];
+    uint32_t               num_sigs = flot_mip.header.num_sigs;
+    uint32_t               mip_sig_idx;
+    float                 *bin;
+
+    // src contains the min and max for each signal: src[i*src_stride] and src[i*src_stride + src_stride - 1]
+    // so level 0 records (one value per signal) use src_stride 1 and min/max bins use src_stride 2
+
+    if(level->count == 0)
+    {
+        // First sample of a new bin - extend the level if required
+
+        if(level->num_records == level->max_records)
+        {
+            level->max_records = level->max_records == 0 ? 1024 : 2 * level->max_records;
+            level->min_max     = (float *)realloc(level->min_max, level->max_records * 2 * num_sigs * sizeof(float));
+
+            if(level->min_max == NULL)
+            {
+                fputs("Fatal: Unable to allocate memory for the FLOT min/max pyramid\n",stderr);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        bin = level->min_max + 2 * num_sigs * level->num_records;
+
+        for(mip_sig_idx = 0 ; mip_sig_idx < num_sigs ; mip_sig_idx++, bin += 2, src += src_stride)
+        {
+            bin[0] = src[0];
+            bin[1] = src[src_stride - 1];
+        }
+    }
+    else
+    {
+        bin = level->min_max + 2 * num_sigs * level->num_records;
+
+        for(mip_sig_idx = 0 ; mip_sig_idx < num_sigs ; mip_sig_idx++, bin += 2, src += src_stride)
+        {
+            if(src[0] < bin[0])
+            {
+                bin[0] = src[0];
+            }
+
+            if(src[src_stride - 1] > bin[1])
+            {
+                bin[1] = src[src_stride - 1];
+            }
+        }
+    }
+
+    if(++level->count == FLOT_MIP_FACTOR)
+    {
+        ccFlotMipEndBin(level_idx);
+    }
+}
+
+
+
+void ccFlotMipStore(double time)
+{
+    uint32_t    mip_sig_idx;
+
+    if(flot_mip.file == NULL)
+    {
+        return;
+    }
+
+    if(flot_mip.header.num_records[0] == 0)
+    {
+        flot_mip.header.time0 = time;
+    }
+
+    // Stream the raw values to the sidecar file (level 0) and accumulate them into the higher levels
+
+    for(mip_sig_idx = 0 ; mip_sig_idx < flot_mip.header.num_sigs ; mip_sig_idx++)
+    {
+        flot_mip.row[mip_sig_idx] = signals[flot_mip.sig_idx[mip_sig_idx]].value;
+    }
+
+    fwrite(flot_mip.row, sizeof(float), flot_mip.header.num_sigs, flot_mip.file);
 
-static uint32_t ccFlotRefs(FILE *f, double end_time)
+    flot_mip.header.num_records[0]++;
+
+    ccFlotMipBin(1, flot_mip.row, 1);
+}
+
+
+
+static void ccFlotMipWrite(void)
+{
+    uint32_t    level_idx;
+    uint32_t    num_levels;
+
+    // Close partially filled bins starting from the lowest level so that they propagate upwards
+
+    for(level_idx = 1 ; level_idx < FLOT_MIP_MAX_LEVELS ; level_idx++)
+    {
+        if(flot_mip.level[level_idx].count > 0)
+        {
+            ccFlotMipEndBin(level_idx);
+        }
+
+        flot_mip.header.num_records[level_idx] = flot_mip.level[level_idx].num_records;
+    }
+
+    // Keep levels up to the first one that is small enough to be displayed at full scale
+
+    for(num_levels = 1 ; num_levels < FLOT_MIP_MAX_LEVELS &&
+                         flot_mip.header.num_records[num_levels - 1] > FLOT_MIP_PAGE_POINTS ; num_levels++);
+
+    flot_mip.header.num_levels = num_levels;
+
+    for(level_idx = 1 ; level_idx < FLOT_MIP_MAX_LEVELS ; level_idx++)
+    {
+        if(level_idx < num_levels)
+        {
+            flot_mip.header.offset[level_idx] = ftell(flot_mip.file);
+
+            fwrite(flot_mip.level[level_idx].min_max, 2 * sizeof(float) * flot_mip.header.num_sigs,
+                   flot_mip.header.num_records[level_idx], flot_mip.file);
+        }
+        else
+        {
+            flot_mip.header.num_records[level_idx] = 0;
+        }
+    }
+
+    // Rewrite the header now that the number of records and offsets for each level are known
+
+    fseek(flot_mip.file, 0, SEEK_SET);
+    fwrite(&flot_mip.header, sizeof(struct flot_mip_header), 1, flot_mip.file);
+
+    // Embed the raw FLOT buffers in the html page if they are complete and small enough, otherwise
+    // embed the first level that is small enough to be displayed at full scale
+
+    flot_mip.embed_level  = 0;
+    flot_mip.embed_period = flot_mip.header.period;
+
+    if(flot_mip.header.num_records[0] > FLOT_MIP_PAGE_POINTS || flot_mip.header.num_records[0] > flot_index)
+    {
+        do
+        {
+            flot_mip.embed_level++;
+            flot_mip.embed_period *= FLOT_MIP_FACTOR;
+        }
+        while(flot_mip.embed_level < (FLOT_MIP_MAX_LEVELS - 1) &&
+              flot_mip.level[flot_mip.embed_level].num_records > FLOT_MIP_PAGE_POINTS);
+    }
+}
+
+
+
+void ccFlotMipFree(void)
+{
+    uint32_t    level_idx;
+
+    // Safe to call if the sidecar file is not open, so it can be used on every error path
+
+    if(flot_mip.file == NULL)
+    {
+        return;
+    }
+
+    fclose(flot_mip.file);
+
+    for(level_idx = 1 ; level_idx < FLOT_MIP_MAX_LEVELS ; level_idx++)
+    {
+        free(flot_mip.level[level_idx].min_max);
+    }
+
+    free(flot_mip.row);
+
+    memset(&flot_mip, 0, sizeof(flot_mip));
+}
+
+
+
+static uint32_t ccFlotMipAnalog(struct ccfmt_out *out, uint32_t mip_sig_idx, float time_offset)
+{
+    struct flot_mip_level *level = &flot_mip.level[flot_mip.embed_level];
+    uint64_t               record_idx;
+    float                 *bin;
+
+    // Print the min and max of each bin of the embedded level
+
+    for(record_idx = 0 ; record_idx < level->num_records ; record_idx++)
+    {
+        double  time = flot_mip.header.time0 + flot_mip.embed_period * record_idx + time_offset;
+
+        bin = level->min_max + 2 * (flot_mip.header.num_sigs * record_idx + mip_sig_idx);
+
+        ccFlotPoint(out, time, bin[0]);
+        ccFlotPoint(out, time + 0.5 * flot_mip.embed_period, bin[1]);
+    }
+
+    return(2 * level->num_records);
+}
+
+
+
+static uint32_t ccFlotRefs(struct ccfmt_out *out, double end_time)
 {
     uint32_t       cyc_sel;
     uint32_t       num_points;
@@ -44,7 +390,7 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
         {
             uint32_t cycle_idx;
 
-            fprintf(f,"\"(%u) %s\": { lines: { show:false }, points: { show:true }, downsample: { threshold: 0 },\ndata:[",
+            ccFmtOutPrintf(out,"\"(%u) %s\": { lines: { show:false }, points: { show:true }, downsample: { threshold: 0 },\ndata:[",
                       cyc_sel, ccParsEnumString(enum_function_type, ccpars_ref[cyc_sel].function));
 
             for(cycle_idx = 0 ; cycle_idx < ccrun.num_cycles ; cycle_idx++)
@@ -56,11 +402,10 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
                     double      time = 0.0;;
                     double      end_cycle_time;
 
-                    fprintf(f,"[%.6f,%.7E],[%.6f,%.7E],",
-                              ccrun.cycle[cycle_idx].start_time,
-                              ccrun.fg_meta[cyc_sel].range.start,
-                              ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay,
-                              ccrun.fg_meta[cyc_sel].range.start);
+                    ccFlotPoint(out, ccrun.cycle[cycle_idx].start_time,
+                                     ccrun.fg_meta[cyc_sel].range.start);
+                    ccFlotPoint(out, ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay,
+                                     ccrun.fg_meta[cyc_sel].range.start);
 
                     num_points += 3;
 
@@ -70,26 +415,34 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
                     case FG_TABLE:
                     case FG_DIRECT:
+                    case FG_STREAM:
+                    {
+                        float      *table_ref;
+                        float      *table_time;
+                        uint32_t    time_num_els;
+
+                        ccTableGet(cyc_sel, &table_ref, &n, &table_time, &time_num_els);
 
-                        n = table_pars[0].num_elements[cyc_sel] - 1;
+                        n--;
 
                         for(iteration_idx = 1 ; iteration_idx < n ; iteration_idx++)
                         {
-                            time = ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay + ccpars_table[cyc_sel].time[iteration_idx];
+                            time = ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay + table_time[iteration_idx];
 
                             if(time < end_time)
                             {
-                                fprintf(f,"[%.6f,%.7E],", time, ccpars_table[cyc_sel].ref[iteration_idx]);
+                                ccFlotPoint(out, time, table_ref[iteration_idx]);
                                 num_points++;
                             }
                         }
                         break;
+                    }
 
                     case FG_PPPL:
 
                         time = ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay;
 
-                        fprintf(f,"[%.6f,%.7E],", time, ccpars_pppl[cyc_sel].initial_ref);
+                        ccFlotPoint(out, time, ccpars_pppl[cyc_sel].initial_ref);
                         num_points++;
 
                         n = fg_pppl[cyc_sel].num_segs - 1;
@@ -100,7 +453,7 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
                             if(time < end_time)
                             {
-                                fprintf(f,"[%.6f,%.7E],", time, fg_pppl[cyc_sel].a0[iteration_idx]);
+                                ccFlotPoint(out, time, fg_pppl[cyc_sel].a0[iteration_idx]);
                                 num_points++;
                             }
                         }
@@ -110,7 +463,7 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
                         time = ccrun.cycle[cycle_idx].start_time + ccpars_global.run_delay;
 
-                        fprintf(f,"[%.6f,%.7E],", time, ccpars_plep[cyc_sel].initial_ref);
+                        ccFlotPoint(out, time, ccpars_plep[cyc_sel].initial_ref);
                         num_points++;
 
                         for(iteration_idx = 1 ; iteration_idx <  FG_PLEP_NUM_SEGS ; iteration_idx++)
@@ -119,7 +472,7 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
                             if(time < end_time)
                             {
-                                fprintf(f,"[%.6f,%.7E],", time, fg_plep[cyc_sel].normalisation * fg_plep[cyc_sel].ref[iteration_idx]);
+                                ccFlotPoint(out, time, fg_plep[cyc_sel].normalisation * fg_plep[cyc_sel].ref[iteration_idx]);
                                 num_points++;
                             }
                         }
@@ -132,11 +485,11 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
                     if(end_cycle_time > time && end_cycle_time < end_time)
                     {
-                        fprintf(f,"[%.6f,%.7E],", end_cycle_time, ccrun.fg_meta[cyc_sel].range.end);
+                        ccFlotPoint(out, end_cycle_time, ccrun.fg_meta[cyc_sel].range.end);
                     }
                 }
             }
-            fputs("]\n },\n",f);
+            ccFmtOutString(out,"]\n },\n");
         }
     }
 
@@ -145,7 +498,7 @@ static uint32_t ccFlotRefs(FILE *f, double end_time)
 
 
 
-static uint32_t ccFlotDynEco(FILE *f, double end_time)
+static uint32_t ccFlotDynEco(struct ccfmt_out *out, double end_time)
 {
     uint32_t       num_points = 0;
 
@@ -153,13 +506,13 @@ static uint32_t ccFlotDynEco(FILE *f, double end_time)
     {
         uint32_t       sig_idx;
 
-        fputs("\"DYN_ECO\": { lines: { show:false }, points: { show:true },\ndata:[",f);
+        ccFmtOutString(out,"\"DYN_ECO\": { lines: { show:false }, points: { show:true },\ndata:[");
 
         for(sig_idx = 0 ; sig_idx < ccrun.dyn_eco.log.length && ccrun.dyn_eco.log.time[sig_idx] < end_time ; sig_idx++, num_points++)
         {
-            fprintf(f,"[%.6f,%.7E],", ccrun.dyn_eco.log.time[sig_idx], ccrun.dyn_eco.log.ref[sig_idx]);
+            ccFlotPoint(out, ccrun.dyn_eco.log.time[sig_idx], ccrun.dyn_eco.log.ref[sig_idx]);
         }
-        fputs("]\n },\n",f);
+        ccFmtOutString(out,"]\n },\n");
     }
 
     return(num_points);
@@ -167,14 +520,15 @@ static uint32_t ccFlotDynEco(FILE *f, double end_time)
 
 
 
-static uint32_t ccFlotAnalog(FILE *f)
+static uint32_t ccFlotAnalog(struct ccfmt_out *out)
 {
     uint32_t       sig_idx;
+    uint32_t       mip_sig_idx;
     uint32_t       num_points;
 
     // Print enabled analog signal values
 
-    for(sig_idx = num_points = 0 ; sig_idx < NUM_SIGNALS ; sig_idx++)
+    for(sig_idx = num_points = mip_sig_idx = 0 ; sig_idx < NUM_SIGNALS ; sig_idx++)
     {
         if(signals[sig_idx].control == REG_ENABLED && signals[sig_idx].type == ANALOG)
         {
@@ -183,11 +537,19 @@ static uint32_t ccFlotAnalog(FILE *f)
 
             time_offset = signals[sig_idx].time_offset;
 
-            fprintf(f,"\"%s\": { lines: { steps:%s }, points: { show:false }, %s\ndata:[",
+            ccFmtOutPrintf(out,"\"%s\": { lines: { steps:%s }, points: { show:false }, %s\ndata:[",
                     signals[sig_idx].name,
                     signals[sig_idx].meta_data[0] == 'T' ? "true" : "false",
                     signals[sig_idx].meta_data[0] == 'T' ? "downsample: { threshold: 0 }," : "");
 
+            // If the min/max pyramid is in use then embed the level that fits the full scale page
+
+            if(flot_mip.file != NULL && flot_mip.embed_level > 0)
+            {
+                num_points += ccFlotMipAnalog(out, mip_sig_idx++, time_offset);
+                ccFmtOutString(out,"]\n },\n");
+                continue;
+            }
 
             for(iteration_idx = 0; iteration_idx < flot_index; iteration_idx++)
             {
@@ -209,11 +571,11 @@ static uint32_t ccFlotAnalog(FILE *f)
                         time = conv.iter_period * (ccrun.num_iterations - iteration_idx - 1);
                     }
 
-                    fprintf(f,"[%.6f,%.7E],", time, signals[sig_idx].buf[iteration_idx]);
+                    ccFlotPoint(out, time, signals[sig_idx].buf[iteration_idx]);
                     num_points++;
                 }
             }
-            fputs("]\n },\n",f);
+            ccFmtOutString(out,"]\n },\n");
         }
     }
 
@@ -222,7 +584,7 @@ static uint32_t ccFlotAnalog(FILE *f)
 
 
 
-static uint32_t ccFlotDigital(FILE *f)
+static uint32_t ccFlotDigital(struct ccfmt_out *out)
 {
     uint32_t       sig_idx;
     uint32_t       num_points;
@@ -236,7 +598,7 @@ static uint32_t ccFlotDigital(FILE *f)
 
             dig_offset -= 1.0;
 
-            fprintf(f,"\"%s\": {\n lines: { steps:%s },\n downsample: { threshold: 0 },\n data:[",
+            ccFmtOutPrintf(out,"\"%s\": {\n lines: { steps:%s },\n downsample: { threshold: 0 },\n data:[",
                     signals[sig_idx].name,
                     signals[sig_idx].meta_data[0] == 'T' ? "true" : "false");
 
@@ -260,11 +622,11 @@ static uint32_t ccFlotDigital(FILE *f)
                         time = conv.iter_period * (ccrun.num_iterations - iteration_idx - 1);
                     }
 
-                    fprintf(f,"[%.6f,%.2f],", time, signals[sig_idx].buf[iteration_idx] + dig_offset);
+                    ccFlotDigitalPoint(out, time, signals[sig_idx].buf[iteration_idx] + dig_offset);
                     num_points++;
                 }
             }
-            fputs("]\n },\n",f);
+            ccFmtOutString(out,"]\n },\n");
         }
     }
 
@@ -277,8 +639,25 @@ void ccFlot(FILE *f, char *filename)
 {;
     uint32_t       num_points;
     struct cccmds *cmd;
+    char          *mip_url = "";
+    char           mip_filename[CC_PATH_LEN];
     double         end_time = (double)flot_index * 1.0E-6 * (double)ccpars_global.iter_period_us;
 
+    // Complete the min/max pyramid sidecar file, if in use - it covers the whole run even if FLOT data is truncated
+
+    if(flot_mip.file != NULL)
+    {
+        ccFlotMipWrite();
+
+        end_time = (double)flot_mip.header.num_records[0] * 1.0E-6 * (double)ccpars_global.iter_period_us;
+
+        // Sidecar file is in the same directory as the html page
+
+        snprintf(mip_filename, CC_PATH_LEN, "%s.mip", strrchr(filename,'/') != NULL ? strrchr(filename,'/') + 1 : filename);
+
+        mip_url = mip_filename;
+    }
+
     // Warn user if FLOT data was truncated
 
     if(flot_index >= ccpars_global.flot_points_max)
@@ -288,27 +667,36 @@ void ccFlot(FILE *f, char *filename)
 
     // Print start of FLOT html page including flot path to all the javascript libraries
 
-    fprintf(f,flot[0],filename,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH);
+    ccFmtOutInit(&flot_out, f);
+
+    ccFmtOutPrintf(&flot_out,flot[0],filename,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,FLOT_PATH,mip_url);
 
     // Create Flot signals using points to represent the reference data
 
-    num_points = ccFlotRefs(f, end_time);
+    num_points = ccFlotRefs(&flot_out, end_time);
 
     // Create a Flot signal to mark dynamic economy, if in use
 
-    num_points += ccFlotDynEco(f, end_time);
+    num_points += ccFlotDynEco(&flot_out, end_time);
 
     // Print enabled analog signal values
 
-    num_points += ccFlotAnalog(f);
+    num_points += ccFlotAnalog(&flot_out);
+
+    if(flot_mip.file != NULL)
+    {
+        ccFlotMipFree();
+    }
 
     // Print start of digital signals
 
-    fputs(flot[1],f);
+    ccFmtOutString(&flot_out, flot[1]);
 
     // Print enabled digital signal values
 
-    num_points += ccFlotDigital(f);
+    num_points += ccFlotDigital(&flot_out);
+
+    ccFmtOutFlush(&flot_out);
 
     // Print command parameter values to become a colorbox pop-up
 
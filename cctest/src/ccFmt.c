@@ -0,0 +1,433 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccFmt.c                                                                     Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  cctest fast float formatting and buffered output functions
+
+  Notes:    The value is scaled by a power of ten so that the digits to print are the integer part and the
+            fraction decides the rounding. The scaling takes at most three roundings, so the error is below
+            1E-15 of the scaled value. If the fraction is within this tolerance of one half then the exact
+            decimal value could round either way, so snprintf() is used instead. The same happens for
+            values whose decimal exponent is ambiguous, for infinities and NaN, and for very large
+            or very small values.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "ccFmt.h"
+
+// Constants
+
+#define CC_FMT_TOLERANCE        1.0E-15             // Relative error bound on the scaled value (with margin)
+#define CC_FMT_MAX_POW10        22                  // Largest power of ten that is exact as a double
+
+static const double pow10_d[CC_FMT_MAX_POW10 + 1] =
+{
+    1.0E0,  1.0E1,  1.0E2,  1.0E3,  1.0E4,  1.0E5,  1.0E6,  1.0E7,  1.0E8,  1.0E9,  1.0E10, 1.0E11,
+    1.0E12, 1.0E13, 1.0E14, 1.0E15, 1.0E16, 1.0E17, 1.0E18, 1.0E19, 1.0E20, 1.0E21, 1.0E22
+};
+
+static const uint64_t pow10_u[CC_FMT_MAX_PRECISION + 1] =
+{
+    1ULL,           10ULL,           100ULL,           1000ULL,
+    10000ULL,       100000ULL,       1000000ULL,       10000000ULL,
+    100000000ULL,   1000000000ULL,   10000000000ULL,   100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL
+};
+
+
+
+static char *ccFmtUnsigned(char *p, uint64_t n, uint32_t min_digits)
+{
+    char        digits[24];
+    uint32_t    num_digits = 0;
+
+    // Print n using at least min_digits digits with leading zeros
+
+    do
+    {
+        digits[num_digits++] = '0' + (n % 10);
+        n /= 10;
+    }
+    while(n > 0);
+
+    while(num_digits < min_digits)
+    {
+        digits[num_digits++] = '0';
+    }
+
+    while(num_digits > 0)
+    {
+        *(p++) = digits[--num_digits];
+    }
+
+    return(p);
+}
+
+
+
+static int32_t ccFmtScale(double a, int32_t exp10, double *scaled)
+{
+    // Return a * 10^exp10 using at most two roundings, or a non-zero value if exp10 is out of range
+
+    if(exp10 >= 0)
+    {
+        if(exp10 > 2 * CC_FMT_MAX_POW10)
+        {
+            return(1);
+        }
+
+        if(exp10 > CC_FMT_MAX_POW10)
+        {
+            a     *= pow10_d[CC_FMT_MAX_POW10];
+            exp10 -= CC_FMT_MAX_POW10;
+        }
+
+        *scaled = a * pow10_d[exp10];
+    }
+    else
+    {
+        exp10 = -exp10;
+
+        if(exp10 > 2 * CC_FMT_MAX_POW10)
+        {
+            return(1);
+        }
+
+        if(exp10 > CC_FMT_MAX_POW10)
+        {
+            a     /= pow10_d[CC_FMT_MAX_POW10];
+            exp10 -= CC_FMT_MAX_POW10;
+        }
+
+        *scaled = a / pow10_d[exp10];
+    }
+
+    return(0);
+}
+
+
+
+char *ccFmtExp(char *p, double value, uint32_t precision)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function writes value in the same format as printf("%.*E",precision,value) and returns a pointer
+  to the character after the last one written. No null is written. At least CC_FMT_MAX_FIELD characters
+  must be available.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char       *q = p;
+    double      a;
+    double      y;
+    double      frac;
+    int32_t     exp2;
+    int32_t     exp10;
+    uint64_t    n;
+
+    if(precision > CC_FMT_MAX_PRECISION || !isfinite(value))
+    {
+        goto fallback;
+    }
+
+    a = fabs(value);
+
+    if(signbit(value))
+    {
+        *(q++) = '-';
+    }
+
+    if(a == 0.0)
+    {
+        n     = 0;
+        exp10 = 0;
+    }
+    else
+    {
+        // Estimate the decimal exponent from the binary exponent: 2^(exp2-1) <= a < 2^exp2 so the
+        // estimate is either correct or one too small
+
+        frexp(a, &exp2);
+
+        exp10 = (int32_t)floor((exp2 - 1) * 0.30102999566398120);
+
+        if(ccFmtScale(a, (int32_t)precision - exp10, &y) != 0)
+        {
+            goto fallback;
+        }
+
+        if(y >= pow10_d[precision + 1])
+        {
+            exp10++;
+
+            if(ccFmtScale(a, (int32_t)precision - exp10, &y) != 0)
+            {
+                goto fallback;
+            }
+        }
+
+        // The scaled value must be in the range [10^precision, 10^(precision+1) - 1] so that rounding
+        // cannot change the exponent
+
+        if(y < pow10_d[precision] || y > (pow10_d[precision + 1] - 1.0))
+        {
+            goto fallback;
+        }
+
+        n    = (uint64_t)y;
+        frac = y - (double)n;
+
+        if(fabs(frac - 0.5) <= y * CC_FMT_TOLERANCE)
+        {
+            goto fallback;
+        }
+
+        if(frac > 0.5)
+        {
+            n++;
+        }
+    }
+
+    // Print mantissa
+
+    q = ccFmtUnsigned(q, n, precision + 1);
+
+    if(precision > 0)
+    {
+        char *point = q - precision;
+
+        memmove(point + 1, point, precision);
+        *point = '.';
+        q++;
+    }
+
+    // Print exponent with at least two digits
+
+    *(q++) = 'E';
+
+    if(exp10 < 0)
+    {
+        *(q++) = '-';
+        exp10  = -exp10;
+    }
+    else
+    {
+        *(q++) = '+';
+    }
+
+    return(ccFmtUnsigned(q, (uint64_t)exp10, 2));
+
+fallback:
+
+    return(p + snprintf(p, CC_FMT_MAX_FIELD, "%.*E", (int)precision, value));
+}
+
+
+
+char *ccFmtFixed(char *p, double value, uint32_t precision)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function writes value in the same format as printf("%.*f",precision,value) and returns a pointer
+  to the character after the last one written. No null is written. At least CC_FMT_MAX_FIELD characters
+  must be available.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char       *q = p;
+    double      y;
+    double      frac;
+    uint64_t    n;
+
+    if(precision > CC_FMT_MAX_PRECISION || !isfinite(value))
+    {
+        goto fallback;
+    }
+
+    // Scaling by an exact power of ten takes one rounding
+
+    y = fabs(value) * pow10_d[precision];
+
+    if(y >= 1.0E15)
+    {
+        goto fallback;
+    }
+
+    n    = (uint64_t)y;
+    frac = y - (double)n;
+
+    if(fabs(frac - 0.5) <= y * CC_FMT_TOLERANCE)
+    {
+        goto fallback;
+    }
+
+    if(frac > 0.5)
+    {
+        n++;
+    }
+
+    // Print sign, integer part and fractional part
+
+    if(signbit(value))
+    {
+        *(q++) = '-';
+    }
+
+    q = ccFmtUnsigned(q, n / pow10_u[precision], 1);
+
+    if(precision > 0)
+    {
+        *(q++) = '.';
+        q = ccFmtUnsigned(q, n % pow10_u[precision], precision);
+    }
+
+    return(q);
+
+fallback:
+
+    return(p + snprintf(p, CC_FMT_MAX_FIELD, "%.*f", (int)precision, value));
+}
+
+
+
+void ccFmtOutInit(struct ccfmt_out *out, FILE *f)
+{
+    out->f         = f;
+    out->p         = out->buf;
+    out->num_bytes = 0;
+}
+
+
+
+void ccFmtOutFlush(struct ccfmt_out *out)
+{
+    size_t      num_bytes = out->p - out->buf;
+
+    if(num_bytes > 0)
+    {
+        fwrite(out->buf, 1, num_bytes, out->f);
+
+        out->num_bytes += num_bytes;
+        out->p          = out->buf;
+    }
+}
+
+
+
+static void ccFmtOutReserve(struct ccfmt_out *out, size_t num_bytes)
+{
+    if(out->p + num_bytes > out->buf + CC_FMT_BUF_LEN)
+    {
+        ccFmtOutFlush(out);
+    }
+}
+
+
+
+void ccFmtOutExp(struct ccfmt_out *out, double value, uint32_t precision)
+{
+    ccFmtOutReserve(out, CC_FMT_MAX_FIELD);
+
+    out->p = ccFmtExp(out->p, value, precision);
+}
+
+
+
+void ccFmtOutFixed(struct ccfmt_out *out, double value, uint32_t precision)
+{
+    ccFmtOutReserve(out, CC_FMT_MAX_FIELD);
+
+    out->p = ccFmtFixed(out->p, value, precision);
+}
+
+
+
+void ccFmtOutChar(struct ccfmt_out *out, char c)
+{
+    ccFmtOutReserve(out, 1);
+
+    *(out->p++) = c;
+}
+
+
+
+void ccFmtOutString(struct ccfmt_out *out, const char *s)
+{
+    size_t      len = strlen(s);
+
+    // Very long strings are written directly
+
+    if(len > CC_FMT_BUF_LEN / 2)
+    {
+        ccFmtOutFlush(out);
+
+        fwrite(s, 1, len, out->f);
+
+        out->num_bytes += len;
+        return;
+    }
+
+    ccFmtOutReserve(out, len);
+
+    memcpy(out->p, s, len);
+
+    out->p += len;
+}
+
+
+
+void ccFmtOutPrintf(struct ccfmt_out *out, const char *format, ...)
+{
+    va_list     argv;
+    size_t      space = out->buf + CC_FMT_BUF_LEN - out->p;
+    int         len;
+
+    // Try to print into the free space in the buffer
+
+    va_start(argv, format);
+    len = vsnprintf(out->p, space, format, argv);
+    va_end(argv);
+
+    if(len < 0)
+    {
+        return;
+    }
+
+    if((size_t)len < space)
+    {
+        out->p += len;
+        return;
+    }
+
+    // Not enough space - flush the buffer and try again, or print directly if it is still too long
+
+    ccFmtOutFlush(out);
+
+    va_start(argv, format);
+
+    if((size_t)len < CC_FMT_BUF_LEN)
+    {
+        out->p += vsnprintf(out->p, CC_FMT_BUF_LEN, format, argv);
+    }
+    else
+    {
+        out->num_bytes += vfprintf(out->f, format, argv);
+    }
+
+    va_end(argv);
+}
+
+// EOF
@@ -35,6 +35,7 @@
 #include "ccRef.h"
 #include "ccSigs.h"
 #include "ccRun.h"
+#include "libfg/arm.h"
 
 /*---------------------------------------------------------------------------------------------------------*/
 void ccInitPars(void)
@@ -94,8 +95,11 @@ uint32_t ccInitFunctions(void)
     uint32_t         idx;
     uint32_t         cyc_sel;
     uint32_t         exit_status;
+    uint32_t         num_jobs;
     struct fgfunc   *func;
     struct cccmds   *cmd;
+    struct fg_limits fgen_limits;
+    struct fg_arm_job jobs[CC_NUM_CYC_SELS];
 
     // Initialise ccrun structure
 
@@ -132,13 +136,22 @@ uint32_t ccInitFunctions(void)
             ccTestPrintError("only one function can be specified when REVERSE_TIME is ENABLED");
             return(EXIT_FAILURE);
         }
+
+        // A STREAM function can only be generated with increasing time
+
+        if(ccpars_ref[ccpars_global.cycle_selector[0]].function == FG_STREAM)
+        {
+            ccTestPrintError("REF FUNCTION cannot be STREAM when REVERSE_TIME is ENABLED");
+            return(EXIT_FAILURE);
+        }
     }
 
-    // if GLOBAL FG_LIMITS is ENABLED then link to function generation limits
+    // Check the number of threads used to arm the functions
 
-    if(ccpars_global.fg_limits == REG_ENABLED)
+    if(ccpars_global.arm_threads < 1 || ccpars_global.arm_threads > FG_ARM_MAX_THREADS)
     {
-        ccrun.fg_limits = &ccrun.fgen_limits;
+        ccTestPrintError("GLOBAL ARM_THREADS must be from 1 to %u", FG_ARM_MAX_THREADS);
+        return(EXIT_FAILURE);
     }
 
     // If voltage perturbation is not required then set perturb_time to beyond end of simulation
@@ -149,9 +162,12 @@ uint32_t ccInitFunctions(void)
         ccpars_load.perturb_time  = 1.0E30;
     }
 
-    // Initialise the reference functions
+    // Check the reference functions and prepare a job to arm each one. The limits for a REG_MODE of NONE
+    // are those of the previous function, so they are carried from one function to the next.
 
-    exit_status = EXIT_SUCCESS;
+    memset(&fgen_limits, 0, sizeof(fgen_limits));
+
+    num_jobs = 0;
 
     for(idx = 0 ; idx < ccrun.num_cycles ; idx++)
     {
@@ -199,49 +215,53 @@ uint32_t ccInitFunctions(void)
                 case REG_NONE: break;
                 case REG_FIELD:
 
-                    ccrun.is_breg_enabled          = true;
-                    ccrun.fgen_limits.pos          = ccpars_limits.b_pos         [ccpars_load.select];
-                    ccrun.fgen_limits.min          = ccpars_limits.b_min         [ccpars_load.select];
-                    ccrun.fgen_limits.neg          = ccpars_limits.b_neg         [ccpars_load.select];
-                    ccrun.fgen_limits.rate         = ccpars_limits.b_rate        [ccpars_load.select];
-                    ccrun.fgen_limits.acceleration = ccpars_limits.b_acceleration[ccpars_load.select];
+                    ccrun.is_breg_enabled    = true;
+                    fgen_limits.pos          = ccpars_limits.b_pos         [ccpars_load.select];
+                    fgen_limits.min          = ccpars_limits.b_min         [ccpars_load.select];
+                    fgen_limits.neg          = ccpars_limits.b_neg         [ccpars_load.select];
+                    fgen_limits.rate         = ccpars_limits.b_rate        [ccpars_load.select];
+                    fgen_limits.acceleration = ccpars_limits.b_acceleration[ccpars_load.select];
                     break;
 
                 case REG_CURRENT:
 
-                    ccrun.is_ireg_enabled          = true;
-                    ccrun.fgen_limits.pos          = ccpars_limits.i_pos         [ccpars_load.select];
-                    ccrun.fgen_limits.min          = ccpars_limits.i_min         [ccpars_load.select];
-                    ccrun.fgen_limits.neg          = ccpars_limits.i_neg         [ccpars_load.select];
-                    ccrun.fgen_limits.rate         = ccpars_limits.i_rate        [ccpars_load.select];
-                    ccrun.fgen_limits.acceleration = ccpars_limits.i_acceleration[ccpars_load.select];
+                    ccrun.is_ireg_enabled    = true;
+                    fgen_limits.pos          = ccpars_limits.i_pos         [ccpars_load.select];
+                    fgen_limits.min          = ccpars_limits.i_min         [ccpars_load.select];
+                    fgen_limits.neg          = ccpars_limits.i_neg         [ccpars_load.select];
+                    fgen_limits.rate         = ccpars_limits.i_rate        [ccpars_load.select];
+                    fgen_limits.acceleration = ccpars_limits.i_acceleration[ccpars_load.select];
                     break;
 
                 case REG_VOLTAGE:
 
-                    ccrun.fgen_limits.pos          = ccpars_limits.v_pos         [ccpars_load.select];
-                    ccrun.fgen_limits.min          = 0.0;
-                    ccrun.fgen_limits.neg          = ccpars_limits.v_neg         [ccpars_load.select];
-                    ccrun.fgen_limits.rate         = ccpars_limits.v_rate;
-                    ccrun.fgen_limits.acceleration = ccpars_limits.v_acceleration;
+                    fgen_limits.pos          = ccpars_limits.v_pos         [ccpars_load.select];
+                    fgen_limits.min          = 0.0;
+                    fgen_limits.neg          = ccpars_limits.v_neg         [ccpars_load.select];
+                    fgen_limits.rate         = ccpars_limits.v_rate;
+                    fgen_limits.acceleration = ccpars_limits.v_acceleration;
                     break;
             }
 
-            // Try to arm the function for this cycle selector
+            // Each function has its own copy of the limits so that the functions can be armed concurrently.
+            // If GLOBAL FG_LIMITS is ENABLED then link to function generation limits.
 
-            func = &funcs[ccpars_ref[cyc_sel].function];
+            ccrun.fgen_limits[cyc_sel] = fgen_limits;
 
-            if(func->init_func(&ccrun.fg_meta[cyc_sel], cyc_sel) != FG_OK)
+            if(ccpars_global.fg_limits == REG_ENABLED)
             {
-                ccTestPrintError("failed to initialise %s(%u) : %s : error_idx=%u : error_data=%g,%g,%g,%g", 
-                        ccParsEnumString(enum_function_type, ccpars_ref[cyc_sel].function),
-                        cyc_sel,
-                        ccParsEnumString(enum_fg_error, ccrun.fg_meta[cyc_sel].fg_error),
-                        ccrun.fg_meta[cyc_sel].error.data[0],ccrun.fg_meta[cyc_sel].error.data[1],
-                        ccrun.fg_meta[cyc_sel].error.data[2],ccrun.fg_meta[cyc_sel].error.data[3]);
-                exit_status = EXIT_FAILURE;
+                ccrun.fg_limits[cyc_sel] = &ccrun.fgen_limits[cyc_sel];
             }
 
+            // Prepare the job to arm the function for this cycle selector
+
+            func = &funcs[ccpars_ref[cyc_sel].function];
+
+            jobs[num_jobs].init = func->init_func;
+            jobs[num_jobs].idx  = cyc_sel;
+            jobs[num_jobs].meta = &ccrun.fg_meta[cyc_sel];
+            num_jobs++;
+
             // Mark command for this function as enabled to include parameters in FLOT colorbox pop-up
 
             cmds[func->cmd_idx].is_enabled = true;
@@ -249,6 +269,28 @@ uint32_t ccInitFunctions(void)
         }
     }
 
+    // Try to arm the functions, using GLOBAL ARM_THREADS threads, and report errors in cycle order
+
+    fgArm(jobs, num_jobs, ccpars_global.arm_threads);
+
+    exit_status = EXIT_SUCCESS;
+
+    for(idx = 0 ; idx < num_jobs ; idx++)
+    {
+        if(jobs[idx].fg_error != FG_OK)
+        {
+            cyc_sel = jobs[idx].idx;
+
+            ccTestPrintError("failed to initialise %s(%u) : %s : error_idx=%u : error_data=%g,%g,%g,%g", 
+                    ccParsEnumString(enum_function_type, ccpars_ref[cyc_sel].function),
+                    cyc_sel,
+                    ccParsEnumString(enum_fg_error, ccrun.fg_meta[cyc_sel].fg_error),
+                    ccrun.fg_meta[cyc_sel].error.data[0],ccrun.fg_meta[cyc_sel].error.data[1],
+                    ccrun.fg_meta[cyc_sel].error.data[2],ccrun.fg_meta[cyc_sel].error.data[3]);
+            exit_status = EXIT_FAILURE;
+        }
+    }
+
     // Check that no errors occurred while arming functions
 
     if(exit_status == EXIT_FAILURE)
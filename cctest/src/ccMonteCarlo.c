@@ -0,0 +1,715 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccMonteCarlo.c                                                              Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  cctest Monte Carlo tolerance analysis functions
+
+  Notes:    Each run is identified by a seed. The seed drives a private random generator that sets the
+            varied parameters and then seeds the measurement noise and invalid measurement generators, so
+            a run depends only on its seed and the other parameters. Runs are executed by the parallel
+            workers of ccSweep.c and the results are aggregated as they arrive, in seed order, using
+            P-square streaming quantile estimators (Jain & Chlamtac, 1985). No per-run results are stored,
+            apart from the few worst and failed runs that are reported.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include "ccCmds.h"
+#include "ccTest.h"
+#include "ccRun.h"
+#include "ccSweep.h"
+#include "ccMonteCarlo.h"
+
+// Constants
+
+#define CC_MC_VALUE_LEN         32                  // Max length of a varied parameter value
+#define CC_MC_NUM_QUANTILES     3                   // Number of quantiles reported for each metric
+#define CC_MC_NUM_METRICS       2                   // Number of metrics (MAX_ABS_ERR, RMS_ERR)
+
+// Distributions
+
+enum ccmc_distribution
+{
+    CC_MC_UNIFORM,
+    CC_MC_GAUSSIAN,
+};
+
+// Varied parameter
+
+struct ccmc_variation
+{
+    uint32_t                    cmd_idx;                // Command index of the parameter
+    struct ccpars              *par;                    // Parameter
+    uint32_t                    cyc_sel;                // Cycle selector (or CC_NO_INDEX)
+    uint32_t                    array_idx;              // Array index (or CC_NO_INDEX)
+    enum ccmc_distribution      distribution;           // Distribution of the values
+    double                      arg[2];                 // UNIFORM: min, max. GAUSSIAN: mean, sigma
+};
+
+// P-square streaming quantile estimator
+
+struct ccmc_quantile
+{
+    double                      p;                      // Quantile (0-1)
+    uint32_t                    num_values;             // Number of values added
+    double                      q[5];                   // Marker heights
+    double                      n[5];                   // Marker positions
+    double                      n_desired[5];           // Desired marker positions
+    double                      n_increment[5];         // Increments of the desired marker positions
+};
+
+// Metric statistics
+
+struct ccmc_metric
+{
+    char                       *name;                   // Metric name
+    uint32_t                    num_values;             // Number of values added
+    double                      sum;                    // Sum of values
+    double                      min;                    // Min value
+    double                      max;                    // Max value
+    struct ccmc_quantile        quantile[CC_MC_NUM_QUANTILES];
+};
+
+// Reported run
+
+struct ccmc_run
+{
+    uint32_t                    seed;                   // Seed of the run
+    uint32_t                    is_pc_tripped;          // Voltage source tripped during the run
+    double                      max_abs_err;            // Max absolute regulation error
+    double                      rms_err;                // RMS regulation error
+};
+
+// Monte Carlo definition and aggregated results
+
+static struct ccmc
+{
+    uint32_t                    num_variations;                         // Number of varied parameters
+    struct ccmc_variation       variation[CC_MC_MAX_VARIATIONS];        // Varied parameters
+    uint32_t                    first_seed;                             // Seed of the first run
+
+    uint32_t                    num_completed;                          // Number of completed runs
+    uint32_t                    num_failed;                             // Number of failed runs
+    uint32_t                    num_tripped;                            // Number of runs that tripped
+    uint32_t                    num_clipped;                            // Number of runs with reference clipping
+    uint32_t                    num_err_warning;                        // Number of runs with error warnings
+    uint32_t                    num_err_fault;                          // Number of runs with error faults
+    struct ccmc_metric          metric[CC_MC_NUM_METRICS];              // Statistics of the error metrics
+    uint32_t                    num_worst;                              // Number of worst runs
+    struct ccmc_run             worst[CC_MC_NUM_WORST];                 // Worst runs, worst first
+    uint32_t                    failed_seed[CC_MC_NUM_FAILED];          // Seeds of the first failed runs
+} ccmc;
+
+static const double ccmc_quantiles[CC_MC_NUM_QUANTILES] = { 0.50, 0.90, 0.99 };
+static char * const ccmc_quantile_names[CC_MC_NUM_QUANTILES] = { "P50", "P90", "P99" };
+
+
+
+static uint64_t ccMonteCarloRandom(uint64_t *state)
+{
+    // splitmix64 - a portable generator, so seeds give the same runs on every platform
+
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return(z ^ (z >> 31));
+}
+
+
+
+static double ccMonteCarloUniform(uint64_t *state)
+{
+    // Uniform in [0,1) with 53 bits of resolution
+
+    return((ccMonteCarloRandom(state) >> 11) * (1.0 / 9007199254740992.0));
+}
+
+
+
+static double ccMonteCarloGaussian(uint64_t *state)
+{
+    // Box-Muller transform - only one of the pair is used so every value takes two draws
+
+    double u1 = 1.0 - ccMonteCarloUniform(state);
+    double u2 = ccMonteCarloUniform(state);
+
+    return(sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
+
+
+
+static void ccMonteCarloVariationName(char *name, size_t len, struct ccmc_variation *variation)
+{
+    int n = snprintf(name, len, "%s_%s", cmds[variation->cmd_idx].name, variation->par->name);
+
+    if(variation->cyc_sel != CC_NO_INDEX && n < (int)len)
+    {
+        n += snprintf(name + n, len - n, "(%u)", variation->cyc_sel);
+    }
+
+    if(variation->array_idx != CC_NO_INDEX && n < (int)len)
+    {
+        snprintf(name + n, len - n, "[%u]", variation->array_idx);
+    }
+}
+
+
+
+static uint32_t ccMonteCarloGetNumber(char **remaining_line, double *value)
+{
+    char   *arg = ccTestGetArgument(remaining_line);
+    char   *remaining_arg;
+
+    if(arg == NULL)
+    {
+        ccTestPrintError("missing value for MC distribution");
+        return(EXIT_FAILURE);
+    }
+
+    errno  = 0;
+    *value = strtod(arg, &remaining_arg);
+
+    if(*remaining_arg != '\0' || errno != 0 || isfinite(*value) == 0)
+    {
+        ccTestPrintError("invalid value for MC distribution: '%s'", ccTestAbbreviatedArg(arg));
+        return(EXIT_FAILURE);
+    }
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+uint32_t ccMonteCarloAddVariation(uint32_t cmd_idx, struct ccpars *par, char **remaining_line)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will add a varied parameter with the distribution remaining on the line, which must be
+  UNIFORM min max or GAUSSIAN mean sigma. Only FLOAT parameters can be varied. The parameter's cycle
+  selector and array index must be in cctest.cyc_sel and cctest.array_idx. If the parameter is already
+  varied then its distribution is replaced.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t                var_idx;
+    char                   *arg;
+    struct ccmc_variation   new_variation;
+
+    if(par->type != PAR_FLOAT)
+    {
+        ccTestPrintError("only FLOAT parameters can be varied: %s %s", cmds[cmd_idx].name, par->name);
+        return(EXIT_FAILURE);
+    }
+
+    memset(&new_variation, 0, sizeof(new_variation));
+
+    new_variation.cmd_idx   = cmd_idx;
+    new_variation.par       = par;
+    new_variation.cyc_sel   = cctest.cyc_sel;
+    new_variation.array_idx = cctest.array_idx;
+
+    // Get the distribution and its arguments
+
+    arg = ccTestGetArgument(remaining_line);
+
+    if(arg != NULL && strcasecmp(arg, "UNIFORM") == 0)
+    {
+        new_variation.distribution = CC_MC_UNIFORM;
+    }
+    else if(arg != NULL && strcasecmp(arg, "GAUSSIAN") == 0)
+    {
+        new_variation.distribution = CC_MC_GAUSSIAN;
+    }
+    else
+    {
+        ccTestPrintError("UNIFORM min max or GAUSSIAN mean sigma expected for MC %s %s",
+                         cmds[cmd_idx].name, par->name);
+        return(EXIT_FAILURE);
+    }
+
+    if(ccMonteCarloGetNumber(remaining_line, &new_variation.arg[0]) == EXIT_FAILURE ||
+       ccMonteCarloGetNumber(remaining_line, &new_variation.arg[1]) == EXIT_FAILURE ||
+       ccTestNoMoreArgs(remaining_line) == EXIT_FAILURE)
+    {
+        return(EXIT_FAILURE);
+    }
+
+    if(new_variation.distribution == CC_MC_UNIFORM ? new_variation.arg[1] < new_variation.arg[0] : new_variation.arg[1] < 0.0)
+    {
+        ccTestPrintError("invalid %s distribution for MC %s %s", arg, cmds[cmd_idx].name, par->name);
+        return(EXIT_FAILURE);
+    }
+
+    // Replace an existing variation of the same parameter element or add a new one
+
+    for(var_idx = 0 ; var_idx < ccmc.num_variations ; var_idx++)
+    {
+        struct ccmc_variation *variation = &ccmc.variation[var_idx];
+
+        if(variation->par == par && variation->cyc_sel == new_variation.cyc_sel && variation->array_idx == new_variation.array_idx)
+        {
+            break;
+        }
+    }
+
+    if(var_idx >= CC_MC_MAX_VARIATIONS)
+    {
+        ccTestPrintError("too many MC parameters (%u max)", CC_MC_MAX_VARIATIONS);
+        return(EXIT_FAILURE);
+    }
+
+    ccmc.variation[var_idx] = new_variation;
+
+    if(var_idx == ccmc.num_variations)
+    {
+        ccmc.num_variations++;
+    }
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+void ccMonteCarloReset(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will clear all the varied parameters.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    ccmc.num_variations = 0;
+}
+
+
+
+void ccMonteCarloPrint(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will print the varied parameters and their distributions.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    var_idx;
+    char        name[CC_PATH_LEN];
+
+    for(var_idx = 0 ; var_idx < ccmc.num_variations ; var_idx++)
+    {
+        struct ccmc_variation *variation = &ccmc.variation[var_idx];
+
+        ccMonteCarloVariationName(name, sizeof(name), variation);
+
+        printf("%-*s %-*s %s %.7g %.7g\n", CC_MAX_CMD_NAME_LEN, "MC",
+               CC_MAX_PAR_NAME_LEN - CC_MAX_CMD_NAME_LEN - 1, name,
+               variation->distribution == CC_MC_UNIFORM ? "UNIFORM" : "GAUSSIAN",
+               variation->arg[0], variation->arg[1]);
+    }
+
+    printf("%-*s %u parameters\n", CC_MAX_CMD_NAME_LEN, "MC", ccmc.num_variations);
+}
+
+
+
+static uint32_t ccMonteCarloSetPars(uint32_t seed, bool print_values)
+{
+    uint64_t    state = seed;
+    uint32_t    var_idx;
+    double      value;
+    char        value_string[CC_MC_VALUE_LEN];
+    char        name[CC_PATH_LEN];
+    char       *remaining_line;
+
+    // Draw the value of every varied parameter in turn
+
+    for(var_idx = 0 ; var_idx < ccmc.num_variations ; var_idx++)
+    {
+        struct ccmc_variation *variation = &ccmc.variation[var_idx];
+
+        if(variation->distribution == CC_MC_UNIFORM)
+        {
+            value = variation->arg[0] + (variation->arg[1] - variation->arg[0]) * ccMonteCarloUniform(&state);
+        }
+        else
+        {
+            value = variation->arg[0] + variation->arg[1] * ccMonteCarloGaussian(&state);
+        }
+
+        remaining_line   = value_string;
+        cctest.cyc_sel   = variation->cyc_sel;
+        cctest.array_idx = variation->array_idx;
+
+        snprintf(value_string, CC_MC_VALUE_LEN, "%.9g", value);
+
+        if(print_values == true)
+        {
+            ccMonteCarloVariationName(name, sizeof(name), variation);
+            printf("%-*s %-*s %s\n", CC_MAX_CMD_NAME_LEN, "MC",
+                   CC_MAX_PAR_NAME_LEN - CC_MAX_CMD_NAME_LEN - 1, name, value_string);
+        }
+
+        if(ccParsGet(cmds[variation->cmd_idx].name, variation->par, &remaining_line) == EXIT_FAILURE)
+        {
+            cctest.cyc_sel   = CC_NO_INDEX;
+            cctest.array_idx = CC_NO_INDEX;
+            return(EXIT_FAILURE);
+        }
+    }
+
+    cctest.cyc_sel   = CC_NO_INDEX;
+    cctest.array_idx = CC_NO_INDEX;
+
+    // Seed the measurement noise and invalid measurement generators
+
+    regMeasSetNoiseSeed((uint32_t)ccMonteCarloRandom(&state));
+    srandom((unsigned int)ccMonteCarloRandom(&state));
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static uint32_t ccMonteCarloInitRun(uint32_t point_idx)
+{
+    return(ccMonteCarloSetPars(ccmc.first_seed + point_idx, false));
+}
+
+
+
+static void ccMonteCarloAddQuantile(struct ccmc_quantile *quantile, double value)
+{
+    double     *q = quantile->q;
+    double     *n = quantile->n;
+    double      p = quantile->p;
+    double      d;
+    double      q_parabolic;
+    uint32_t    i;
+    uint32_t    k;
+
+    // Keep the first five values in ascending order to initialise the markers
+
+    if(quantile->num_values < 5)
+    {
+        for(i = quantile->num_values ; i > 0 && q[i - 1] > value ; i--)
+        {
+            q[i] = q[i - 1];
+        }
+
+        q[i] = value;
+
+        if(++quantile->num_values == 5)
+        {
+            for(i = 0 ; i < 5 ; i++)
+            {
+                n[i] = i + 1;
+            }
+
+            quantile->n_desired[0] = 1.0;
+            quantile->n_desired[1] = 1.0 + 2.0 * p;
+            quantile->n_desired[2] = 1.0 + 4.0 * p;
+            quantile->n_desired[3] = 3.0 + 2.0 * p;
+            quantile->n_desired[4] = 5.0;
+
+            quantile->n_increment[0] = 0.0;
+            quantile->n_increment[1] = 0.5 * p;
+            quantile->n_increment[2] = p;
+            quantile->n_increment[3] = 0.5 * (1.0 + p);
+            quantile->n_increment[4] = 1.0;
+        }
+
+        return;
+    }
+
+    quantile->num_values++;
+
+    // Find the cell containing the value, extending the extreme markers if necessary
+
+    if(value < q[0])
+    {
+        q[0] = value;
+        k    = 0;
+    }
+    else if(value >= q[4])
+    {
+        q[4] = value;
+        k    = 3;
+    }
+    else
+    {
+        for(k = 0 ; value >= q[k + 1] ; k++);
+    }
+
+    for(i = k + 1 ; i < 5 ; i++)
+    {
+        n[i] += 1.0;
+    }
+
+    for(i = 0 ; i < 5 ; i++)
+    {
+        quantile->n_desired[i] += quantile->n_increment[i];
+    }
+
+    // Move the middle markers that are more than one position from where they should be
+
+    for(i = 1 ; i < 4 ; i++)
+    {
+        d = quantile->n_desired[i] - n[i];
+
+        if((d >= 1.0 && n[i + 1] - n[i] > 1.0) || (d <= -1.0 && n[i - 1] - n[i] < -1.0))
+        {
+            d = d > 0.0 ? 1.0 : -1.0;
+
+            q_parabolic = q[i] + d / (n[i + 1] - n[i - 1]) *
+                          ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                           (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+
+            if(q[i - 1] < q_parabolic && q_parabolic < q[i + 1])
+            {
+                q[i] = q_parabolic;
+            }
+            else
+            {
+                k = d > 0.0 ? i + 1 : i - 1;
+
+                q[i] += d * (q[k] - q[i]) / (n[k] - n[i]);
+            }
+
+            n[i] += d;
+        }
+    }
+}
+
+
+
+static double ccMonteCarloQuantile(struct ccmc_quantile *quantile)
+{
+    int32_t     rank;
+
+    // With fewer than five values, return the exact nearest-rank quantile
+
+    if(quantile->num_values < 5)
+    {
+        rank = (int32_t)ceil(quantile->p * quantile->num_values) - 1;
+
+        return(quantile->q[rank < 0 ? 0 : rank]);
+    }
+
+    return(quantile->q[2]);
+}
+
+
+
+static void ccMonteCarloAddMetric(struct ccmc_metric *metric, double value)
+{
+    uint32_t    idx;
+
+    if(metric->num_values == 0 || value < metric->min)
+    {
+        metric->min = value;
+    }
+
+    if(metric->num_values == 0 || value > metric->max)
+    {
+        metric->max = value;
+    }
+
+    metric->num_values++;
+    metric->sum += value;
+
+    for(idx = 0 ; idx < CC_MC_NUM_QUANTILES ; idx++)
+    {
+        ccMonteCarloAddQuantile(&metric->quantile[idx], value);
+    }
+}
+
+
+
+static void ccMonteCarloAddWorst(struct ccmc_run *run)
+{
+    uint32_t    idx;
+
+    // Runs are ranked by trip and then by max abs error - a later seed must be strictly worse to rank higher
+
+    for(idx = ccmc.num_worst ; idx > 0 &&
+        (run->is_pc_tripped > ccmc.worst[idx - 1].is_pc_tripped ||
+        (run->is_pc_tripped == ccmc.worst[idx - 1].is_pc_tripped && run->max_abs_err > ccmc.worst[idx - 1].max_abs_err)) ; idx--)
+    {
+        if(idx < CC_MC_NUM_WORST)
+        {
+            ccmc.worst[idx] = ccmc.worst[idx - 1];
+        }
+    }
+
+    if(idx < CC_MC_NUM_WORST)
+    {
+        ccmc.worst[idx] = *run;
+
+        if(ccmc.num_worst < CC_MC_NUM_WORST)
+        {
+            ccmc.num_worst++;
+        }
+    }
+}
+
+
+
+static void ccMonteCarloStoreResult(struct ccsweep_result *result)
+{
+    struct ccrun_stats *stats = &result->stats;
+    struct ccmc_run     run;
+
+    run.seed = ccmc.first_seed + result->point_idx;
+
+    if(result->exit_status != EXIT_SUCCESS)
+    {
+        if(ccmc.num_failed < CC_MC_NUM_FAILED)
+        {
+            ccmc.failed_seed[ccmc.num_failed] = run.seed;
+        }
+
+        ccmc.num_failed++;
+        return;
+    }
+
+    run.is_pc_tripped = result->is_pc_tripped != 0;
+    run.max_abs_err   = stats->max_abs_err;
+    run.rms_err       = stats->num_err_samples > 0 ? sqrt(stats->sum_err2 / stats->num_err_samples) : 0.0;
+
+    ccmc.num_completed++;
+    ccmc.num_tripped     += run.is_pc_tripped;
+    ccmc.num_clipped     += (stats->num_ref_clip + stats->num_ref_rate_clip + stats->num_v_ref_clip + stats->num_v_ref_rate_clip) > 0;
+    ccmc.num_err_warning += stats->num_err_warning > 0;
+    ccmc.num_err_fault   += stats->num_err_fault > 0;
+
+    ccMonteCarloAddMetric(&ccmc.metric[0], run.max_abs_err);
+    ccMonteCarloAddMetric(&ccmc.metric[1], run.rms_err);
+    ccMonteCarloAddWorst(&run);
+}
+
+
+
+static void ccMonteCarloReport(void)
+{
+    uint32_t    metric_idx;
+    uint32_t    idx;
+
+    printf("Monte Carlo: %u completed, %u failed, %u tripped, %u clipped, %u with error warnings, %u with error faults\n",
+           ccmc.num_completed, ccmc.num_failed, ccmc.num_tripped, ccmc.num_clipped, ccmc.num_err_warning, ccmc.num_err_fault);
+
+    if(ccmc.num_completed > 0)
+    {
+        printf("%-12s %15s %15s", "METRIC", "MEAN", "MIN");
+
+        for(idx = 0 ; idx < CC_MC_NUM_QUANTILES ; idx++)
+        {
+            printf(" %15s", ccmc_quantile_names[idx]);
+        }
+
+        printf(" %15s\n", "MAX");
+
+        for(metric_idx = 0 ; metric_idx < CC_MC_NUM_METRICS ; metric_idx++)
+        {
+            struct ccmc_metric *metric = &ccmc.metric[metric_idx];
+
+            printf("%-12s %15.7E %15.7E", metric->name, metric->sum / metric->num_values, metric->min);
+
+            for(idx = 0 ; idx < CC_MC_NUM_QUANTILES ; idx++)
+            {
+                printf(" %15.7E", ccMonteCarloQuantile(&metric->quantile[idx]));
+            }
+
+            printf(" %15.7E\n", metric->max);
+        }
+
+        printf("Worst runs (MC REPLAY seed followed by RUN reproduces a run):\n");
+
+        for(idx = 0 ; idx < ccmc.num_worst ; idx++)
+        {
+            printf("  SEED %-10u TRIP %u  MAX_ABS_ERR %.7E  RMS_ERR %.7E\n",
+                   ccmc.worst[idx].seed, ccmc.worst[idx].is_pc_tripped, ccmc.worst[idx].max_abs_err, ccmc.worst[idx].rms_err);
+        }
+    }
+
+    if(ccmc.num_failed > 0)
+    {
+        printf("Failed seeds:");
+
+        for(idx = 0 ; idx < ccmc.num_failed && idx < CC_MC_NUM_FAILED ; idx++)
+        {
+            printf(" %u", ccmc.failed_seed[idx]);
+        }
+
+        printf(ccmc.num_failed > CC_MC_NUM_FAILED ? " ...\n" : "\n");
+    }
+}
+
+
+
+uint32_t ccMonteCarloRun(uint32_t num_runs, uint32_t first_seed)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will run num_runs tests with seeds first_seed, first_seed+1, ... and report the error
+  statistics, the number of runs that tripped or failed and the seeds of the worst runs.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    exit_status;
+    uint32_t    idx;
+
+    if(num_runs == 0 || num_runs > CC_MC_MAX_RUNS)
+    {
+        ccTestPrintError("invalid number of MC runs: %u (1-%u)", num_runs, CC_MC_MAX_RUNS);
+        return(EXIT_FAILURE);
+    }
+
+    if(first_seed > UINT32_MAX - (num_runs - 1))
+    {
+        ccTestPrintError("MC seeds beyond %u", UINT32_MAX);
+        return(EXIT_FAILURE);
+    }
+
+    // Reset the aggregated results
+
+    memset(&ccmc.num_completed, 0, sizeof(ccmc) - offsetof(struct ccmc, num_completed));
+
+    ccmc.first_seed     = first_seed;
+    ccmc.metric[0].name = "MAX_ABS_ERR";
+    ccmc.metric[1].name = "RMS_ERR";
+
+    for(idx = 0 ; idx < CC_MC_NUM_QUANTILES ; idx++)
+    {
+        ccmc.metric[0].quantile[idx].p = ccmc_quantiles[idx];
+        ccmc.metric[1].quantile[idx].p = ccmc_quantiles[idx];
+    }
+
+    printf("Running %u Monte Carlo runs with seeds %u to %u\n", num_runs, first_seed, first_seed + (num_runs - 1));
+
+    exit_status = ccSweepRunParallel(num_runs, ccMonteCarloInitRun, ccMonteCarloStoreResult);
+
+    ccMonteCarloReport();
+
+    return(exit_status);
+}
+
+
+
+uint32_t ccMonteCarloReplay(uint32_t seed)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will set the varied parameters and seed the random generators exactly as for the run with
+  the given seed, so that a following RUN reproduces it.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(ccMonteCarloSetPars(seed, true));
+}
+
+// EOF
@@ -36,6 +36,7 @@
 #include "ccTest.h"
 #include "ccRef.h"
 #include "ccRun.h"
+#include "ccCache.h"
 
 /*---------------------------------------------------------------------------------------------------------*/
 uint32_t ccParsGet(char *cmd_name, struct ccpars *par, char **remaining_line)
@@ -98,6 +99,17 @@ uint32_t ccParsGet(char *cmd_name, struct ccpars *par, char **remaining_line)
         }
     }
 
+    // Invalidate the pre-rendered references that could depend on the parameter
+
+    if(par->cyc_sel_step == 0 || cctest.cyc_sel == CC_ALL_CYCLES)
+    {
+        ccCacheInvalidate(0, CC_MAX_CYC_SEL);
+    }
+    else
+    {
+        ccCacheInvalidate(cyc_sel_from, cyc_sel_inc == 0 ? cyc_sel_to : CC_MAX_CYC_SEL);
+    }
+
     // Reset errno because strtod does not set it to zero on success
 
     errno = 0;
@@ -31,6 +31,23 @@
 #include "ccTest.h"
 #include "ccRun.h"
 #include "ccRef.h"
+#include "ccTable.h"
+
+// STREAM ring buffer length - short so that the ring wraps many times in a cycle
+
+#define CCREF_STREAM_BUF_LEN    8
+
+// STREAM producer state - cctest appends the TABLE points to the stream just in time
+
+static struct ccref_stream
+{
+    struct fg_stream_point       buf[CCREF_STREAM_BUF_LEN];     // Ring buffer for the stream points
+    float                       *ref;                           // TABLE reference values
+    float                       *time;                          // TABLE time values
+    uint32_t                     num_points;                    // Number of TABLE points
+    uint32_t                     point_idx;                     // Index of next TABLE point to append
+    double                       prev_time;                     // Time of previous call to ccRefStreamGen()
+} ccref_stream[CC_NUM_CYC_SELS];
 
 /*---------------------------------------------------------------------------------------------------------*/
 enum fg_gen_status ccRefDirectGen(struct fg_table *pars, const double *time, float *ref)
@@ -136,10 +153,66 @@ enum fg_gen_status ccRefDirectGen(struct fg_table *pars, const double *time, flo
     return(FG_GEN_DURING_FUNC);
 }
 /*---------------------------------------------------------------------------------------------------------*/
+static enum fg_error ccRefStreamStart(uint32_t cyc_sel)
+/*---------------------------------------------------------------------------------------------------------*\
+  This will (re)start the STREAM function for cyc_sel with the first TABLE point. The limits have already
+  been checked for the whole table by ccRefInitSTREAM(), so they are not checked again as points are appended.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccref_stream *stream = &ccref_stream[cyc_sel];
+
+    stream->point_idx = 1;
+    stream->prev_time = -1.0E30;
+
+    return(fgStreamInit(NULL,
+                        ccpars_load.pol_swi_auto,
+                        ccpars_limits.invert,
+                        ccpars_global.run_delay,
+                        conv.iter_period,
+                        stream->ref[0],
+                        stream->buf,
+                        CCREF_STREAM_BUF_LEN,
+                        &fg_stream[cyc_sel],
+                        NULL));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+enum fg_gen_status ccRefStreamGen(struct fg_stream *pars, const double *time, float *ref)
+/*---------------------------------------------------------------------------------------------------------*\
+  This plays the role of both the producer and the consumer of a STREAM function. The ring is topped up with
+  the next TABLE points before the reference is generated. The function time restarts with each cycle, so
+  if time goes backwards the stream is restarted.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t             cyc_sel = pars - fg_stream;
+    struct ccref_stream *stream  = &ccref_stream[cyc_sel];
+
+    if(*time < stream->prev_time)
+    {
+        ccRefStreamStart(cyc_sel);
+    }
+
+    stream->prev_time = *time;
+
+    // Append points until the ring is full or the table is complete
+
+    while(stream->point_idx < stream->num_points &&
+          fgStreamAppend(pars, stream->time[stream->point_idx], stream->ref[stream->point_idx]) == FG_OK)
+    {
+        stream->point_idx++;
+    }
+
+    if(stream->point_idx >= stream->num_points)
+    {
+        fgStreamEnd(pars);
+    }
+
+    return(fgStreamGen(pars, time, ref));
+}
+/*---------------------------------------------------------------------------------------------------------*/
 enum fg_error ccRefInitPLEP(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgPlepInit(  ccrun.fg_limits,
+    return(fgPlepInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -157,7 +230,7 @@ enum fg_error ccRefInitPLEP(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitRAMP(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgRampInit(  ccrun.fg_limits,
+    return(fgRampInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -173,7 +246,7 @@ enum fg_error ccRefInitRAMP(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitPPPL(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgPpplInit(  ccrun.fg_limits,
+    return(fgPpplInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -199,15 +272,29 @@ enum fg_error ccRefInitPPPL(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitTABLE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTableInit( ccrun.fg_limits,
+    float      *ref;
+    float      *time;
+    uint32_t    ref_num_els;
+    uint32_t    time_num_els;
+
+    // Use the imported table if there is one, otherwise TABLE REF and TIME
+
+    ccTableGet(cyc_sel, &ref, &ref_num_els, &time, &time_num_els);
+
+    // Use the arrays in place - an imported table can be much larger than the TABLE parameters
+
+    fg_table[cyc_sel].ref  = NULL;
+    fg_table[cyc_sel].time = NULL;
+
+    return(fgTableInit( ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
                         conv.iter_period,
-                        ccpars_table[cyc_sel].ref,
-                        table_pars[0].num_elements[cyc_sel],
-                        ccpars_table[cyc_sel].time,
-                        table_pars[1].num_elements[cyc_sel],
+                        ref,
+                        ref_num_els,
+                        time,
+                        time_num_els,
                         &fg_table[cyc_sel],
                         fg_meta));
     return(EXIT_SUCCESS);
@@ -216,7 +303,7 @@ enum fg_error ccRefInitTABLE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitSTEPS(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTestInit(  ccrun.fg_limits,
+    return(fgTestInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -233,7 +320,7 @@ enum fg_error ccRefInitSTEPS(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitSQUARE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTestInit(  ccrun.fg_limits,
+    return(fgTestInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -250,7 +337,7 @@ enum fg_error ccRefInitSQUARE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitSINE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTestInit(  ccrun.fg_limits,
+    return(fgTestInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -267,7 +354,7 @@ enum fg_error ccRefInitSINE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitCOSINE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTestInit(  ccrun.fg_limits,
+    return(fgTestInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -284,7 +371,7 @@ enum fg_error ccRefInitCOSINE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitLTRIM(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTrimInit(  ccrun.fg_limits,
+    return(fgTrimInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -299,7 +386,7 @@ enum fg_error ccRefInitLTRIM(struct fg_meta *fg_meta, uint32_t cyc_sel)
 enum fg_error ccRefInitCTRIM(struct fg_meta *fg_meta, uint32_t cyc_sel)
 /*---------------------------------------------------------------------------------------------------------*/
 {
-    return(fgTrimInit(  ccrun.fg_limits,
+    return(fgTrimInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay,
@@ -316,7 +403,7 @@ enum fg_error ccRefInitPULSE(struct fg_meta *fg_meta, uint32_t cyc_sel)
 {
     // Initialise a flat TRIM to produce the flat reference of the required duration, at the required time
 
-    return(fgTrimInit(  ccrun.fg_limits,
+    return(fgTrimInit(  ccrun.fg_limits[cyc_sel],
                         ccpars_load.pol_swi_auto,
                         ccpars_limits.invert, 
                         ccpars_global.run_delay + ccpars_pulse[cyc_sel].time,
@@ -327,5 +414,41 @@ enum fg_error ccRefInitPULSE(struct fg_meta *fg_meta, uint32_t cyc_sel)
                         &fg_pulse[cyc_sel],
                         fg_meta));
 }
+/*---------------------------------------------------------------------------------------------------------*/
+enum fg_error ccRefInitSTREAM(struct fg_meta *fg_meta, uint32_t cyc_sel)
+/*---------------------------------------------------------------------------------------------------------*\
+  STREAM streams the TABLE points through a short ring buffer. The whole table is checked by fgTableInit(),
+  which also provides the meta data, since the stream only knows the points appended so far.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccref_stream *stream = &ccref_stream[cyc_sel];
+    struct fg_table      table;
+    uint32_t             time_num_els;
+    enum fg_error        fg_error;
+
+    // Use the table arrays in place - they are only checked
+
+    table.ref  = NULL;
+    table.time = NULL;
+
+    ccTableGet(cyc_sel, &stream->ref, &stream->num_points, &stream->time, &time_num_els);
+
+    if((fg_error = fgTableInit( ccrun.fg_limits[cyc_sel],
+                                ccpars_load.pol_swi_auto,
+                                ccpars_limits.invert, 
+                                ccpars_global.run_delay,
+                                conv.iter_period,
+                                stream->ref,
+                                stream->num_points,
+                                stream->time,
+                                time_num_els,
+                                &table,
+                                fg_meta)) != FG_OK)
+    {
+        return(fg_error);
+    }
+
+    return(ccRefStreamStart(cyc_sel));
+}
 
 // EOF
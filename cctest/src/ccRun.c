@@ -35,6 +35,7 @@
 #include "ccRef.h"
 #include "ccSigs.h"
 #include "ccRun.h"
+#include "ccCache.h"
 
 /*---------------------------------------------------------------------------------------------------------*/
 static uint32_t ccRunStartFunction(double iter_time, float *ref)
@@ -222,11 +223,12 @@ static void ccDynamicEconomy(double ref_time, float ref)
 {
     static float    final_ref;
 
-    // Return immediately if running a pre-function, or a RAMP function, or time is before the start
-    // of the dynamic economy window, or the end of the dyn_eco window is beyond the end of the function
+    // Return immediately if running a pre-function, or a RAMP or STREAM function, or time is before the
+    // start of the dynamic economy window, or the end of the dyn_eco window is beyond the end of the function
 
     if(ccrun.prefunc.idx > 0                      ||
        ccrun.fgen_func == fgRampGen               ||
+       ccrun.fgen_func == ccRefStreamGen          ||
        ref_time < ccpars_global.dyn_eco_time[0]   ||
        ccpars_global.dyn_eco_time[1] > ccrun.cycle_duration)
     {
@@ -366,6 +368,83 @@ static uint32_t ccRunAbort(double iter_time)
     return(EXIT_SUCCESS);
 }
 /*---------------------------------------------------------------------------------------------------------*/
+static void ccRunStats(uint32_t reg_iteration_counter)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will accumulate the run statistics reported by the SWEEP and MC commands. The regulation error is
+  sampled when libreg calculates it, and only in iterations where libreg included it in max_abs_err.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct reg_err *err = NULL;
+
+    switch(conv.reg_mode)
+    {
+        case REG_FIELD:   err = &conv.b.err; break;
+        case REG_CURRENT: err = &conv.i.err; break;
+        default:                             break;
+    }
+
+    if(err != NULL)
+    {
+        if(ccrun.is_pc_tripped == false && conv.is_max_abs_err_enabled == true &&
+          (ccpars_global.reg_err_rate == REG_ERR_RATE_MEASUREMENT || reg_iteration_counter == 0))
+        {
+            ccrun.stats.num_err_samples++;
+            ccrun.stats.sum_err2 += (double)err->err * err->err;
+
+            if(fabs(err->err) > ccrun.stats.max_abs_err)
+            {
+                ccrun.stats.max_abs_err = fabs(err->err);
+            }
+        }
+
+        ccrun.stats.num_err_warning += err->warning.flag;
+        ccrun.stats.num_err_fault   += err->fault.flag;
+    }
+
+    ccrun.stats.num_ref_clip        += conv.b.lim_ref.flags.clip | conv.i.lim_ref.flags.clip;
+    ccrun.stats.num_ref_rate_clip   += conv.b.lim_ref.flags.rate | conv.i.lim_ref.flags.rate;
+    ccrun.stats.num_v_ref_clip      += conv.v.lim_ref.flags.clip;
+    ccrun.stats.num_v_ref_rate_clip += conv.v.lim_ref.flags.rate;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccRunEvalCheck(uint32_t cyc_sel, double ref_time, enum fg_gen_status fg_gen_status, float ref)
+/*---------------------------------------------------------------------------------------------------------*\
+  When GLOBAL EVAL_CHECK is ENABLED, this function will evaluate the function of the cycle selector at
+  ref_time with the stateless libfg Eval function and compare the status and reference with the values just
+  returned by the Gen function. Pre-functions, aborts and dynamic economy are not checked, nor are DIRECT
+  and STREAM, which have no Eval function. The values must be identical.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct fgfunc      *func = &funcs[ccpars_ref[cyc_sel].function];
+    enum fg_gen_status  eval_status;
+    float               eval_ref;
+
+    if(ccpars_global.eval_check != REG_ENABLED || func->feval_func == NULL ||
+       ccrun.fgen_pars != func->fg_pars + func->size_of_pars * cyc_sel)
+    {
+        return;
+    }
+
+    eval_status = func->feval_func(ccrun.fgen_pars, ref_time, &eval_ref);
+
+    ccrun.eval_check.num_checks++;
+
+    if(eval_status != fg_gen_status || eval_ref != ref)
+    {
+        // Keep the first difference for the report
+
+        if(ccrun.eval_check.num_errors++ == 0)
+        {
+            ccrun.eval_check.cyc_sel     = cyc_sel;
+            ccrun.eval_check.ref_time    = ref_time;
+            ccrun.eval_check.gen_ref     = ref;
+            ccrun.eval_check.eval_ref    = eval_ref;
+            ccrun.eval_check.gen_status  = fg_gen_status;
+            ccrun.eval_check.eval_status = eval_status;
+        }
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
 void ccRunSimulation(void)
 /*---------------------------------------------------------------------------------------------------------*\
   This function will run a simulation of the voltage source and load. Regulation can be disabled (VOLTAGE)
@@ -436,6 +515,14 @@ void ccRunSimulation(void)
 
                 fg_gen_status = ccrun.fgen_func(ccrun.fgen_pars, &ref_time, &ref);
 
+                // fgRampGen() follows the reference when it is clipped by the regulation, while fgRampEval()
+                // returns the initialised ramp, so RAMP can only be checked without load simulation
+
+                if(ccrun.fgen_func != fgRampGen)
+                {
+                    ccRunEvalCheck(ccrun.cyc_sel, ref_time, fg_gen_status, ref);
+                }
+
                 is_max_abs_err_enabled = ccrun.prefunc.idx == 0 && fg_gen_status == FG_GEN_DURING_FUNC;
             }
 
@@ -533,7 +620,9 @@ void ccRunSimulation(void)
             break;
         }
 
-        // Store and print to CSV file the enabled signals
+        // Accumulate run statistics, then store and print to CSV file the enabled signals
+
+        ccRunStats(reg_iteration_counter);
 
         ccSigsStore(iter_time);
 
@@ -554,6 +643,7 @@ void ccRunFuncGen(void)
     double      iter_time       = 0.0;      // Iteration time (since start of run)
     double      ref_time;                   // Reference time (since start of function)
     double      cycle_start_time;           // Cycle start time (relative to start of run)
+    struct cccache *cache;                  // Pre-rendered reference (NULL if not available)
     enum fg_gen_status fg_gen_status;       // Function generation status
 
     // Prepare to generation the first function
@@ -564,6 +654,7 @@ void ccRunFuncGen(void)
     ccrun.cycle_duration = ccpars_global.run_delay + ccrun.fg_meta[cyc_sel].duration;
     ccrun.fgen_func      = funcs[func_idx].fgen_func;
     ccrun.fgen_pars      = funcs[func_idx].fg_pars + funcs[func_idx].size_of_pars * cyc_sel;
+    cache                = ccCacheGet(cyc_sel);
 
     ccrun.cycle[0].start_time = cycle_start_time = 0.0;
 
@@ -573,9 +664,14 @@ void ccRunFuncGen(void)
     {
         ref_time = iter_time - cycle_start_time;
 
-        // Generate reference value using libfg function
+        // Read reference value from the cache if possible, otherwise generate it using libfg function
 
-        fg_gen_status = ccrun.fgen_func(ccrun.fgen_pars, &ref_time, &conv.v.ref);
+        if(cache == NULL || ccCacheRead(cache, ref_time, &conv.v.ref, &fg_gen_status) == false)
+        {
+            fg_gen_status = ccrun.fgen_func(ccrun.fgen_pars, &ref_time, &conv.v.ref);
+
+            ccRunEvalCheck(cyc_sel, ref_time, fg_gen_status, conv.v.ref);
+        }
 
         // If reference function has finished
 
@@ -596,6 +692,7 @@ void ccRunFuncGen(void)
                     ccrun.cycle_duration = ccpars_global.run_delay + ccrun.fg_meta[cyc_sel].duration;
                     ccrun.fgen_func      = funcs[func_idx].fgen_func;
                     ccrun.fgen_pars      = funcs[func_idx].fg_pars + funcs[func_idx].size_of_pars * cyc_sel;
+                    cache                = ccCacheGet(cyc_sel);
 
                     ccrun.cycle[ccrun.cycle_idx].start_time = cycle_start_time = iter_time + ccpars_default.plateau_duration;
                 }
@@ -660,4 +757,35 @@ void ccRunFuncGenReverseTime(void)
         ccSigsStore(iter_time);
     }
 }
+/*---------------------------------------------------------------------------------------------------------*/
+uint32_t ccRunEvalCheckReport(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will report the result of the comparison of the libfg Eval and Gen functions if GLOBAL
+  EVAL_CHECK is ENABLED. It returns EXIT_FAILURE if they differed in any iteration.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccrun_eval_check *eval_check = &ccrun.eval_check;
+
+    if(ccpars_global.eval_check != REG_ENABLED)
+    {
+        return(EXIT_SUCCESS);
+    }
+
+    printf("Eval check : %u iterations checked : %u differences\n", eval_check->num_checks, eval_check->num_errors);
+
+    if(eval_check->num_errors > 0)
+    {
+        ccTestPrintError("%s(%u) Eval differs from Gen at time %.6f : ref %.7E/%.7E : status %d/%d",
+                ccParsEnumString(enum_function_type, ccpars_ref[eval_check->cyc_sel].function),
+                eval_check->cyc_sel,
+                eval_check->ref_time,
+                eval_check->eval_ref,
+                eval_check->gen_ref,
+                eval_check->eval_status,
+                eval_check->gen_status);
+        return(EXIT_FAILURE);
+    }
+
+    return(EXIT_SUCCESS);
+}
 // EOF
@@ -22,14 +22,46 @@
 \*---------------------------------------------------------------------------------------------------------*/
 
 #include <stdio.h>
+#include <pthread.h>
 
 #include "ccCmds.h"
 #include "ccTest.h"
 #include "ccRun.h"
 #include "ccSigs.h"
 #include "ccFlot.h"
+#include "ccFmt.h"
 
-static float    dig_offset;      // Offset to stack digital signals for FGCSPY and LVDV output formats
+// Constants
+
+#define CCSIGS_BLOCK_ROWS       4096            // Number of iterations per CSV output block
+
+// CSV output block - the simulation fills one block while the writer thread formats and writes the other
+
+struct ccsigs_block
+{
+    uint32_t                    num_rows;                                   // Number of rows in the block
+    uint32_t                    is_full;                                    // Block is waiting for the writer thread
+    double                      time        [CCSIGS_BLOCK_ROWS];            // Iteration time
+    char                       *cursor_label[CCSIGS_BLOCK_ROWS];            // Label for CSR_FUNC (the only cursor signal)
+    float                       value       [CCSIGS_BLOCK_ROWS][NUM_SIGNALS];   // Signal values
+};
+
+// CSV writer thread
+
+struct ccsigs_writer
+{
+    pthread_t                   thread;                 // Writer thread
+    pthread_mutex_t             mutex;                  // Protects is_full and stop
+    pthread_cond_t              cond;                   // Signalled when is_full or stop changes
+    uint32_t                    is_running;             // Writer thread was started
+    uint32_t                    stop;                   // Writer thread should stop when all blocks are written
+    uint32_t                    fill_idx;               // Index of the block being filled by the simulation
+    struct ccsigs_block         block[2];               // Double buffered output blocks
+};
+
+static float                dig_offset;     // Offset to stack digital signals for FGCSPY and LVDV output formats
+static struct ccfmt_out     csv_out;        // CSV output buffer (used by the writer thread during a run)
+static struct ccsigs_writer csv_writer;     // CSV writer thread and output blocks
 
 /*---------------------------------------------------------------------------------------------------------*/
 void ccSigsEnableSignal(enum ccsig_idx idx)
@@ -157,6 +189,161 @@ void ccSigsStoreCursor(enum ccsig_idx idx, char *cursor_label)
     signals[idx].cursor_label = cursor_label;
 }
 /*---------------------------------------------------------------------------------------------------------*/
+static void ccSigsWriteBlock(struct ccsigs_block *block)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will format the rows of a block into the CSV output buffer.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    row;
+    uint32_t    idx;
+
+    for(row = 0 ; row < block->num_rows ; row++)
+    {
+        // Print the timestamp first with microsecond resolution ("%.6f")
+
+        ccFmtOutFixed(&csv_out, block->time[row], 6);
+
+        // Print enabled signal values
+
+        for(idx = 0 ; idx < NUM_SIGNALS ; idx++)
+        {
+            if(signals[idx].control == REG_ENABLED)
+            {
+                ccFmtOutChar(&csv_out, ',');
+
+                switch(signals[idx].type)
+                {
+                case ANALOG:                        // "%.7E"
+
+                    ccFmtOutExp(&csv_out, block->value[row][idx], 7);
+                    break;
+
+                case DIGITAL:                       // "%.1f"
+
+                    ccFmtOutFixed(&csv_out, block->value[row][idx], 1);
+                    break;
+
+                case CURSOR:
+
+                    if(block->cursor_label[row] != NULL)
+                    {
+                        ccFmtOutString(&csv_out, block->cursor_label[row]);
+                    }
+                    break;
+                }
+            }
+        }
+
+        ccFmtOutChar(&csv_out, '\n');
+    }
+
+    block->num_rows = 0;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void * ccSigsWriter(void *arg)
+/*---------------------------------------------------------------------------------------------------------*\
+  This is the CSV writer thread. It writes the blocks in the order that they are filled by the simulation
+  and returns when stop is set and no full block remains.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t             write_idx = 0;
+    uint32_t             is_full;
+    struct ccsigs_block *block;
+
+    for(;;)
+    {
+        block = &csv_writer.block[write_idx];
+
+        // Wait for the next block to be full
+
+        pthread_mutex_lock(&csv_writer.mutex);
+
+        while(!block->is_full && !csv_writer.stop)
+        {
+            pthread_cond_wait(&csv_writer.cond, &csv_writer.mutex);
+        }
+
+        is_full = block->is_full;
+
+        pthread_mutex_unlock(&csv_writer.mutex);
+
+        // Blocks are always submitted before stop is set, so if this block is not full then all are written
+
+        if(!is_full)
+        {
+            break;
+        }
+
+        ccSigsWriteBlock(block);
+
+        // Return the block to the simulation
+
+        pthread_mutex_lock(&csv_writer.mutex);
+        block->is_full = 0;
+        pthread_cond_broadcast(&csv_writer.cond);
+        pthread_mutex_unlock(&csv_writer.mutex);
+
+        write_idx ^= 1;
+    }
+
+    return(NULL);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccSigsStartWriter(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will start the CSV writer thread. If the thread cannot be started then each block is
+  written by the simulation thread when it is submitted.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    csv_writer.block[0].num_rows = csv_writer.block[1].num_rows = 0;
+    csv_writer.block[0].is_full  = csv_writer.block[1].is_full  = 0;
+    csv_writer.fill_idx          = 0;
+    csv_writer.stop              = 0;
+
+    pthread_mutex_init(&csv_writer.mutex, NULL);
+    pthread_cond_init (&csv_writer.cond,  NULL);
+
+    csv_writer.is_running = (pthread_create(&csv_writer.thread, NULL, ccSigsWriter, NULL) == 0);
+
+    if(!csv_writer.is_running)
+    {
+        fputs("Warning: Unable to start CSV writer thread - CSV output will be written synchronously\n",stderr);
+
+        pthread_cond_destroy(&csv_writer.cond);
+        pthread_mutex_destroy(&csv_writer.mutex);
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void ccSigsSubmitBlock(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will pass the block being filled to the writer thread and switch to the other block,
+  waiting if the writer thread has not finished writing it.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct ccsigs_block *block = &csv_writer.block[csv_writer.fill_idx];
+
+    if(!csv_writer.is_running)
+    {
+        ccSigsWriteBlock(block);
+        return;
+    }
+
+    pthread_mutex_lock(&csv_writer.mutex);
+
+    block->is_full = 1;
+    pthread_cond_broadcast(&csv_writer.cond);
+
+    csv_writer.fill_idx ^= 1;
+    block = &csv_writer.block[csv_writer.fill_idx];
+
+    while(block->is_full)
+    {
+        pthread_cond_wait(&csv_writer.cond, &csv_writer.mutex);
+    }
+
+    pthread_mutex_unlock(&csv_writer.mutex);
+}
+/*---------------------------------------------------------------------------------------------------------*/
 void ccSigsInit(void)
 /*---------------------------------------------------------------------------------------------------------*\
   This function will enable the signals that need to be stored according to the mode(s) of the run.
@@ -424,6 +611,11 @@ void ccSigsInit(void)
         }
 
         fputc('\n',cctest.csv_file);
+
+        // Data rows are formatted into the CSV output buffer by the writer thread
+
+        ccFmtOutInit(&csv_out, cctest.csv_file);
+        ccSigsStartWriter();
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
@@ -563,6 +755,10 @@ void ccSigsStore(double time)
         ccSigsStoreDigital(DIG_INVALID_MEAS,   ccrun.invalid_meas.flag);
     }
 
+    // Add analog values to the FLOT min/max pyramid if it is in use
+
+    ccFlotMipStore(time);
+
     // Increment FLOT data index, but clip to max number of FLOT points
 
     if(flot_index < ccpars_global.flot_points_max)
@@ -570,49 +766,69 @@ void ccSigsStore(double time)
         flot_index++;
     }
 
-    // If CSV output is enabled, write data to CSV file
+    // If CSV output is enabled, add the values to the current output block
 
     if(ccpars_global.csv_format != CC_NONE)
     {
-        uint32_t idx;
+        struct ccsigs_block *block = &csv_writer.block[csv_writer.fill_idx];
+        uint32_t             row   = block->num_rows;
+        uint32_t             idx;
 
-        // Print the timestamp first with microsecond resolution
-
-        fprintf(cctest.csv_file,"%.6f",time);
-
-        // Print enabled signal values
+        block->time[row]         = time;
+        block->cursor_label[row] = NULL;
 
         for(idx = 0 ; idx < NUM_SIGNALS ; idx++)
         {
             if(signals[idx].control == REG_ENABLED)
             {
-                fputc(',',cctest.csv_file);
-
-                switch(signals[idx].type)
+                if(signals[idx].type == CURSOR)     // Cursor values - clear cursor label after storing
+                {
+                    block->cursor_label[row]  = signals[idx].cursor_label;
+                    signals[idx].cursor_label = NULL;
+                }
+                else
                 {
-                case ANALOG:
+                    block->value[row][idx] = signals[idx].value;
+                }
+            }
+        }
 
-                    fprintf(cctest.csv_file,"%.7E",signals[idx].value);
-                    break;
+        if(++block->num_rows == CCSIGS_BLOCK_ROWS)
+        {
+            ccSigsSubmitBlock();
+        }
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void ccSigsFlush(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will submit the last partially filled block and wait for the writer thread to write all
+  the blocks, in order, to the CSV file. It must be called at the end of the run, before the file is closed.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    if(ccpars_global.csv_format != CC_NONE)
+    {
+        if(csv_writer.block[csv_writer.fill_idx].num_rows > 0)
+        {
+            ccSigsSubmitBlock();
+        }
 
-                case DIGITAL:
+        if(csv_writer.is_running)
+        {
+            pthread_mutex_lock(&csv_writer.mutex);
+            csv_writer.stop = 1;
+            pthread_cond_broadcast(&csv_writer.cond);
+            pthread_mutex_unlock(&csv_writer.mutex);
 
-                    fprintf(cctest.csv_file,"%.1f",signals[idx].value);
-                    break;
+            pthread_join(csv_writer.thread, NULL);
 
-                case CURSOR:        // Cursor values - clear cursor label after printing
+            pthread_cond_destroy(&csv_writer.cond);
+            pthread_mutex_destroy(&csv_writer.mutex);
 
-                    if(signals[idx].cursor_label != NULL)
-                    {
-                        fputs(signals[idx].cursor_label, cctest.csv_file);
-                        signals[idx].cursor_label = NULL;
-                    }
-                    break;
-                }
-            }
+            csv_writer.is_running = 0;
         }
 
-        fputc('\n',cctest.csv_file);
+        ccFmtOutFlush(&csv_out);
     }
 }
 
@@ -0,0 +1,851 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccSweep.c                                                                   Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  cctest parallel parameter sweep functions
+
+  Notes:    All cctest state is global, so each point of a sweep is run in a worker process forked from
+            cctest. The worker starts with a copy of the current parameters, sets the swept parameters for
+            its point, runs the test and returns the results to cctest through a pipe. The results
+            are therefore independent of the number of workers and of the order in which they finish.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#ifndef __MINGW32__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#endif
+
+#include "ccCmds.h"
+#include "ccTest.h"
+#include "ccRun.h"
+#include "ccSweep.h"
+
+// Results are passed to store_result() in point order through a reorder window
+
+#define CC_SWEEP_REORDER_LEN    (4 * CC_SWEEP_MAX_WORKERS)
+
+// Swept parameter
+
+struct ccsweep_axis
+{
+    uint32_t                    cmd_idx;                // Command index of the parameter
+    struct ccpars              *par;                    // Parameter
+    uint32_t                    cyc_sel;                // Cycle selector (or CC_NO_INDEX)
+    uint32_t                    array_idx;              // Array index (or CC_NO_INDEX)
+    uint32_t                    num_values;             // Number of values
+    char                      **values;                 // Values as strings
+};
+
+// Sweep definition and results
+
+static struct ccsweep
+{
+    uint32_t                    num_axes;               // Number of swept parameters
+    struct ccsweep_axis         axis[CC_SWEEP_MAX_AXES];// Swept parameters - the last axis changes fastest
+    struct ccsweep_result      *results;                // Results for every point
+} ccsweep;
+
+// Results waiting to be passed to store_result() in point order
+
+static struct ccsweep_reorder
+{
+    uint32_t                    next_point;                             // Next point to be stored
+    uint32_t                    is_valid[CC_SWEEP_REORDER_LEN];         // Result slot is waiting to be stored
+    struct ccsweep_result       result[CC_SWEEP_REORDER_LEN];           // Results indexed by point modulo length
+} ccsweep_reorder;
+
+
+
+static void ccSweepAxisName(char *name, size_t len, struct ccsweep_axis *axis)
+{
+    int n = snprintf(name, len, "%s_%s", cmds[axis->cmd_idx].name, axis->par->name);
+
+    if(axis->cyc_sel != CC_NO_INDEX && n < (int)len)
+    {
+        n += snprintf(name + n, len - n, "(%u)", axis->cyc_sel);
+    }
+
+    if(axis->array_idx != CC_NO_INDEX && n < (int)len)
+    {
+        snprintf(name + n, len - n, "[%u]", axis->array_idx);
+    }
+}
+
+
+
+static uint32_t ccSweepAddValue(struct ccsweep_axis *axis, char *value)
+{
+    char      **values;
+
+    if(strlen(value) >= CC_SWEEP_MAX_VALUE_LEN)
+    {
+        ccTestPrintError("invalid value length for SWEEP: '%s' (%u max)",
+                         ccTestAbbreviatedArg(value), CC_SWEEP_MAX_VALUE_LEN - 1);
+        return(EXIT_FAILURE);
+    }
+
+    if(axis->num_values >= CC_SWEEP_MAX_POINTS)
+    {
+        ccTestPrintError("too many values for SWEEP %s %s (%u max)",
+                         cmds[axis->cmd_idx].name, axis->par->name, CC_SWEEP_MAX_POINTS);
+        return(EXIT_FAILURE);
+    }
+
+    // The old array is kept if realloc fails, so ccSweepFreeAxis() can still free the values already added
+
+    values = realloc(axis->values, (axis->num_values + 1) * sizeof(char *));
+
+    if(values == NULL)
+    {
+        ccTestPrintError("allocating memory for SWEEP value '%s'", ccTestAbbreviatedArg(value));
+        return(EXIT_FAILURE);
+    }
+
+    axis->values = values;
+
+    if((axis->values[axis->num_values] = malloc(strlen(value) + 1)) == NULL)
+    {
+        ccTestPrintError("allocating memory for SWEEP value '%s'", ccTestAbbreviatedArg(value));
+        return(EXIT_FAILURE);
+    }
+
+    strcpy(axis->values[axis->num_values++], value);
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static uint32_t ccSweepAddRange(struct ccsweep_axis *axis, char *arg)
+{
+    double      from;
+    double      to;
+    double      step;
+    double      num_steps;
+    uint32_t    idx;
+    char        value[CC_SWEEP_MAX_VALUE_LEN];
+    char       *remaining_arg;
+
+    // Range format is from:to:step
+
+    errno = 0;
+
+    from = strtod(arg, &remaining_arg);
+
+    if(*remaining_arg == ':')
+    {
+        to = strtod(remaining_arg + 1, &remaining_arg);
+
+        if(*remaining_arg == ':')
+        {
+            step = strtod(remaining_arg + 1, &remaining_arg);
+
+            if(*remaining_arg == '\0' && errno == 0 && step != 0.0 && (to - from) / step >= 0.0)
+            {
+                num_steps = floor((to - from) / step + 1.0E-6);
+
+                if(num_steps >= CC_SWEEP_MAX_POINTS)
+                {
+                    ccTestPrintError("too many values in SWEEP range '%s' (%u max)", arg, CC_SWEEP_MAX_POINTS);
+                    return(EXIT_FAILURE);
+                }
+
+                for(idx = 0 ; idx <= (uint32_t)num_steps ; idx++)
+                {
+                    snprintf(value, CC_SWEEP_MAX_VALUE_LEN, "%.7g", from + idx * step);
+
+                    if(ccSweepAddValue(axis, value) == EXIT_FAILURE)
+                    {
+                        return(EXIT_FAILURE);
+                    }
+                }
+
+                return(EXIT_SUCCESS);
+            }
+        }
+    }
+
+    ccTestPrintError("invalid SWEEP range '%s' (from:to:step expected)", ccTestAbbreviatedArg(arg));
+    return(EXIT_FAILURE);
+}
+
+
+
+static void ccSweepFreeAxis(struct ccsweep_axis *axis)
+{
+    uint32_t    idx;
+
+    for(idx = 0 ; idx < axis->num_values ; idx++)
+    {
+        free(axis->values[idx]);
+    }
+
+    free(axis->values);
+
+    axis->values     = NULL;
+    axis->num_values = 0;
+}
+
+
+
+uint32_t ccSweepAddAxis(uint32_t cmd_idx, struct ccpars *par, char **remaining_line)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will add a swept parameter with the values remaining on the line. Each value can be a
+  single value or a range in the form from:to:step (for FLOAT and UNSIGNED parameters). The parameter's
+  cycle selector and array index must be in cctest.cyc_sel and cctest.array_idx. If the parameter is
+  already being swept then its values are replaced.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t             axis_idx;
+    char                *arg;
+    struct ccsweep_axis  new_axis;
+    struct ccsweep_axis *axis;
+
+    if(par->type == PAR_STRING)
+    {
+        ccTestPrintError("STRING parameter %s %s cannot be swept", cmds[cmd_idx].name, par->name);
+        return(EXIT_FAILURE);
+    }
+
+    if(*remaining_line == NULL)
+    {
+        ccTestPrintError("no values for SWEEP %s %s", cmds[cmd_idx].name, par->name);
+        return(EXIT_FAILURE);
+    }
+
+    memset(&new_axis, 0, sizeof(new_axis));
+
+    new_axis.cmd_idx   = cmd_idx;
+    new_axis.par       = par;
+    new_axis.cyc_sel   = cctest.cyc_sel;
+    new_axis.array_idx = cctest.array_idx;
+
+    // Collect the values
+
+    while((arg = ccTestGetArgument(remaining_line)) != NULL)
+    {
+        uint32_t exit_status;
+
+        if(strchr(arg, ':') != NULL)
+        {
+            if(par->type == PAR_ENUM)
+            {
+                ccTestPrintError("ranges are not supported for ENUM parameter %s %s", cmds[cmd_idx].name, par->name);
+                exit_status = EXIT_FAILURE;
+            }
+            else
+            {
+                exit_status = ccSweepAddRange(&new_axis, arg);
+            }
+        }
+        else
+        {
+            exit_status = ccSweepAddValue(&new_axis, arg);
+        }
+
+        if(exit_status == EXIT_FAILURE)
+        {
+            ccSweepFreeAxis(&new_axis);
+            return(EXIT_FAILURE);
+        }
+    }
+
+    // Replace an existing axis for the same parameter element or add a new axis
+
+    for(axis_idx = 0, axis = ccsweep.axis ; axis_idx < ccsweep.num_axes ; axis_idx++, axis++)
+    {
+        if(axis->par == par && axis->cyc_sel == new_axis.cyc_sel && axis->array_idx == new_axis.array_idx)
+        {
+            ccSweepFreeAxis(axis);
+            break;
+        }
+    }
+
+    if(axis_idx >= CC_SWEEP_MAX_AXES)
+    {
+        ccTestPrintError("too many SWEEP parameters (%u max)", CC_SWEEP_MAX_AXES);
+        ccSweepFreeAxis(&new_axis);
+        return(EXIT_FAILURE);
+    }
+
+    *axis = new_axis;
+
+    if(axis_idx == ccsweep.num_axes)
+    {
+        ccsweep.num_axes++;
+    }
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+void ccSweepReset(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will clear all the swept parameters.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    while(ccsweep.num_axes > 0)
+    {
+        ccSweepFreeAxis(&ccsweep.axis[--ccsweep.num_axes]);
+    }
+}
+
+
+
+static uint32_t ccSweepNumPoints(void)
+{
+    uint32_t    axis_idx;
+    uint64_t    num_points = ccsweep.num_axes > 0;
+
+    for(axis_idx = 0 ; axis_idx < ccsweep.num_axes && num_points <= CC_SWEEP_MAX_POINTS ; axis_idx++)
+    {
+        num_points *= ccsweep.axis[axis_idx].num_values;
+    }
+
+    return(num_points <= CC_SWEEP_MAX_POINTS ? (uint32_t)num_points : CC_SWEEP_MAX_POINTS + 1);
+}
+
+
+
+void ccSweepPrint(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will print the swept parameters and their values.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    axis_idx;
+    uint32_t    idx;
+    char        name[CC_PATH_LEN];
+
+    for(axis_idx = 0 ; axis_idx < ccsweep.num_axes ; axis_idx++)
+    {
+        struct ccsweep_axis *axis = &ccsweep.axis[axis_idx];
+
+        ccSweepAxisName(name, sizeof(name), axis);
+
+        printf("%-*s %-*s", CC_MAX_CMD_NAME_LEN, "SWEEP", CC_MAX_PAR_NAME_LEN - CC_MAX_CMD_NAME_LEN - 1, name);
+
+        for(idx = 0 ; idx < axis->num_values ; idx++)
+        {
+            printf(" %s", axis->values[idx]);
+        }
+
+        putchar('\n');
+    }
+
+    printf("%-*s %u points\n", CC_MAX_CMD_NAME_LEN, "SWEEP", ccsweep.num_axes > 0 ? ccSweepNumPoints() : 0);
+}
+
+
+
+static uint32_t ccSweepValueIdx(uint32_t point_idx, uint32_t axis_idx)
+{
+    uint32_t    idx;
+
+    // The last axis changes fastest
+
+    for(idx = ccsweep.num_axes - 1 ; idx > axis_idx ; idx--)
+    {
+        point_idx /= ccsweep.axis[idx].num_values;
+    }
+
+    return(point_idx % ccsweep.axis[axis_idx].num_values);
+}
+
+
+
+static uint32_t ccSweepInitPoint(uint32_t point_idx)
+{
+    uint32_t    axis_idx;
+    char        value[CC_SWEEP_MAX_VALUE_LEN];
+    char       *remaining_line;
+
+    // Set every swept parameter to its value for this point
+
+    for(axis_idx = 0 ; axis_idx < ccsweep.num_axes ; axis_idx++)
+    {
+        struct ccsweep_axis *axis = &ccsweep.axis[axis_idx];
+
+        remaining_line   = strcpy(value, axis->values[ccSweepValueIdx(point_idx, axis_idx)]);
+        cctest.cyc_sel   = axis->cyc_sel;
+        cctest.array_idx = axis->array_idx;
+
+        if(ccParsGet(cmds[axis->cmd_idx].name, axis->par, &remaining_line) == EXIT_FAILURE)
+        {
+            return(EXIT_FAILURE);
+        }
+    }
+
+    cctest.cyc_sel   = CC_NO_INDEX;
+    cctest.array_idx = CC_NO_INDEX;
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static void ccSweepStoreResult(struct ccsweep_result *result)
+{
+    ccsweep.results[result->point_idx] = *result;
+}
+
+
+
+static uint32_t ccSweepWriteResults(FILE *f, uint32_t num_points)
+{
+    uint32_t    point_idx;
+    uint32_t    axis_idx;
+    char        name[CC_PATH_LEN];
+
+    fputs("POINT", f);
+
+    for(axis_idx = 0 ; axis_idx < ccsweep.num_axes ; axis_idx++)
+    {
+        ccSweepAxisName(name, sizeof(name), &ccsweep.axis[axis_idx]);
+        fprintf(f, ",%s", name);
+    }
+
+    fputs(",STATUS,TRIP,MAX_ABS_ERR,RMS_ERR,REF_CLIP,REF_RATE_CLIP,V_REF_CLIP,V_REF_RATE_CLIP,"
+          "ERR_WARNING,ERR_FAULT,MODULUS_MARGIN\n", f);
+
+    for(point_idx = 0 ; point_idx < num_points ; point_idx++)
+    {
+        struct ccsweep_result *result = &ccsweep.results[point_idx];
+
+        fprintf(f, "%u", point_idx);
+
+        for(axis_idx = 0 ; axis_idx < ccsweep.num_axes ; axis_idx++)
+        {
+            fprintf(f, ",%s", ccsweep.axis[axis_idx].values[ccSweepValueIdx(point_idx, axis_idx)]);
+        }
+
+        fprintf(f, ",%s,%u,%.7E,%.7E,%u,%u,%u,%u,%u,%u,%.7E\n",
+                result->exit_status == EXIT_SUCCESS ? "OK" : "FAIL",
+                result->is_pc_tripped,
+                result->stats.max_abs_err,
+                result->stats.num_err_samples > 0 ? sqrt(result->stats.sum_err2 / result->stats.num_err_samples) : 0.0,
+                result->stats.num_ref_clip,
+                result->stats.num_ref_rate_clip,
+                result->stats.num_v_ref_clip,
+                result->stats.num_v_ref_rate_clip,
+                result->stats.num_err_warning,
+                result->stats.num_err_fault,
+                result->modulus_margin);
+    }
+
+    return(ferror(f) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+
+uint32_t ccSweepRun(void)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will run the test for every point of the sweep grid and write a table of results to
+  results/sweep/{GROUP}/{PROJECT}/{FILE}.csv.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    num_points;
+    uint32_t    num_failed = 0;
+    uint32_t    best_idx   = CC_SWEEP_MAX_POINTS;
+    uint32_t    point_idx;
+    uint32_t    axis_idx;
+    uint32_t    exit_status;
+    char        name[CC_PATH_LEN];
+    char        sweep_path[CC_PATH_LEN];
+    char        sweep_filename[CC_PATH_LEN];
+    char       *filename;
+    FILE       *f;
+
+    if(ccsweep.num_axes == 0)
+    {
+        ccTestPrintError("no SWEEP parameters defined");
+        return(EXIT_FAILURE);
+    }
+
+    num_points = ccSweepNumPoints();
+
+    if(num_points > CC_SWEEP_MAX_POINTS)
+    {
+        ccTestPrintError("too many SWEEP points (%u max)", CC_SWEEP_MAX_POINTS);
+        return(EXIT_FAILURE);
+    }
+
+    // Prepare the results file
+
+    filename = strcmp(ccpars_global.file, "*") != 0 ? ccpars_global.file : cctest.input[cctest.input_idx].path;
+
+    if(snprintf(sweep_path, CC_PATH_LEN, "%s/results/sweep/%s/%s",
+                cctest.base_path,
+                ccpars_global.group,
+                ccpars_global.project) >= CC_PATH_LEN ||
+       snprintf(sweep_filename, CC_PATH_LEN, "%s/%s.csv", sweep_path, filename) >= CC_PATH_LEN)
+    {
+        ccTestPrintError("SWEEP results file path too long for '%s'", filename);
+        return(EXIT_FAILURE);
+    }
+
+    if(ccTestMakePath(sweep_path) == EXIT_FAILURE)
+    {
+        return(EXIT_FAILURE);
+    }
+
+    f = fopen(sweep_filename, "w");
+
+    if(f == NULL)
+    {
+         ccTestPrintError("opening file '%s' : %s (%d)", sweep_filename, strerror(errno), errno);
+         return(EXIT_FAILURE);
+    }
+
+    // Run all the points
+
+    printf("Running sweep of %u points to %s/%s/%s\n", num_points, ccpars_global.group, ccpars_global.project, filename);
+
+    ccsweep.results = calloc(num_points, sizeof(struct ccsweep_result));
+
+    if(ccsweep.results == NULL)
+    {
+        ccTestPrintError("allocating SWEEP results for %u points", num_points);
+        fclose(f);
+        return(EXIT_FAILURE);
+    }
+
+    exit_status = ccSweepRunParallel(num_points, ccSweepInitPoint, ccSweepStoreResult);
+
+    if(exit_status == EXIT_SUCCESS)
+    {
+        exit_status = ccSweepWriteResults(f, num_points);
+
+        // Report the number of failed points and the point with the smallest max abs error without a trip
+
+        for(point_idx = 0 ; point_idx < num_points ; point_idx++)
+        {
+            struct ccsweep_result *result = &ccsweep.results[point_idx];
+
+            if(result->exit_status != EXIT_SUCCESS)
+            {
+                num_failed++;
+            }
+            else if(result->is_pc_tripped == 0 &&
+                   (best_idx == CC_SWEEP_MAX_POINTS || result->stats.max_abs_err < ccsweep.results[best_idx].stats.max_abs_err))
+            {
+                best_idx = point_idx;
+            }
+        }
+
+        if(num_failed > 0)
+        {
+            printf("Sweep: %u of %u points failed\n", num_failed, num_points);
+        }
+
+        if(best_idx != CC_SWEEP_MAX_POINTS)
+        {
+            printf("Sweep: smallest MAX_ABS_ERR %.7E at point %u:", ccsweep.results[best_idx].stats.max_abs_err, best_idx);
+
+            for(axis_idx = 0 ; axis_idx < ccsweep.num_axes ; axis_idx++)
+            {
+                struct ccsweep_axis *axis = &ccsweep.axis[axis_idx];
+
+                ccSweepAxisName(name, sizeof(name), axis);
+
+                printf(" %s=%s", name, axis->values[ccSweepValueIdx(best_idx, axis_idx)]);
+            }
+
+            putchar('\n');
+        }
+    }
+
+    free(ccsweep.results);
+    ccsweep.results = NULL;
+
+    fclose(f);
+
+    return(exit_status);
+}
+
+
+
+#ifndef __MINGW32__
+static void ccSweepWorker(uint32_t point_idx, uint32_t (*init_point)(uint32_t point_idx), int fd)
+{
+    struct ccsweep_result   result;
+    char                   *no_args = NULL;
+    static char             file[CC_PATH_LEN];
+
+    // Worker output to stdout is discarded
+
+    if(freopen("/dev/null", "w", stdout) == NULL)
+    {
+        _exit(EXIT_FAILURE);
+    }
+
+    // Disable per-run output unless WORKER_OUTPUT is ENABLED, in which case suffix the point index to FILE
+
+    if(ccpars_global.worker_output == REG_DISABLED)
+    {
+        ccpars_global.csv_format   = CC_NONE;
+        ccpars_global.flot_output  = REG_DISABLED;
+        ccpars_global.debug_output = REG_DISABLED;
+    }
+    else
+    {
+        snprintf(file, CC_PATH_LEN, "%s_%u",
+                 strcmp(ccpars_global.file, "*") != 0 ? ccpars_global.file : cctest.input[cctest.input_idx].path,
+                 point_idx);
+
+        ccpars_global.file = file;
+    }
+
+    // Set the parameters for this point and run the test
+
+    memset(&result, 0, sizeof(result));
+
+    result.point_idx   = point_idx;
+    result.exit_status = init_point(point_idx);
+
+    if(result.exit_status == EXIT_SUCCESS)
+    {
+        result.exit_status = ccCmdsRun(CMD_RUN, &no_args);
+    }
+
+    result.is_pc_tripped = ccrun.is_pc_tripped;
+    result.stats         = ccrun.stats;
+
+    if(ccrun.is_ireg_enabled == true)
+    {
+        result.modulus_margin = conv.i.last_op_rst_pars.modulus_margin;
+    }
+    else if(ccrun.is_breg_enabled == true)
+    {
+        result.modulus_margin = conv.b.last_op_rst_pars.modulus_margin;
+    }
+
+    // Return the result - the record is smaller than PIPE_BUF so the write is atomic
+
+    fflush(NULL);
+
+    _exit(write(fd, &result, sizeof(result)) == sizeof(result) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+static void ccSweepReorderResult(struct ccsweep_result *result, void (*store_result)(struct ccsweep_result *result))
+{
+    uint32_t    slot = result->point_idx % CC_SWEEP_REORDER_LEN;
+
+    ccsweep_reorder.result[slot]   = *result;
+    ccsweep_reorder.is_valid[slot] = 1;
+
+    // Store all the results that are now in sequence
+
+    while(ccsweep_reorder.is_valid[slot = ccsweep_reorder.next_point % CC_SWEEP_REORDER_LEN] != 0)
+    {
+        store_result(&ccsweep_reorder.result[slot]);
+
+        ccsweep_reorder.is_valid[slot] = 0;
+        ccsweep_reorder.next_point++;
+    }
+}
+#endif
+
+
+
+uint32_t ccSweepRunParallel(uint32_t num_points,
+                            uint32_t (*init_point)(uint32_t point_idx),
+                            void (*store_result)(struct ccsweep_result *result))
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will run num_points tests using up to GLOBAL NUM_WORKERS worker processes (one per CPU if
+  zero). Each worker calls init_point() to set the parameters for its point before running the test.
+  store_result() is called in cctest for each point in point order, so results can be aggregated
+  deterministically. A worker is not started more than CC_SWEEP_REORDER_LEN points ahead of the oldest
+  result still awaited, which bounds the results held back. If a worker dies, the result for its point
+  is returned with exit_status EXIT_FAILURE.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+#ifdef __MINGW32__
+    ccTestPrintError("worker processes are not supported on Windows");
+    return(EXIT_FAILURE);
+#else
+    struct ccsweep_worker
+    {
+        pid_t                   pid;                    // Worker process ID (0 if slot is free)
+        uint32_t                point_idx;              // Point being run by the worker
+        uint32_t                is_result_received;     // Result has been read from the pipe
+    } worker[CC_SWEEP_MAX_WORKERS];
+
+    struct ccsweep_result   result;
+    uint32_t                num_workers = ccpars_global.num_workers;
+    uint32_t                num_active  = 0;
+    uint32_t                num_done    = 0;
+    uint32_t                next_point  = 0;
+    uint32_t                worker_idx;
+    int                     fd[2];
+    int                     status;
+    pid_t                   pid;
+    struct timespec         start;
+    struct timespec         end;
+
+    // Default to one worker per CPU
+
+    if(num_workers == 0)
+    {
+        long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        num_workers = num_cpus > 0 ? (uint32_t)num_cpus : 1;
+    }
+
+    if(num_workers > CC_SWEEP_MAX_WORKERS)
+    {
+        num_workers = CC_SWEEP_MAX_WORKERS;
+    }
+
+    if(num_workers > num_points)
+    {
+        num_workers = num_points;
+    }
+
+    // Workers return results through a pipe that is read without blocking
+
+    if(pipe(fd) != 0 || fcntl(fd[0], F_SETFL, O_NONBLOCK) != 0)
+    {
+        ccTestPrintError("creating worker pipe : %s (%d)", strerror(errno), errno);
+        return(EXIT_FAILURE);
+    }
+
+    memset(worker, 0, sizeof(worker));
+    memset(&ccsweep_reorder, 0, sizeof(ccsweep_reorder));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while(num_done < num_points)
+    {
+        // Start a worker for the next point if a slot is free and the point is within the reorder window
+
+        if(next_point < num_points && num_active < num_workers &&
+           next_point < ccsweep_reorder.next_point + CC_SWEEP_REORDER_LEN)
+        {
+            for(worker_idx = 0 ; worker[worker_idx].pid != 0 ; worker_idx++);
+
+            // Flush stdio buffers so that they are not duplicated in the worker
+
+            fflush(NULL);
+
+            pid = fork();
+
+            if(pid == 0)
+            {
+                close(fd[0]);
+                ccSweepWorker(next_point, init_point, fd[1]);
+            }
+
+            if(pid > 0)
+            {
+                worker[worker_idx].pid                = pid;
+                worker[worker_idx].point_idx          = next_point++;
+                worker[worker_idx].is_result_received = 0;
+                num_active++;
+                continue;
+            }
+
+            // If fork() fails with no active workers then give up, otherwise wait for a worker to finish
+
+            if(num_active == 0)
+            {
+                ccTestPrintError("starting worker process : %s (%d)", strerror(errno), errno);
+                break;
+            }
+        }
+
+        // Wait for a worker to finish
+
+        pid = waitpid(-1, &status, 0);
+
+        if(pid < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            ccTestPrintError("waiting for worker process : %s (%d)", strerror(errno), errno);
+            break;
+        }
+
+        // Read all results in the pipe - the finished worker's result is there if it was written
+
+        while(read(fd[0], &result, sizeof(result)) == sizeof(result))
+        {
+            for(worker_idx = 0 ; worker_idx < num_workers ; worker_idx++)
+            {
+                if(worker[worker_idx].pid != 0 && worker[worker_idx].point_idx == result.point_idx)
+                {
+                    worker[worker_idx].is_result_received = 1;
+                    ccSweepReorderResult(&result, store_result);
+                    num_done++;
+                }
+            }
+        }
+
+        // Free the finished worker's slot and report a failure if it did not return a result
+
+        for(worker_idx = 0 ; worker_idx < num_workers && worker[worker_idx].pid != pid ; worker_idx++);
+
+        if(worker_idx < num_workers)
+        {
+            if(worker[worker_idx].is_result_received == 0)
+            {
+                memset(&result, 0, sizeof(result));
+
+                result.point_idx   = worker[worker_idx].point_idx;
+                result.exit_status = EXIT_FAILURE;
+
+                ccSweepReorderResult(&result, store_result);
+                num_done++;
+            }
+
+            worker[worker_idx].pid = 0;
+            num_active--;
+        }
+    }
+
+    close(fd[0]);
+    close(fd[1]);
+
+    // Wait for any remaining workers if the loop was abandoned
+
+    while(num_active > 0 && wait(&status) > 0)
+    {
+        num_active--;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("Completed %u of %u runs using %u workers in %.2f s\n", num_done, num_points, num_workers,
+           (end.tv_sec - start.tv_sec) + 1.0E-9 * (end.tv_nsec - start.tv_nsec));
+
+    return(num_done == num_points ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+}
+
+// EOF
@@ -0,0 +1,917 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     ccTable.c                                                                   Copyright CERN 2014
+
+  License:  This file is part of cctest.
+
+            cctest is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  cctest TABLE import functions
+
+  Notes:    TABLE REF and TIME parameters are limited to TABLE_LEN points and must fit on one line of a
+            cctest file. Imported tables are read from CSV or binary files into dynamically allocated
+            arrays that replace the TABLE REF and TIME parameters for the cycle selector.
+
+            Files are streamed in blocks of CC_TABLE_BLOCK_SIZE bytes, so only the arrays and one block
+            are in memory. Each CSV block ends at the last complete line and is parsed in chunks by up to
+            CC_TABLE_MAX_THREADS threads. The lines in each chunk are counted first, so that every thread
+            can then parse its chunk directly into the arrays. Numbers are converted exactly by a fast path
+            when the decimal mantissa and exponent are small enough (Clinger, 1990), otherwise by strtod().
+
+            FGTABLE files are memory-mapped by fgTableFileOpen() and their float columns are used in place
+            by fgTableInit(), so very large tables are neither read nor copied.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifndef __MINGW32__
+#include <unistd.h>
+#endif
+
+#include "ccCmds.h"
+#include "ccTest.h"
+#include "ccTable.h"
+#include "ccCache.h"
+#include "libfg/table_file.h"
+
+// Constants
+
+#define CC_TABLE_MAX_NUMBER_LEN     64              // Max length of a number converted by strtod()
+
+// Result of parsing one CSV line
+
+enum cctable_line
+{
+    CC_TABLE_LINE_BLANK,                            // Empty or comment (#) line
+    CC_TABLE_LINE_POINT,                            // Valid time,ref point
+    CC_TABLE_LINE_INVALID,                          // Invalid line
+};
+
+// Imported table
+
+struct cctable
+{
+    char                       *filename;               // Name of imported file (NULL if none)
+    enum cctable_format         format;                 // Format of imported file
+    uint32_t                    num_points;             // Number of points in the table
+    float                      *ref;                    // Reference array
+    float                      *time;                   // Time array
+    struct fg_table_file        file;                   // Mapped table file (FGTABLE format only)
+};
+
+// CSV chunk parsed by one thread
+
+struct cctable_chunk
+{
+    const char                 *start;                  // Start of the chunk (start of a line)
+    const char                 *end;                    // End of the chunk (after a newline or end of file)
+    uint32_t                    first_line;             // Line number of the first line of the chunk
+    uint32_t                    num_lines;              // Number of lines in the chunk
+    uint32_t                    num_points;             // Number of points parsed
+    uint32_t                    error_line;             // Line number of the first invalid line (0 if none)
+    bool                        is_header_allowed;      // The first line can be a header (first chunk only)
+    float                      *ref;                    // Reference values for the chunk
+    float                      *time;                   // Time values for the chunk
+};
+
+static struct cctable cctable[CC_NUM_CYC_SELS];
+
+static const char * const cctable_format_names[] = { "CSV", "FLOAT", "DOUBLE", "FGTABLE" };
+
+static const double cctable_pow10[] =
+{
+    1.0E0,  1.0E1,  1.0E2,  1.0E3,  1.0E4,  1.0E5,  1.0E6,  1.0E7,  1.0E8,  1.0E9,  1.0E10, 1.0E11,
+    1.0E12, 1.0E13, 1.0E14, 1.0E15, 1.0E16, 1.0E17, 1.0E18, 1.0E19, 1.0E20, 1.0E21, 1.0E22
+};
+
+
+
+static bool ccTableParseNumber(const char **string, const char *end, double *value)
+{
+    const char *p           = *string;
+    uint64_t    mantissa    = 0;
+    int32_t     exponent    = 0;
+    int32_t     exp_value   = 0;
+    uint32_t    num_digits  = 0;
+    bool        is_digit    = false;
+    bool        is_exact    = true;
+    bool        is_negative = false;
+
+    if(p < end && (*p == '-' || *p == '+'))
+    {
+        is_negative = (*p++ == '-');
+    }
+
+    // Accumulate up to 19 significant digits in the mantissa
+
+    for( ; p < end && *p >= '0' && *p <= '9' ; p++)
+    {
+        is_digit = true;
+
+        if(mantissa != 0 || *p != '0')
+        {
+            if(++num_digits <= 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+            }
+            else
+            {
+                exponent++;
+                is_exact &= (*p == '0');
+            }
+        }
+    }
+
+    if(p < end && *p == '.')
+    {
+        for(p++ ; p < end && *p >= '0' && *p <= '9' ; p++)
+        {
+            is_digit = true;
+
+            if(mantissa != 0 || *p != '0')
+            {
+                if(++num_digits <= 19)
+                {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    exponent--;
+                }
+                else
+                {
+                    is_exact &= (*p == '0');
+                }
+            }
+            else
+            {
+                exponent--;
+            }
+        }
+    }
+
+    if(is_digit == false)
+    {
+        return(false);
+    }
+
+    // Optional exponent
+
+    if(p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *exp_start   = p++;
+        bool        is_exp_neg  = false;
+
+        if(p < end && (*p == '-' || *p == '+'))
+        {
+            is_exp_neg = (*p++ == '-');
+        }
+
+        if(p < end && *p >= '0' && *p <= '9')
+        {
+            for( ; p < end && *p >= '0' && *p <= '9' ; p++)
+            {
+                if(exp_value < 100000)
+                {
+                    exp_value = exp_value * 10 + (*p - '0');
+                }
+            }
+
+            exponent += is_exp_neg ? -exp_value : exp_value;
+        }
+        else
+        {
+            p = exp_start;
+        }
+    }
+
+    // Fast path: the mantissa and the power of ten are both exact doubles, so one operation rounds correctly
+
+    if(mantissa == 0 && is_exact == true)
+    {
+        *value = 0.0;
+    }
+    else if(is_exact == true && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+        *value = exponent < 0 ? (double)mantissa / cctable_pow10[-exponent] : (double)mantissa * cctable_pow10[exponent];
+    }
+    else
+    {
+        char    number[CC_TABLE_MAX_NUMBER_LEN];
+        size_t  len = p - *string;
+
+        if(len >= CC_TABLE_MAX_NUMBER_LEN)
+        {
+            return(false);
+        }
+
+        memcpy(number, *string, len);
+        number[len] = '\0';
+
+        *value = strtod(number, NULL);
+        *string = p;
+        return(true);
+    }
+
+    if(is_negative == true)
+    {
+        *value = -*value;
+    }
+
+    *string = p;
+    return(true);
+}
+
+
+
+static enum cctable_line ccTableParseLine(const char *p, const char *end, double *time, double *ref)
+{
+    // Skip leading white space and ignore empty and comment lines
+
+    while(p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+
+    if(p >= end || *p == '#' || *p == '\r')
+    {
+        return(CC_TABLE_LINE_BLANK);
+    }
+
+    // Time and reference are separated by white space and optionally a comma or semicolon
+
+    if(ccTableParseNumber(&p, end, time) == false)
+    {
+        return(CC_TABLE_LINE_INVALID);
+    }
+
+    while(p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+
+    if(p < end && (*p == ',' || *p == ';'))
+    {
+        p++;
+
+        while(p < end && (*p == ' ' || *p == '\t'))
+        {
+            p++;
+        }
+    }
+
+    if(ccTableParseNumber(&p, end, ref) == false)
+    {
+        return(CC_TABLE_LINE_INVALID);
+    }
+
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {
+        p++;
+    }
+
+    return(p == end ? CC_TABLE_LINE_POINT : CC_TABLE_LINE_INVALID);
+}
+
+
+
+static void *ccTableCountLines(void *arg)
+{
+    struct cctable_chunk   *chunk = arg;
+    const char             *p     = chunk->start;
+
+    for(chunk->num_lines = 0 ; p < chunk->end && (p = memchr(p, '\n', chunk->end - p)) != NULL ; p++)
+    {
+        chunk->num_lines++;
+    }
+
+    // Count a final line without a newline
+
+    if(chunk->end > chunk->start && chunk->end[-1] != '\n')
+    {
+        chunk->num_lines++;
+    }
+
+    return(NULL);
+}
+
+
+
+static void *ccTableParseChunk(void *arg)
+{
+    struct cctable_chunk   *chunk = arg;
+    const char             *line  = chunk->start;
+    const char             *eol;
+    uint32_t                line_num;
+    double                  time;
+    double                  ref;
+
+    for(line_num = chunk->first_line ; line < chunk->end ; line = eol + 1, line_num++)
+    {
+        if((eol = memchr(line, '\n', chunk->end - line)) == NULL)
+        {
+            eol = chunk->end;
+        }
+
+        switch(ccTableParseLine(line, eol, &time, &ref))
+        {
+        case CC_TABLE_LINE_BLANK:
+
+            break;
+
+        case CC_TABLE_LINE_POINT:
+
+            chunk->time[chunk->num_points] = time;
+            chunk->ref [chunk->num_points] = ref;
+            chunk->num_points++;
+            chunk->is_header_allowed = false;
+            break;
+
+        case CC_TABLE_LINE_INVALID:
+
+            // The first non-blank line of the file can be a header
+
+            if(chunk->is_header_allowed == false)
+            {
+                chunk->error_line = line_num;
+                return(NULL);
+            }
+
+            chunk->is_header_allowed = false;
+            break;
+        }
+    }
+
+    return(NULL);
+}
+
+
+
+static void ccTableRunThreads(void *(*func)(void *), struct cctable_chunk *chunk, uint32_t num_chunks)
+{
+    pthread_t   thread[CC_TABLE_MAX_THREADS];
+    bool        is_thread[CC_TABLE_MAX_THREADS];
+    uint32_t    idx;
+
+    // The first chunk is processed by the calling thread, and by any chunk whose thread cannot be created
+
+    for(idx = 1 ; idx < num_chunks ; idx++)
+    {
+        is_thread[idx] = pthread_create(&thread[idx], NULL, func, &chunk[idx]) == 0;
+    }
+
+    func(&chunk[0]);
+
+    for(idx = 1 ; idx < num_chunks ; idx++)
+    {
+        if(is_thread[idx] == true)
+        {
+            pthread_join(thread[idx], NULL);
+        }
+        else
+        {
+            func(&chunk[idx]);
+        }
+    }
+}
+
+
+
+static uint32_t ccTableNumThreads(size_t size)
+{
+    uint32_t    num_threads = 1;
+
+#ifndef __MINGW32__
+    long        num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if(num_cpus > 1)
+    {
+        num_threads = num_cpus < CC_TABLE_MAX_THREADS ? (uint32_t)num_cpus : CC_TABLE_MAX_THREADS;
+    }
+#endif
+
+    // Small files are parsed by fewer threads
+
+    if(num_threads > size / CC_TABLE_MIN_CHUNK + 1)
+    {
+        num_threads = size / CC_TABLE_MIN_CHUNK + 1;
+    }
+
+    return(num_threads);
+}
+
+
+
+static uint32_t ccTableParseCsv(char *filename, const char *buf, size_t size, bool is_header_allowed,
+                                struct cctable *table, uint32_t *max_points, uint32_t *line_num, uint32_t *num_threads)
+{
+    struct cctable_chunk    chunk[CC_TABLE_MAX_THREADS];
+    uint32_t                num_chunks = ccTableNumThreads(size);
+    uint32_t                num_lines  = 0;
+    uint32_t                idx;
+    const char             *start      = buf;
+    const char             *end;
+
+    // Split the block into chunks that start at the beginning of a line
+
+    memset(chunk, 0, sizeof(chunk));
+
+    for(idx = 0 ; idx < num_chunks ; idx++)
+    {
+        end = buf + size * (idx + 1) / num_chunks;
+
+        if(end < start)
+        {
+            end = start;
+        }
+
+        if(idx < num_chunks - 1 && end < buf + size && (end = memchr(end, '\n', buf + size - end)) != NULL)
+        {
+            end++;
+        }
+        else
+        {
+            end = buf + size;
+        }
+
+        chunk[idx].start = start;
+        chunk[idx].end   = end;
+        start = end;
+    }
+
+    chunk[0].is_header_allowed = is_header_allowed;
+
+    // Count the lines in every chunk to find where each chunk's points go in the arrays
+
+    ccTableRunThreads(ccTableCountLines, chunk, num_chunks);
+
+    for(idx = 0 ; idx < num_chunks ; idx++)
+    {
+        if(chunk[idx].num_lines > CC_TABLE_MAX_POINTS - *line_num - num_lines)
+        {
+            ccTestPrintError("too many lines in '%s' (%u max)", filename, CC_TABLE_MAX_POINTS);
+            return(EXIT_FAILURE);
+        }
+
+        chunk[idx].first_line = *line_num + num_lines + 1;
+        num_lines += chunk[idx].num_lines;
+    }
+
+    // Grow the arrays geometrically so that a large file is not copied once per block
+
+    if(table->num_points + num_lines + 1 > *max_points)
+    {
+        uint32_t    new_max_points = *max_points < CC_TABLE_MAX_POINTS / 2 ? 2 * *max_points : CC_TABLE_MAX_POINTS + 1;
+        float      *time;
+        float      *ref;
+
+        if(new_max_points < table->num_points + num_lines + 1)
+        {
+            new_max_points = table->num_points + num_lines + 1;
+        }
+
+        time = realloc(table->time, new_max_points * sizeof(float));
+
+        if(time != NULL)
+        {
+            table->time = time;
+        }
+
+        ref = realloc(table->ref, new_max_points * sizeof(float));
+
+        if(ref != NULL)
+        {
+            table->ref = ref;
+        }
+
+        if(time == NULL || ref == NULL)
+        {
+            ccTestPrintError("allocating memory for %u points from '%s'", table->num_points + num_lines, filename);
+            return(EXIT_FAILURE);
+        }
+
+        *max_points = new_max_points;
+    }
+
+    for(idx = 0 ; idx < num_chunks ; idx++)
+    {
+        chunk[idx].time = table->time + table->num_points + chunk[idx].first_line - *line_num - 1;
+        chunk[idx].ref  = table->ref  + table->num_points + chunk[idx].first_line - *line_num - 1;
+    }
+
+    // Parse the chunks into the arrays
+
+    ccTableRunThreads(ccTableParseChunk, chunk, num_chunks);
+
+    // Report the first invalid line and close the gaps left by blank lines
+
+    for(idx = 0 ; idx < num_chunks ; idx++)
+    {
+        if(chunk[idx].error_line != 0)
+        {
+            ccTestPrintError("invalid table point on line %u of '%s'", chunk[idx].error_line, filename);
+            return(EXIT_FAILURE);
+        }
+
+        memmove(table->time + table->num_points, chunk[idx].time, chunk[idx].num_points * sizeof(float));
+        memmove(table->ref  + table->num_points, chunk[idx].ref,  chunk[idx].num_points * sizeof(float));
+
+        table->num_points += chunk[idx].num_points;
+    }
+
+    *line_num += num_lines;
+
+    if(*num_threads < num_chunks)
+    {
+        *num_threads = num_chunks;
+    }
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static uint32_t ccTableReadCsv(char *filename, FILE *f, struct cctable *table, uint32_t *num_threads)
+{
+    uint32_t    exit_status = EXIT_SUCCESS;
+    uint32_t    max_points  = 0;
+    uint32_t    line_num    = 0;
+    size_t      len         = 0;
+    size_t      parse_len;
+    bool        is_eof      = false;
+    char       *buf;
+
+    buf = malloc(CC_TABLE_BLOCK_SIZE);
+
+    if(buf == NULL)
+    {
+        ccTestPrintError("allocating memory to read '%s'", ccTestAbbreviatedArg(filename));
+        return(EXIT_FAILURE);
+    }
+
+    // Stream the file one block at a time, carrying the partial last line of each block into the next
+
+    while(exit_status == EXIT_SUCCESS && is_eof == false)
+    {
+        len += fread(buf + len, 1, CC_TABLE_BLOCK_SIZE - len, f);
+
+        if(ferror(f))
+        {
+            ccTestPrintError("reading file '%s' : %s (%d)", ccTestAbbreviatedArg(filename), strerror(errno), errno);
+            exit_status = EXIT_FAILURE;
+            break;
+        }
+
+        is_eof = (len < CC_TABLE_BLOCK_SIZE);
+
+        for(parse_len = len ; is_eof == false && parse_len > 0 && buf[parse_len - 1] != '\n' ; parse_len--);
+
+        if(parse_len == 0 && is_eof == false)
+        {
+            ccTestPrintError("line %u of '%s' is too long", line_num + 1, ccTestAbbreviatedArg(filename));
+            exit_status = EXIT_FAILURE;
+            break;
+        }
+
+        if(parse_len > 0)
+        {
+            // Only the first non-blank line of the first block can be a header
+
+            exit_status = ccTableParseCsv(filename, buf, parse_len, line_num == 0, table, &max_points, &line_num, num_threads);
+
+            memmove(buf, buf + parse_len, len - parse_len);
+            len -= parse_len;
+        }
+    }
+
+    free(buf);
+
+    return(exit_status);
+}
+
+
+
+static void ccTableParseBinary(const char *buf, size_t size, struct cctable *table)
+{
+    size_t      point_size = table->format == CC_TABLE_FLOAT ? 2 * sizeof(float) : 2 * sizeof(double);
+    uint32_t    num_points = size / point_size;
+    uint32_t    idx;
+    float      *time       = table->time + table->num_points;
+    float      *ref        = table->ref  + table->num_points;
+
+    // Separate the interleaved time,ref pairs - memcpy() avoids unaligned access
+
+    for(idx = 0 ; idx < num_points ; idx++)
+    {
+        if(table->format == CC_TABLE_FLOAT)
+        {
+            memcpy(&time[idx], buf + idx * point_size,                 sizeof(float));
+            memcpy(&ref [idx], buf + idx * point_size + sizeof(float), sizeof(float));
+        }
+        else
+        {
+            double  value[2];
+
+            memcpy(value, buf + idx * point_size, sizeof(value));
+
+            time[idx] = value[0];
+            ref [idx] = value[1];
+        }
+    }
+
+    table->num_points += num_points;
+}
+
+
+
+static uint32_t ccTableReadBinary(char *filename, FILE *f, struct cctable *table)
+{
+    size_t      point_size = table->format == CC_TABLE_FLOAT ? 2 * sizeof(float) : 2 * sizeof(double);
+    size_t      block_size;
+    long        size;
+    char       *buf;
+
+    // The file length gives the number of points, so the arrays are allocated once
+
+    if(fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0)
+    {
+        ccTestPrintError("reading file '%s' : %s (%d)", ccTestAbbreviatedArg(filename), strerror(errno), errno);
+        return(EXIT_FAILURE);
+    }
+
+    if(size % point_size != 0 || size / point_size > CC_TABLE_MAX_POINTS)
+    {
+        ccTestPrintError("invalid %s file length (%lu) for '%s'",
+                         cctable_format_names[table->format], (unsigned long)size, filename);
+        return(EXIT_FAILURE);
+    }
+
+    table->time = malloc((size / point_size + 1) * sizeof(float));
+    table->ref  = malloc((size / point_size + 1) * sizeof(float));
+    buf         = malloc(CC_TABLE_BLOCK_SIZE);
+
+    if(table->time == NULL || table->ref == NULL || buf == NULL)
+    {
+        ccTestPrintError("allocating memory for %lu points from '%s'", (unsigned long)(size / point_size), filename);
+        free(buf);
+        return(EXIT_FAILURE);
+    }
+
+    // Stream the file one block of whole points at a time
+
+    for( ; size > 0 ; size -= block_size)
+    {
+        block_size = (size_t)size < CC_TABLE_BLOCK_SIZE ? (size_t)size : CC_TABLE_BLOCK_SIZE - CC_TABLE_BLOCK_SIZE % point_size;
+
+        if(fread(buf, 1, block_size, f) != block_size)
+        {
+            ccTestPrintError("reading file '%s' : %s (%d)", ccTestAbbreviatedArg(filename), strerror(errno), errno);
+            free(buf);
+            return(EXIT_FAILURE);
+        }
+
+        ccTableParseBinary(buf, block_size, table);
+    }
+
+    free(buf);
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static uint32_t ccTableRead(char *filename, struct cctable *table, uint32_t *num_threads)
+{
+    uint32_t            exit_status;
+    float              *time;
+    float              *ref;
+    FILE               *f;
+
+    f = fopen(filename, "rb");
+
+    if(f == NULL)
+    {
+        ccTestPrintError("opening file '%s' : %s (%d)", ccTestAbbreviatedArg(filename), strerror(errno), errno);
+        return(EXIT_FAILURE);
+    }
+
+    if(table->format == CC_TABLE_CSV)
+    {
+        exit_status = ccTableReadCsv(filename, f, table, num_threads);
+    }
+    else
+    {
+        exit_status = ccTableReadBinary(filename, f, table);
+    }
+
+    fclose(f);
+
+    // Release unused space left by blank lines and array growth - the arrays are kept if shrinking fails
+
+    if(exit_status == EXIT_SUCCESS && table->num_points > 0)
+    {
+        if((time = realloc(table->time, table->num_points * sizeof(float))) != NULL)
+        {
+            table->time = time;
+        }
+
+        if((ref = realloc(table->ref, table->num_points * sizeof(float))) != NULL)
+        {
+            table->ref = ref;
+        }
+    }
+
+    return(exit_status);
+}
+
+
+
+static uint32_t ccTableMap(char *filename, struct cctable *table)
+{
+    enum fg_error       fg_error;
+
+    errno = 0;
+
+    fg_error = fgTableFileOpen(filename, &table->file);
+
+    if(fg_error != FG_OK)
+    {
+        if(errno != 0)
+        {
+            ccTestPrintError("mapping file '%s' : %s (%d)", ccTestAbbreviatedArg(filename), strerror(errno), errno);
+        }
+        else
+        {
+            ccTestPrintError("invalid %s file '%s' (%s)", cctable_format_names[table->format],
+                             ccTestAbbreviatedArg(filename),
+                             fg_error == FG_BAD_ARRAY_LEN ? "columns exceed file length" : "bad header");
+        }
+        return(EXIT_FAILURE);
+    }
+
+    table->num_points = table->file.num_points;
+    table->time       = table->file.time;
+    table->ref        = table->file.ref;
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+static void ccTableFree(struct cctable *table)
+{
+    if(table->format == CC_TABLE_FGTABLE)
+    {
+        fgTableFileClose(&table->file);
+    }
+    else
+    {
+        free(table->time);
+        free(table->ref);
+    }
+
+    free(table->filename);
+
+    memset(table, 0, sizeof(*table));
+}
+
+
+
+uint32_t ccTableImport(uint32_t cyc_sel, char *filename, enum cctable_format format)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will import a table from the named file for the cycle selector. The imported table will
+  be used instead of the TABLE REF and TIME parameters until it is removed by ccTableRemove(). The table is
+  only checked by fgTableInit() when it is used.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cctable      table;
+    struct timespec     start;
+    struct timespec     end;
+    uint32_t            num_threads = 1;
+    uint32_t            exit_status;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    memset(&table, 0, sizeof(table));
+
+    table.format = format;
+
+    if(format == CC_TABLE_FGTABLE)
+    {
+        exit_status = ccTableMap(filename, &table);
+    }
+    else
+    {
+        exit_status = ccTableRead(filename, &table, &num_threads);
+    }
+
+    if(exit_status == EXIT_SUCCESS && table.num_points == 0)
+    {
+        ccTestPrintError("no table points in '%s'", ccTestAbbreviatedArg(filename));
+        exit_status = EXIT_FAILURE;
+    }
+
+    if(exit_status == EXIT_FAILURE)
+    {
+        ccTableFree(&table);
+        return(EXIT_FAILURE);
+    }
+
+    // Replace any previously imported table
+
+    table.filename = strdup(filename);
+
+    if(table.filename == NULL)
+    {
+        ccTestPrintError("allocating memory for the name of '%s'", ccTestAbbreviatedArg(filename));
+        ccTableFree(&table);
+        return(EXIT_FAILURE);
+    }
+
+    ccTableRemove(cyc_sel);
+
+    cctable[cyc_sel] = table;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("Imported %u points for TABLE(%u) from '%s' in %.3f s using %u thread%s\n",
+           table.num_points, cyc_sel, filename,
+           (end.tv_sec - start.tv_sec) + 1.0E-9 * (end.tv_nsec - start.tv_nsec),
+           num_threads, num_threads > 1 ? "s" : "");
+
+    return(EXIT_SUCCESS);
+}
+
+
+
+void ccTableRemove(uint32_t cyc_sel)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will remove the imported table for the cycle selector, so that the TABLE REF and TIME
+  parameters are used again.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    ccTableFree(&cctable[cyc_sel]);
+
+    ccCacheInvalidate(cyc_sel, cyc_sel);
+}
+
+
+
+void ccTablePrint(FILE *f)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will print the IMPORT command for every imported table.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    cyc_sel;
+    char        cmd[CC_MAX_CMD_NAME_LEN + 8];
+
+    for(cyc_sel = 0 ; cyc_sel < CC_NUM_CYC_SELS ; cyc_sel++)
+    {
+        if(cctable[cyc_sel].filename != NULL)
+        {
+            snprintf(cmd, sizeof(cmd), "IMPORT(%u)", cyc_sel);
+
+            fprintf(f, "%-*s %s %s\n", CC_MAX_CMD_NAME_LEN, cmd, cctable[cyc_sel].filename,
+                    cctable_format_names[cctable[cyc_sel].format]);
+        }
+    }
+}
+
+
+
+void ccTableGet(uint32_t cyc_sel, float **ref, uint32_t *ref_num_els, float **time, uint32_t *time_num_els)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function will return the table for the cycle selector: the imported table if there is one,
+  otherwise the TABLE REF and TIME parameters.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    if(cctable[cyc_sel].num_points > 0)
+    {
+        *ref          = cctable[cyc_sel].ref;
+        *ref_num_els  = cctable[cyc_sel].num_points;
+        *time         = cctable[cyc_sel].time;
+        *time_num_els = cctable[cyc_sel].num_points;
+    }
+    else
+    {
+        *ref          = ccpars_table[cyc_sel].ref;
+        *ref_num_els  = table_pars[0].num_elements[cyc_sel];
+        *time         = ccpars_table[cyc_sel].time;
+        *time_num_els = table_pars[1].num_elements[cyc_sel];
+    }
+}
+
+// EOF
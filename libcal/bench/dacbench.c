@@ -0,0 +1,318 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     dacbench.c                                                                  Copyright CERN 2015
+
+  Purpose:  Check and benchmark of the batched DAC conversion
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    calDacSetBatch() is compared with calDacSet() and with OldDacSet(), a copy of calDacSet() from
+            before the batched conversion was added.  For each DAC resolution, buffers of edge values,
+            random voltages and random bit patterns are converted.  The batch output and the number of
+            clipped values must be identical to calDacSet().  Both must match OldDacSet() wherever its
+            float to integer conversion was defined, that is, when the unclipped raw value is not a NaN
+            and fits in an int32_t.  Finally, the cost per sample of the three conversions is reported.
+            The program returns 1 if any value differs.
+
+            Usage: dacbench [number of random buffers per resolution]
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include "libcal.h"
+
+// Constants
+
+#define DEFAULT_NUM_BUFS        1000                    // Random buffers checked per resolution
+#define BUF_LEN                 4096                    // Samples per buffer
+#define NUM_REPEATS             200                     // Buffers converted per timing trial
+#define NUM_TRIALS              5                       // Timing trials (best is kept)
+
+// DAC resolutions and calibration measurements
+
+static unsigned         resolutions[] = { 16, 18, 20, 24, 31 };
+static float            v_adc[CAL_NUM_ERRS] = { 0.0012, 10.0023, -9.9971 };
+
+// Buffers
+
+static float            v_dac  [BUF_LEN];
+static int32_t          new_raw[BUF_LEN];
+static int32_t          set_raw[BUF_LEN];
+static int32_t          old_raw[BUF_LEN];
+static unsigned         old_defined[BUF_LEN];
+
+/*---------------------------------------------------------------------------------------------------------*/
+static int32_t OldDacSet(const struct cal_dac *cal_dac, float v_dac, unsigned *defined, unsigned *clipped)
+/*---------------------------------------------------------------------------------------------------------*\
+  This is calDacSet() before calDacSetBatch() was added.  The float to integer conversion is only made when
+  it is defined, and defined is set accordingly.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    float        raw;
+    int32_t      dac_raw;
+
+    // Calculate raw DAC value based on calibration
+
+    v_dac -= cal_dac->v_offset;
+
+    if(v_dac >= 0.0)
+    {
+        raw = v_dac * cal_dac->gain_pos;
+    }
+    else
+    {
+        raw = v_dac * cal_dac->gain_neg;
+    }
+
+    *defined = (raw >= -2147483648.0F && raw < 2147483648.0F);
+
+    if(!*defined)
+    {
+        *clipped = 1;
+        return(0);
+    }
+
+    dac_raw = raw;
+
+    // Clip raw value to raw DAC range
+
+    *clipped = 1;
+
+    if(dac_raw > cal_dac->max_dac_raw)
+    {
+        dac_raw = cal_dac->max_dac_raw;
+    }
+    else if(dac_raw < cal_dac->min_dac_raw)
+    {
+        dac_raw = cal_dac->min_dac_raw;
+    }
+    else
+    {
+        *clipped = 0;
+    }
+
+    return(dac_raw);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static inline uint64_t Ns(void)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return((uint64_t)t.tv_sec * 1000000000 + t.tv_nsec);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static float RandomFloat(float min, float max)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    return(min + (max - min) * ((float)rand() / (float)RAND_MAX));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static float RandomBits(void)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    float       v;
+
+    memcpy(&v, &bits, sizeof(v));
+
+    return(v);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static unsigned EdgeValues(const struct cal_dac *cal_dac)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function fills v_dac with values at and around the voltage limits and zero, and the special values.
+  It returns the number of values.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    float       centres[] = { cal_dac->min_v_dac, cal_dac->max_v_dac, cal_dac->v_offset, 0.0, -0.0 };
+    float       specials[] = { INFINITY, -INFINITY, NAN, -NAN, FLT_MAX, -FLT_MAX, FLT_MIN, -FLT_MIN };
+    unsigned    num_values = 0;
+    unsigned    i;
+    int         j;
+
+    for(i = 0 ; i < sizeof(centres) / sizeof(centres[0]) ; i++)
+    {
+        float   down = centres[i];
+        float   up   = centres[i];
+
+        v_dac[num_values++] = centres[i];
+
+        for(j = 0 ; j < 100 ; j++)
+        {
+            down = nextafterf(down, -INFINITY);
+            up   = nextafterf(up,    INFINITY);
+
+            v_dac[num_values++] = down;
+            v_dac[num_values++] = up;
+        }
+    }
+
+    for(i = 0 ; i < sizeof(specials) / sizeof(specials[0]) ; i++)
+    {
+        v_dac[num_values++] = specials[i];
+    }
+
+    return(num_values);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static unsigned CheckBuffer(const struct cal_dac *cal_dac, unsigned num_samples, unsigned *num_undefined)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function converts the first num_samples values of v_dac in the three ways and returns the number of
+  differences.  The number of values for which OldDacSet() is undefined is added to num_undefined.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    unsigned    num_errors = 0;
+    unsigned    new_clipped;
+    unsigned    old_clipped = 0;
+    unsigned    clipped;
+    unsigned    i;
+
+    new_clipped = calDacSetBatch(cal_dac, v_dac, new_raw, num_samples);
+
+    for(i = 0 ; i < num_samples ; i++)
+    {
+        set_raw[i]   = calDacSet(cal_dac, v_dac[i]);
+        old_raw[i]   = OldDacSet(cal_dac, v_dac[i], &old_defined[i], &clipped);
+        old_clipped += clipped;
+
+        if(new_raw[i] != set_raw[i] || (old_defined[i] && new_raw[i] != old_raw[i]))
+        {
+            if(num_errors++ < 10)
+            {
+                uint32_t    bits;
+
+                memcpy(&bits, &v_dac[i], sizeof(bits));
+
+                printf("  v_dac=%.9g (0x%08x): batch=%d calDacSet=%d old=%d%s\n", v_dac[i], bits,
+                       new_raw[i], set_raw[i], old_raw[i], old_defined[i] ? "" : " (undefined)");
+            }
+        }
+
+        *num_undefined += !old_defined[i];
+    }
+
+    if(new_clipped != old_clipped)
+    {
+        printf("  batch clipped %u values, expected %u\n", new_clipped, old_clipped);
+        num_errors++;
+    }
+
+    return(num_errors);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void Timing(const struct cal_dac *cal_dac)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function reports the best cost per sample of the three conversions on random in-range voltages.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint64_t    best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    uint64_t    t0;
+    unsigned    clipped;
+    unsigned    trial;
+    unsigned    r;
+    unsigned    i;
+
+    for(i = 0 ; i < BUF_LEN ; i++)
+    {
+        v_dac[i] = RandomFloat(cal_dac->min_v_dac, cal_dac->max_v_dac);
+    }
+
+    for(trial = 0 ; trial < NUM_TRIALS ; trial++)
+    {
+        t0 = Ns();
+
+        for(r = 0 ; r < NUM_REPEATS ; r++)
+        {
+            calDacSetBatch(cal_dac, v_dac, new_raw, BUF_LEN);
+            __asm__ __volatile__("" : : "r"(new_raw) : "memory");
+        }
+
+        t0 = Ns() - t0;
+        best[0] = t0 < best[0] ? t0 : best[0];
+        t0 = Ns();
+
+        for(r = 0 ; r < NUM_REPEATS ; r++)
+        {
+            for(i = 0 ; i < BUF_LEN ; i++)
+            {
+                set_raw[i] = calDacSet(cal_dac, v_dac[i]);
+            }
+            __asm__ __volatile__("" : : "r"(set_raw) : "memory");
+        }
+
+        t0 = Ns() - t0;
+        best[1] = t0 < best[1] ? t0 : best[1];
+        t0 = Ns();
+
+        for(r = 0 ; r < NUM_REPEATS ; r++)
+        {
+            for(i = 0 ; i < BUF_LEN ; i++)
+            {
+                old_raw[i] = OldDacSet(cal_dac, v_dac[i], &old_defined[i], &clipped);
+            }
+            __asm__ __volatile__("" : : "r"(old_raw) : "memory");
+        }
+
+        t0 = Ns() - t0;
+        best[2] = t0 < best[2] ? t0 : best[2];
+    }
+
+    printf("  ns/sample: calDacSetBatch %.3f  calDacSet %.3f  old calDacSet %.3f\n",
+           (double)best[0] / (NUM_REPEATS * BUF_LEN),
+           (double)best[1] / (NUM_REPEATS * BUF_LEN),
+           (double)best[2] / (NUM_REPEATS * BUF_LEN));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cal_dac  cal_dac;
+    unsigned        num_bufs = (argc > 1 ? atoi(argv[1]) : DEFAULT_NUM_BUFS);
+    unsigned        num_errors = 0;
+    unsigned        num_undefined;
+    unsigned        res_idx;
+    unsigned        buf;
+    unsigned        i;
+
+    srand(1);
+
+    for(res_idx = 0 ; res_idx < sizeof(resolutions) / sizeof(resolutions[0]) ; res_idx++)
+    {
+        unsigned    resolution = resolutions[res_idx];
+        unsigned    res_errors = 0;
+
+        calDacInit(v_adc, &cal_dac, resolution, (1 << (resolution - 2)));
+
+        num_undefined = 0;
+        res_errors   += CheckBuffer(&cal_dac, EdgeValues(&cal_dac), &num_undefined);
+
+        for(buf = 0 ; buf < num_bufs ; buf++)
+        {
+            for(i = 0 ; i < BUF_LEN ; i++)
+            {
+                v_dac[i] = (i & 1) ? RandomBits() : RandomFloat(2.0 * cal_dac.min_v_dac, 2.0 * cal_dac.max_v_dac);
+            }
+
+            res_errors += CheckBuffer(&cal_dac, BUF_LEN, &num_undefined);
+        }
+
+        printf("%2u bits: %u values (%u undefined for the old conversion): %u differences\n",
+               resolution, num_bufs * BUF_LEN + EdgeValues(&cal_dac), num_undefined, res_errors);
+
+        Timing(&cal_dac);
+
+        num_errors += res_errors;
+    }
+
+    printf("\n%u differences\n", num_errors);
+
+    return(num_errors > 0);
+}
+// EOF
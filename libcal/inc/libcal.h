@@ -113,6 +113,19 @@
                 full scale range based on the DAC resolution and the assumption that the DAC register
                 takes a signed value.  This is used to clip the calibrated value to avoid wrap-around.
 
+            struct cal_fast *fast
+
+                Cached composite calibration for one current or voltage measurement.  The ADC and DCCT
+                or voltage divider factors are combined into one gain and offset per sign, so the
+                per-sample path in calFastMeas() is a single multiply-add.  The transform is recalculated
+                by calFastCurrentFactors() or calFastVoltageFactors() only when the factors change.
+
+            struct cal_inl *inl
+
+                Optional integral non-linearity correction table for an ADC.  The table is built from
+                multi-point calibration data by calInlInit() and is piecewise-linear in v_raw with
+                segments of 2^shift raw counts, so calInlCorrect() finds the segment with a shift.
+
             The DCCT/ADC calibration process works on five different timescales, and it is useful to
             understand which functions are used at which timescale.  The precise periods for these
             timescales depends on the particular application, but broadly for power converter controls
@@ -148,7 +161,8 @@
                 5. 0.05 - 1 ms
 
                     Use of the raw ADC values with the ADC and DCCT calibration factors (computed
-                    every second) to calculate the DCCT currents.
+                    every second) to calculate the DCCT currents, or with the composite transform
+                    from calFastCurrentFactors() via calFastMeas().
 
 \*---------------------------------------------------------------------------------------------------------*/
 
@@ -163,6 +177,10 @@
 #define CAL_TEMP_T0             23.0                    // T0 calibration temperature
 #define CAL_TEMP_T1             28.0                    // T1 calibration temperature
 #define CAL_TEMP_T2             33.0                    // T2 calibration temperature
+#define CAL_AVE_MAX_CHANNELS    32                      // Max channels for calAverageChannels()
+#define CAL_INL_MAX_SEGS        256                     // Max segments in an INL correction table
+#define CAL_DAC_RAW_F_MAX       2147483520.0F           // Largest float below 2^31 (DAC raw before clipping)
+#define CAL_DAC_RAW_F_MIN       -2147483648.0F          // -2^31 (DAC raw before clipping)
 
 
 // Types
@@ -207,6 +225,30 @@ struct cal_average_v_raw
     int32_t             v_raw_ave;                      // Average v_raw once num_samples_to_acq == 0
 };
 
+struct cal_average_channels                             // Average v_raw for interleaved channels
+{
+    unsigned            num_channels;                   // Number of interleaved channels
+    unsigned            num_samples;                    // Total number of samples to acquire per channel
+    unsigned            num_samples_to_acq;             // Down counter of number of samples to acquire
+
+    // Per channel accumulators - samples are accumulated relative to v_raw_0 to keep sum_sq accurate
+
+    int32_t             v_raw_0  [CAL_AVE_MAX_CHANNELS];        // First v_raw value
+    int32_t             v_raw_min[CAL_AVE_MAX_CHANNELS];        // Minimum v_raw value
+    int32_t             v_raw_max[CAL_AVE_MAX_CHANNELS];        // Maximum v_raw value
+    int64_t             sum      [CAL_AVE_MAX_CHANNELS];        // Sum of (v_raw - v_raw_0)
+    double              sum_sq   [CAL_AVE_MAX_CHANNELS];        // Sum of (v_raw - v_raw_0)^2
+};
+
+struct cal_average_result                               // Statistics for one channel of cal_average_channels
+{
+    int32_t             v_raw_ave;                      // Average v_raw (truncated as by calAverageVraw())
+    int32_t             v_raw_min;                      // Minimum v_raw
+    int32_t             v_raw_max;                      // Maximum v_raw
+    double              mean;                           // Average v_raw without truncation
+    double              variance;                       // Variance of v_raw (raw^2)
+};
+
 struct cal_flags                                        // Calibration flags
 {
     unsigned            warning;                        // Calibration warning flag
@@ -259,6 +301,39 @@ struct cal_v_meas                                       // Voltage measurement p
     float               inv_gain;                       // 1 / Voltage divider gain (Vmeas/Vadc)
 };
 
+// Composite calibration structures
+
+struct cal_fast_bank                                    // Composite v_raw -> measurement transform
+{                                                       // Index [v_raw < 0][v_adc < 0]
+    float               gain[2][2];                     // Combined gain (meas/raw)
+    float               offset[2][2];                   // Combined offset (meas)
+    float               v_raw_zero[2];                  // v_raw for v_adc = 0, index [v_raw < 0]
+};
+
+struct cal_fast                                         // Cached composite calibration
+{
+    struct cal_fast_bank bank[2];                       // Double buffered transforms
+    unsigned            active_bank;                    // Bank used by calFastMeas()
+    unsigned            valid;                          // Cached factors below are valid
+    struct cal_adc      adc;                            // ADC factors used for the active bank
+    struct cal_dcct     dcct;                           // DCCT factors used for the active bank (current)
+    struct cal_v_meas   v_meas;                         // Voltage factors used for the active bank (voltage)
+};
+
+struct cal_inl_seg                                      // INL correction table segment
+{
+    float               corr;                           // Correction (raw) at start of segment
+    float               slope;                          // Change in correction per raw count
+};
+
+struct cal_inl                                          // ADC integral non-linearity correction table
+{
+    int32_t             v_raw_min;                      // v_raw at the start of the first segment
+    unsigned            shift;                          // Segment length is 2^shift raw counts
+    int32_t             max_seg_idx;                    // Number of segments - 1
+    struct cal_inl_seg  seg[CAL_INL_MAX_SEGS];          // Segments - the end segments are extrapolated
+};
+
 // Calibrated measurement structures
 
 struct cal_current                                      // Acquired current measurement
@@ -340,6 +415,13 @@ uint32_t calEventUnixtime           (const struct cal_event *event);
 
 unsigned calAverageVraw             (struct cal_average_v_raw *average_v_raw, unsigned num_samples, int32_t v_raw);
 
+unsigned calAverageChannelsInit     (struct cal_average_channels *average, unsigned num_channels, unsigned num_samples);
+
+unsigned calAverageChannels         (struct cal_average_channels *average, const int32_t *v_raw, unsigned num_frames);
+
+void     calAverageChannelsResult   (const struct cal_average_channels *average, unsigned channel,
+                                     struct cal_average_result *result);
+
 void     calTempFilterInit          (struct cal_temp_filter *temp, float period_s, float time_constant_s);
 
 float    calTempFilter              (struct cal_temp_filter *temp, float temp_c);
@@ -352,6 +434,80 @@ void     calDacInit                 (const float v_adc[CAL_NUM_ERRS], struct cal
 
 int32_t  calDacSet                  (const struct cal_dac *cal_dac, float v_dac);
 
+unsigned calDacSetBatch             (const struct cal_dac *cal_dac, const float *v_dac, int32_t *dac_raw,
+                                     unsigned num_samples);
+
+void     calFastInit                (struct cal_fast *fast);
+
+unsigned calFastCurrentFactors      (const struct cal_dcct *cal_dcct, const struct cal_adc *cal_adc,
+                                     struct cal_fast *fast);
+
+unsigned calFastVoltageFactors      (const struct cal_v_meas *cal_v_meas, const struct cal_adc *cal_adc,
+                                     struct cal_fast *fast);
+
+unsigned calInlInit                 (struct cal_inl *inl, unsigned num_points,
+                                     const int32_t *v_raw_meas, const int32_t *v_raw_ideal,
+                                     int32_t v_raw_min, unsigned shift, unsigned num_segs);
+
+void     calFastMeasBatch           (const struct cal_fast *fast, const struct cal_inl *inl,
+                                     const int32_t *v_raw, float *meas, unsigned num_samples);
+
+/*---------------------------------------------------------------------------------------------------------*/
+static inline float calInlCorrect(const struct cal_inl *inl, int32_t v_raw)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: 0.05 - 1 ms
+
+  This function returns v_raw corrected for the ADC integral non-linearity using the table prepared by
+  calInlInit().  The segment is found with a shift, so the cost is the same for every value of v_raw.
+  Values beyond the ends of the table use the first or last segment.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    int64_t                   d_raw   = (int64_t)v_raw - inl->v_raw_min;
+    int64_t                   seg_idx = d_raw >> inl->shift;
+    const struct cal_inl_seg *seg;
+
+    seg_idx = seg_idx < 0                ? 0                : seg_idx;
+    seg_idx = seg_idx > inl->max_seg_idx ? inl->max_seg_idx : seg_idx;
+    seg     = &inl->seg[seg_idx];
+
+    return((float)v_raw - (seg->corr + seg->slope * (float)(d_raw - (seg_idx << inl->shift))));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static inline float calFastMeasRaw(const struct cal_fast *fast, float f_raw)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function applies the composite transform to a raw value that may have been corrected for INL.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    const struct cal_fast_bank *bank    = &fast->bank[*(volatile const unsigned *)&fast->active_bank];
+    unsigned                    raw_neg = (f_raw < 0.0F);
+    unsigned                    adc_neg = (f_raw < bank->v_raw_zero[raw_neg]);
+
+    return(bank->gain[raw_neg][adc_neg] * f_raw + bank->offset[raw_neg][adc_neg]);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static inline float calFastMeas(const struct cal_fast *fast, int32_t v_raw)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: 0.05 - 1 ms
+
+  This function translates v_raw into i_dcct or v_meas with the composite transform prepared by
+  calFastCurrentFactors() or calFastVoltageFactors().  It replaces the measurement path of calCurrent() or
+  calVoltage() with two comparisons and a single multiply-add.  For an ADC with an INL correction table,
+  use calFastMeasInl().
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(calFastMeasRaw(fast, (float)v_raw));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static inline float calFastMeasInl(const struct cal_fast *fast, const struct cal_inl *inl, int32_t v_raw)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: 0.05 - 1 ms
+
+  This function is the same as calFastMeas() except that v_raw is first corrected for INL.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(calFastMeasRaw(fast, calInlCorrect(inl, v_raw)));
+}
+
 #ifdef __cplusplus
 }
 #endif
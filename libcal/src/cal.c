@@ -9,6 +9,7 @@
 \*---------------------------------------------------------------------------------------------------------*/
 
 #include "math.h"
+#include <stdlib.h>
 #include "libcal.h"
 
 /*---------------------------------------------------------------------------------------------------------*/
@@ -542,6 +543,139 @@ unsigned calAverageVraw(struct cal_average_v_raw *average_v_raw, unsigned num_sa
     return(average_v_raw->num_samples_to_acq);
 }
 /*---------------------------------------------------------------------------------------------------------*/
+unsigned calAverageChannelsInit(struct cal_average_channels *average, unsigned num_channels, unsigned num_samples)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function prepares the average of num_samples samples for each of num_channels channels.  It
+  returns the number of samples to acquire per channel, or zero if num_samples or num_channels is zero or
+  num_channels is greater than CAL_AVE_MAX_CHANNELS, in which case no channels will be averaged.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    if(num_samples == 0 || num_channels == 0 || num_channels > CAL_AVE_MAX_CHANNELS)
+    {
+        num_channels = 0;
+        num_samples  = 0;
+    }
+
+    average->num_channels       = num_channels;
+    average->num_samples        = num_samples;
+    average->num_samples_to_acq = num_samples;
+
+    return(num_samples);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+unsigned calAverageChannels(struct cal_average_channels *average, const int32_t *v_raw, unsigned num_frames)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: Daily (bursts of samples from the ADC acquisition)
+
+  This function accumulates a burst of num_frames frames of interleaved raw ADC values.  Frame f holds
+  one sample for each channel in v_raw[f * num_channels] to v_raw[f * num_channels + num_channels - 1].
+  It returns the number of frames remaining.  Frames beyond the number remaining are ignored.  Once it
+  returns zero, the statistics for each channel can be read with calAverageChannelsResult():
+
+        calAverageChannelsInit(&average, num_channels, 10000);
+
+        while(calAverageChannels(&average, burst, num_frames))       // Until remaining == 0
+        {
+            ...                                                     // Acquire next burst
+        }
+
+  This replaces num_channels sequences of calls to calAverageVraw().  The sum is accumulated in 64-bit
+  integers so it cannot overflow, and the inner loop runs across the channels of a frame without
+  branches so that it can be vectorised by the compiler.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    unsigned    num_channels = average->num_channels;
+    unsigned    ch;
+    double      d_raw;
+
+    if(num_frames > average->num_samples_to_acq)
+    {
+        num_frames = average->num_samples_to_acq;
+    }
+
+    if(num_frames == 0)
+    {
+        return(average->num_samples_to_acq);
+    }
+
+    // The first frame initialises the accumulators
+
+    if(average->num_samples_to_acq == average->num_samples)
+    {
+        for(ch = 0 ; ch < num_channels ; ch++)
+        {
+            average->v_raw_0  [ch] = v_raw[ch];
+            average->v_raw_min[ch] = v_raw[ch];
+            average->v_raw_max[ch] = v_raw[ch];
+            average->sum      [ch] = 0;
+            average->sum_sq   [ch] = 0.0;
+        }
+
+        v_raw += num_channels;
+        average->num_samples_to_acq--;
+        num_frames--;
+    }
+
+    average->num_samples_to_acq -= num_frames;
+
+    // Accumulate remaining frames
+
+    while(num_frames--)
+    {
+        for(ch = 0 ; ch < num_channels ; ch++)
+        {
+            d_raw = (double)v_raw[ch] - (double)average->v_raw_0[ch];     // Exact in double
+
+            average->sum   [ch] += (int64_t)v_raw[ch] - average->v_raw_0[ch];
+            average->sum_sq[ch] += d_raw * d_raw;
+
+            average->v_raw_min[ch] = v_raw[ch] < average->v_raw_min[ch] ? v_raw[ch] : average->v_raw_min[ch];
+            average->v_raw_max[ch] = v_raw[ch] > average->v_raw_max[ch] ? v_raw[ch] : average->v_raw_max[ch];
+        }
+
+        v_raw += num_channels;
+    }
+
+    return(average->num_samples_to_acq);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void calAverageChannelsResult(const struct cal_average_channels *average, unsigned channel,
+                              struct cal_average_result *result)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function returns the statistics for one channel once calAverageChannels() has returned zero.
+  The v_raw_ave field is truncated in the same way as by calAverageVraw() so that it can be passed directly
+  to calAdcError() and the other calibration functions.  The variance is the population variance.  If
+  calAverageChannelsInit() rejected its arguments or the channel is not averaged, the result is zero.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    double      inv_num_samples;
+    double      mean_d_raw;
+
+    if(average->num_samples == 0 || channel >= average->num_channels)
+    {
+        result->v_raw_ave = 0;
+        result->v_raw_min = 0;
+        result->v_raw_max = 0;
+        result->mean      = 0.0;
+        result->variance  = 0.0;
+        return;
+    }
+
+    inv_num_samples = 1.0 / (double)average->num_samples;
+    mean_d_raw      = (double)average->sum[channel] * inv_num_samples;
+
+    result->v_raw_ave = (int32_t)(average->sum[channel] / (int64_t)average->num_samples) + average->v_raw_0[channel];
+    result->v_raw_min = average->v_raw_min[channel];
+    result->v_raw_max = average->v_raw_max[channel];
+    result->mean      = mean_d_raw + (double)average->v_raw_0[channel];
+    result->variance  = average->sum_sq[channel] * inv_num_samples - mean_d_raw * mean_d_raw;
+
+    if(result->variance < 0.0)                  // Clip rounding errors when all samples are equal
+    {
+        result->variance = 0.0;
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
 void calTempFilterInit(struct cal_temp_filter *temp_filter, float period_s, float time_constant_s)
 /*---------------------------------------------------------------------------------------------------------*\
   This function should be called once to prepare the temperature filter structure
@@ -612,6 +746,39 @@ void calDacInit(const float v_adc[CAL_NUM_ERRS], struct cal_dac *cal_dac, unsign
     cal_dac->min_v_dac = cal_dac->v_offset + (float)cal_dac->min_dac_raw / cal_dac->gain_neg;
 }
 /*---------------------------------------------------------------------------------------------------------*/
+static inline int32_t calDacRaw(const struct cal_dac *cal_dac, float v_dac, unsigned *clipped)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function converts one DAC voltage into a clipped raw value for calDacSet() and calDacSetBatch().
+  It has no branches so that the loop in calDacSetBatch() can be vectorised.  The raw value is limited in
+  floating point before it is converted to an integer so that the conversion cannot overflow.  A NaN is
+  clipped to the minimum raw value.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    float        raw;
+    int32_t      dac_raw;
+    int32_t      clipped_raw;
+
+    // Calculate raw DAC value based on calibration
+
+    v_dac -= cal_dac->v_offset;
+
+    raw = v_dac * (v_dac >= 0.0F ? cal_dac->gain_pos : cal_dac->gain_neg);
+
+    raw = raw >= CAL_DAC_RAW_F_MIN ? raw : CAL_DAC_RAW_F_MIN;         // NaN -> CAL_DAC_RAW_F_MIN
+    raw = raw <= CAL_DAC_RAW_F_MAX ? raw : CAL_DAC_RAW_F_MAX;
+
+    dac_raw = (int32_t)raw;
+
+    // Clip raw value to raw DAC range
+
+    clipped_raw = dac_raw     > cal_dac->max_dac_raw ? cal_dac->max_dac_raw : dac_raw;
+    clipped_raw = clipped_raw < cal_dac->min_dac_raw ? cal_dac->min_dac_raw : clipped_raw;
+
+    *clipped = (clipped_raw != dac_raw);
+
+    return(clipped_raw);
+}
+/*---------------------------------------------------------------------------------------------------------*/
 int32_t calDacSet(const struct cal_dac *cal_dac, float v_dac)
 /*---------------------------------------------------------------------------------------------------------*\
   This function converts the DAC voltage parameter into a raw value to be send to the DAC which it returns.
@@ -621,33 +788,325 @@ int32_t calDacSet(const struct cal_dac *cal_dac, float v_dac)
                 V_RAW = (V_DAC - V_OFFSET) x GAIN     <-->      V_DAC = V_OFFSET + V_RAW / GAIN
 \*---------------------------------------------------------------------------------------------------------*/
 {
-    int32_t      dac_raw;
+    unsigned     clipped;
 
-    // Calculate raw DAC value based on calibration
+    return(calDacRaw(cal_dac, v_dac, &clipped));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+unsigned calDacSetBatch(const struct cal_dac *cal_dac, const float *v_dac, int32_t *dac_raw, unsigned num_samples)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: DAC waveform rate
 
-    v_dac -= cal_dac->v_offset;
+  This function converts a buffer of DAC voltages into raw values.  Each value is identical to the value
+  returned by calDacSet().  The function returns the number of values that were clipped to the raw DAC range.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cal_dac  dac = *cal_dac;         // Local copy cannot alias dac_raw, so the loop can be vectorised
+    unsigned        num_clipped = 0;
+    unsigned        clipped;
+    unsigned        i;
 
-    if(v_dac >= 0.0)
+    for(i = 0 ; i < num_samples ; i++)
     {
-        dac_raw = v_dac * cal_dac->gain_pos;
+        dac_raw[i]   = calDacRaw(&dac, v_dac[i], &clipped);
+        num_clipped += clipped;
     }
-    else
+
+    return(num_clipped);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static unsigned calFastAdcChanged(const struct cal_fast *fast, const struct cal_adc *cal_adc)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function returns 1 if the ADC calibration factors differ from those used for the active bank.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(!fast->valid                                  ||
+           cal_adc->inv_gain     != fast->adc.inv_gain     ||
+           cal_adc->offset_v     != fast->adc.offset_v     ||
+           cal_adc->gain_err_pos != fast->adc.gain_err_pos ||
+           cal_adc->gain_err_neg != fast->adc.gain_err_neg);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void calFastAdcGains(const struct cal_adc *cal_adc, double adc_gain[2], struct cal_fast_bank *bank)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function calculates the ADC gain (V/raw) for positive and negative v_raw and the value of v_raw for
+  which v_adc is zero in each case.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    unsigned    raw_neg;
+
+    adc_gain[0] = (double)cal_adc->inv_gain * (1.0 - cal_adc->gain_err_pos);
+    adc_gain[1] = (double)cal_adc->inv_gain * (1.0 - cal_adc->gain_err_neg);
+
+    for(raw_neg = 0 ; raw_neg < 2 ; raw_neg++)
     {
-        dac_raw = v_dac * cal_dac->gain_neg;
+        bank->v_raw_zero[raw_neg] = cal_adc->offset_v / adc_gain[raw_neg];
     }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void calFastSwitchBank(struct cal_fast *fast)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function makes the bank prepared by calFastCurrentFactors() or calFastVoltageFactors() active.
+  The bank must be complete in memory before the real-time thread can see the new index.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+#if defined(__GNUC__)
+    __atomic_store_n(&fast->active_bank, fast->active_bank ^ 1, __ATOMIC_RELEASE);
+#else
+    *(volatile unsigned *)&fast->active_bank = fast->active_bank ^ 1;
+#endif
+    fast->valid = 1;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void calFastInit(struct cal_fast *fast)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function should be called once to prepare the cached composite calibration.  calFastMeas() must
+  not be called until calFastCurrentFactors() or calFastVoltageFactors() has been called.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    fast->active_bank = 0;
+    fast->valid       = 0;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+unsigned calFastCurrentFactors(const struct cal_dcct *cal_dcct, const struct cal_adc *cal_adc, struct cal_fast *fast)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: ~1 s (after calAdcFactors() and calDcctFactors())
 
-    // Clip raw value to raw DAC range
+  This function combines the ADC and DCCT calibration factors into a single gain and offset for each
+  combination of the signs of v_raw and v_adc, as used by calCurrent():
+
+        i_dcct = GAIN[v_raw < 0][v_adc < 0] x V_RAW + OFFSET[v_raw < 0][v_adc < 0]
 
-    if(dac_raw > cal_dac->max_dac_raw)
+  The transform is only recalculated if the factors have changed since the last call, which is normally
+  when the filtered temperature changes or after a calibration.  It is written into the inactive bank
+  before the bank used by calFastMeas() is switched, so this can be called from a background thread.  It
+  returns 1 if the transform was recalculated.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cal_fast_bank *bank = &fast->bank[fast->active_bank ^ 1];
+    double                adc_gain[2];
+    double                dcct_gain;
+    unsigned              raw_neg;
+    unsigned              adc_neg;
+
+    if(!calFastAdcChanged(fast, cal_adc)                  &&
+        cal_dcct->inv_gain     == fast->dcct.inv_gain     &&
+        cal_dcct->offset_v     == fast->dcct.offset_v     &&
+        cal_dcct->gain_err_pos == fast->dcct.gain_err_pos &&
+        cal_dcct->gain_err_neg == fast->dcct.gain_err_neg)
     {
-	dac_raw = cal_dac->max_dac_raw;
+        return(0);
     }
-    else if(dac_raw < cal_dac->min_dac_raw)
+
+    calFastAdcGains(cal_adc, adc_gain, bank);
+
+    // i_dcct = DCCT_INV_GAIN x ((ADC_GAIN x V_RAW - ADC_OFFSET) x (1 - DCCT_GAIN_ERR) - DCCT_OFFSET)
+
+    for(adc_neg = 0 ; adc_neg < 2 ; adc_neg++)
+    {
+        dcct_gain = (double)cal_dcct->inv_gain * (1.0 - (adc_neg ? cal_dcct->gain_err_neg : cal_dcct->gain_err_pos));
+
+        for(raw_neg = 0 ; raw_neg < 2 ; raw_neg++)
+        {
+            bank->gain  [raw_neg][adc_neg] = dcct_gain * adc_gain[raw_neg];
+            bank->offset[raw_neg][adc_neg] = -(dcct_gain * cal_adc->offset_v +
+                                               (double)cal_dcct->inv_gain * cal_dcct->offset_v);
+        }
+    }
+
+    fast->adc  = *cal_adc;
+    fast->dcct = *cal_dcct;
+
+    calFastSwitchBank(fast);
+
+    return(1);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+unsigned calFastVoltageFactors(const struct cal_v_meas *cal_v_meas, const struct cal_adc *cal_adc, struct cal_fast *fast)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: ~1 s (after calAdcFactors())
+
+  This function combines the ADC and voltage measurement calibration factors into a single gain and offset
+  for each sign of v_raw, as used by calVoltage().  As with calFastCurrentFactors(), the transform is only
+  recalculated if the factors have changed and the function returns 1 if it was recalculated.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct cal_fast_bank *bank = &fast->bank[fast->active_bank ^ 1];
+    double                adc_gain[2];
+    unsigned              raw_neg;
+    unsigned              adc_neg;
+
+    if(!calFastAdcChanged(fast, cal_adc) && cal_v_meas->inv_gain == fast->v_meas.inv_gain)
     {
-	dac_raw = cal_dac->min_dac_raw;
+        return(0);
     }
 
-    return(dac_raw);
+    calFastAdcGains(cal_adc, adc_gain, bank);
+
+    // v_meas = V_MEAS_INV_GAIN x (ADC_GAIN x V_RAW - ADC_OFFSET) - the sign of v_adc is not used
+
+    for(raw_neg = 0 ; raw_neg < 2 ; raw_neg++)
+    {
+        for(adc_neg = 0 ; adc_neg < 2 ; adc_neg++)
+        {
+            bank->gain  [raw_neg][adc_neg] =  (double)cal_v_meas->inv_gain * adc_gain[raw_neg];
+            bank->offset[raw_neg][adc_neg] = -(double)cal_v_meas->inv_gain * cal_adc->offset_v;
+        }
+    }
+
+    fast->adc    = *cal_adc;
+    fast->v_meas = *cal_v_meas;
+
+    calFastSwitchBank(fast);
+
+    return(1);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static double calInlInterp(const double *x, const double *y, unsigned i0, unsigned i1, double x_interp)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function interpolates linearly between points i0 and i1 (extrapolating if x_interp is outside).
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(y[i0] + (y[i1] - y[i0]) * (x_interp - x[i0]) / (x[i1] - x[i0]));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+unsigned calInlInit(struct cal_inl *inl,                    // Returned INL correction table
+                    unsigned        num_points,             // Number of calibration points (2 - CAL_INL_MAX_SEGS+1)
+                    const int32_t  *v_raw_meas,             // Average v_raw measured for each point (increasing)
+                    const int32_t  *v_raw_ideal,            // Ideal v_raw for each point
+                    int32_t         v_raw_min,              // v_raw at the start of the table
+                    unsigned        shift,                  // Segment length is 2^shift raw counts
+                    unsigned        num_segs)               // Number of segments (1 - CAL_INL_MAX_SEGS)
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: Annual or Daily (background)
+
+  This function builds the INL correction table for an ADC from multi-point calibration data.  For each
+  point, the ADC measures a known input for which the ideal raw value is v_raw_ideal and the average raw
+  value v_raw_meas is supplied (e.g. from calAverageChannels()).
+
+  The offset and gain errors are corrected by the normal calibration at zero, +CAL_V_NOMINAL and
+  -CAL_V_NOMINAL, so the error at the lowest point, the point nearest to zero and the highest point is
+  removed and only the remaining non-linearity goes into the table.  If the points include these three
+  calibration inputs, the correction is therefore zero where the ADC is calibrated.
+
+  The table starts at v_raw_min and has num_segs segments of 2^shift raw counts.  The non-linearity is
+  interpolated linearly between the points and held at the end values outside them.  The function returns
+  num_segs, or zero if the parameters are invalid or v_raw_meas does not increase strictly.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    double      x[CAL_INL_MAX_SEGS + 1];        // Measured raw values
+    double      y[CAL_INL_MAX_SEGS + 1];        // Errors, then non-linearity
+    double      node_corr[CAL_INL_MAX_SEGS + 1];
+    double      x_node;
+    double      seg_len;
+    unsigned    zero_idx = 0;
+    unsigned    hi_idx   = num_points - 1;
+    unsigned    i;
+    unsigned    k;
+
+    if(num_points < 2 || num_points > CAL_INL_MAX_SEGS + 1 ||
+       num_segs   < 1 || num_segs   > CAL_INL_MAX_SEGS     || shift > 30)
+    {
+        return(0);
+    }
+
+    seg_len = (double)(1 << shift);
+
+    // Calculate errors and find the point nearest to zero
+
+    for(i = 0 ; i < num_points ; i++)
+    {
+        if(i > 0 && v_raw_meas[i] <= v_raw_meas[i-1])
+        {
+            return(0);
+        }
+
+        x[i] = (double)v_raw_meas[i];
+        y[i] = (double)v_raw_meas[i] - (double)v_raw_ideal[i];
+
+        if(abs(v_raw_ideal[i]) < abs(v_raw_ideal[zero_idx]))
+        {
+            zero_idx = i;
+        }
+    }
+
+    // Remove the errors corrected by the calibration - a line through the end points if zero is at one end
+
+    if(zero_idx == 0 || zero_idx == hi_idx)
+    {
+        zero_idx = hi_idx;
+    }
+
+    for(i = 0 ; i < num_points ; i++)
+    {
+        // The reference line for each point is calculated before y[zero_idx] and y[hi_idx] are modified
+
+        node_corr[i] = i <= zero_idx ? calInlInterp(x, y, 0,        zero_idx, x[i])
+                                     : calInlInterp(x, y, zero_idx, hi_idx,   x[i]);
+    }
+
+    for(i = 0 ; i < num_points ; i++)
+    {
+        y[i] -= node_corr[i];
+    }
+
+    // Interpolate the non-linearity at the start of each segment and at the end of the table
+
+    for(k = 0, i = 0 ; k <= num_segs ; k++)
+    {
+        x_node = (double)v_raw_min + (double)k * seg_len;
+
+        while(i < hi_idx - 1 && x_node > x[i + 1])
+        {
+            i++;
+        }
+
+        node_corr[k] = x_node <= x[0]      ? y[0]
+                     : x_node >= x[hi_idx] ? y[hi_idx]
+                     : calInlInterp(x, y, i, i + 1, x_node);
+    }
+
+    inl->v_raw_min   = v_raw_min;
+    inl->shift       = shift;
+    inl->max_seg_idx = num_segs - 1;
+
+    for(k = 0 ; k < num_segs ; k++)
+    {
+        inl->seg[k].corr  = node_corr[k];
+        inl->seg[k].slope = (node_corr[k + 1] - node_corr[k]) / seg_len;
+    }
+
+    return(num_segs);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void calFastMeasBatch(const struct cal_fast *fast,          // Composite calibration
+                      const struct cal_inl  *inl,           // INL correction table (NULL if not required)
+                      const int32_t         *v_raw,         // Raw ADC values
+                      float                 *meas,          // Returned measurements
+                      unsigned               num_samples)   // Number of samples
+/*---------------------------------------------------------------------------------------------------------*\
+  Timescale: 0.05 - 1 ms (blocks of samples from the ADC acquisition)
+
+  This function converts a buffer of raw ADC values with calFastMeas(), or with calFastMeasInl() if inl is
+  not NULL.  The cost per sample is bounded and does not depend on the values.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    unsigned    i;
+
+    if(inl == NULL)
+    {
+        for(i = 0 ; i < num_samples ; i++)
+        {
+            meas[i] = calFastMeas(fast, v_raw[i]);
+        }
+    }
+    else
+    {
+        for(i = 0 ; i < num_samples ; i++)
+        {
+            meas[i] = calFastMeasInl(fast, inl, v_raw[i]);
+        }
+    }
 }
 /*---------------------------------------------------------------------------------------------------------*\
   End of file: cal.c
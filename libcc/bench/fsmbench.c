@@ -0,0 +1,301 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     fsmbench.c                                                                  Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Benchmark of the power converter state machine iteration cost
+
+  Notes:    The compiled state machine is compared with a scan of per-transition condition functions in
+            the style of the FGC state machine in libcc/resources.  First, the next states must agree
+            for random states and condition words.  Then each state is timed with a set of condition
+            words, repeating each pair many times, and the mean and worst-case cost of an iteration are
+            reported for both.  Each pair is timed as the best of several trials, which excludes
+            interrupts, so the worst case is that of the code rather than of the machine.
+
+            Usage: fsmbench [number of random pairs to check]
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "libcc.h"
+
+// Constants
+
+#define DEFAULT_NUM_ITERS       1000000                 // Random pairs checked against the scan
+#define NUM_CONDS               64                      // Condition words timed from each state
+#define NUM_REPEATS             4000                    // Iterations timed for each state and condition
+#define NUM_TRIALS              5                       // Trials for each state and condition (best is kept)
+
+// Condition functions in the style of transitions_class.c
+
+static uint32_t cond;
+
+#define Test(mask)              ((cond & (mask)) != 0)
+
+static uint32_t OFtoFO(void) { return(Test(CC_PC_PWR_FAILURE) || Test(CC_PC_FLT_FAST_ABORT | CC_PC_FLT_NO_PC_PERMIT)); }
+static uint32_t FStoFO(void) { return(!Test(CC_PC_VS_POWER_ON) && Test(CC_PC_FIRST_FAULTS)); }
+static uint32_t FOtoOF(void) { return(!(Test(CC_PC_PWR_FAILURE) || Test(CC_PC_FLT_FAST_ABORT | CC_PC_FLT_NO_PC_PERMIT))); }
+static uint32_t SPtoOF(void) { return(!Test(CC_PC_STOP) && !Test(CC_PC_VS_POWER_ON)); }
+static uint32_t STtoFS(void) { return(Test(CC_PC_PWR_FAILURE) || Test(CC_PC_FLT_FAST_ABORT | CC_PC_FLT_NO_PC_PERMIT)); }
+static uint32_t XXtoFS(void) { return(Test(CC_PC_PWR_FAILURE | CC_PC_FAST_ABORT) || (!Test(CC_PC_VS_READY) && Test(CC_PC_FLT_NO_PC_PERMIT))); }
+static uint32_t STtoSP(void) { return(Test(CC_PC_STOP) || (!Test(CC_PC_START) && !Test(CC_PC_VS_RUN))); }
+static uint32_t XXtoSP(void) { return(Test(CC_PC_STOP) || !Test(CC_PC_VS_READY) || !Test(CC_PC_VS_RUN)); }
+static uint32_t OFtoST(void) { return(Test(CC_PC_START)); }
+static uint32_t XXtoSA(void) { return(Test(CC_PC_INTLK_SPARE) || Test(CC_PC_SLOW_ABORT_REQ)); }
+static uint32_t STtoTS(void) { return(Test(CC_PC_VS_POWER_ON) && Test(CC_PC_VS_READY)); }
+static uint32_t XXtoTS(void) { return(Test(CC_PC_TO_STANDBY_REQ) && !Test(CC_PC_CYCLING_REQ)); }
+static uint32_t TStoSB(void) { return(!Test(CC_PC_TO_STANDBY_REQ)); }
+static uint32_t TStoAB(void) { return(Test(CC_PC_ABORTING_REQ)); }
+static uint32_t SBtoIL(void) { return(Test(CC_PC_IDLE_REQ)); }
+static uint32_t ARtoIL(void) { return(Test(CC_PC_IDLE_REQ)); }
+static uint32_t RNtoIL(void) { return(!Test(CC_PC_RUNNING_REQ)); }
+static uint32_t ABtoIL(void) { return(!Test(CC_PC_ABORTING_REQ)); }
+static uint32_t SAtoAB(void) { return(Test(CC_PC_ABORTING_REQ)); }
+static uint32_t ILtoAR(void) { return(Test(CC_PC_ARMED_REQ)); }
+static uint32_t ILtoTC(void) { return(Test(CC_PC_TO_CYCLING_REQ)); }
+static uint32_t ARtoRN(void) { return(Test(CC_PC_RUNNING_REQ)); }
+static uint32_t RNtoAB(void) { return(Test(CC_PC_ABORTING_REQ)); }
+static uint32_t SBtoTC(void) { return(Test(CC_PC_TO_CYCLING_REQ)); }
+static uint32_t TCtoCY(void) { return(Test(CC_PC_CYCLING_REQ)); }
+
+// Transition lists in the style of transitions_class.h - the leftmost transition is checked first, as by the
+// scan of pc_states[STATE_PC].trans in resources/pc_fsm.c
+
+struct scan_trans
+{
+    uint32_t    (*condition)(void);
+    uint32_t    next_state;
+};
+
+#define T(func, state)          { func, CC_PC_##state }
+#define XX_IL_UP                T(XXtoFS, FLT_STOPPING), T(XXtoSP, STOPPING), T(XXtoSA, SLOW_ABORT), T(XXtoTS, TO_STANDBY)
+
+static const struct scan_trans trans_FO[] = { T(FOtoOF, OFF) };
+static const struct scan_trans trans_OF[] = { T(OFtoFO, FLT_OFF), T(OFtoST, STARTING) };
+static const struct scan_trans trans_FS[] = { T(FStoFO, FLT_OFF) };
+static const struct scan_trans trans_SP[] = { T(XXtoFS, FLT_STOPPING), T(SPtoOF, OFF) };
+static const struct scan_trans trans_ST[] = { T(STtoFS, FLT_STOPPING), T(STtoSP, STOPPING), T(STtoTS, TO_STANDBY) };
+static const struct scan_trans trans_SA[] = { T(XXtoFS, FLT_STOPPING), T(XXtoSP, STOPPING), T(SAtoAB, ABORTING) };
+static const struct scan_trans trans_TS[] = { T(XXtoFS, FLT_STOPPING), T(XXtoSP, STOPPING), T(XXtoSA, SLOW_ABORT),
+                                              T(TStoAB, ABORTING), T(TStoSB, ON_STANDBY) };
+static const struct scan_trans trans_SB[] = { T(XXtoFS, FLT_STOPPING), T(XXtoSP, STOPPING), T(XXtoSA, SLOW_ABORT),
+                                              T(SBtoIL, IDLE), T(SBtoTC, TO_CYCLING) };
+static const struct scan_trans trans_IL[] = { XX_IL_UP, T(ILtoAR, ARMED), T(ILtoTC, TO_CYCLING) };
+static const struct scan_trans trans_TC[] = { XX_IL_UP, T(TCtoCY, CYCLING) };
+static const struct scan_trans trans_AR[] = { XX_IL_UP, T(ARtoIL, IDLE), T(ARtoRN, RUNNING) };
+static const struct scan_trans trans_RN[] = { XX_IL_UP, T(RNtoIL, IDLE), T(RNtoAB, ABORTING) };
+static const struct scan_trans trans_AB[] = { XX_IL_UP, T(ABtoIL, IDLE) };
+static const struct scan_trans trans_CY[] = { XX_IL_UP };
+
+#define ArrayLen(arr)           (sizeof(arr) / sizeof(arr[0]))
+#define STATE(xx)               { ArrayLen(trans_##xx), trans_##xx }
+
+static const struct
+{
+    uint32_t                    n_trans;
+    const struct scan_trans    *trans;
+} scan_states[CC_PC_NUM_STATES] =
+{
+    STATE(FO), STATE(OF), STATE(FS), STATE(SP), STATE(ST), STATE(SA), STATE(TS),
+    STATE(SB), STATE(IL), STATE(TC), STATE(AR), STATE(RN), STATE(AB), STATE(CY),
+};
+
+/*---------------------------------------------------------------------------------------------------------*/
+static uint32_t ScanRT(uint32_t state)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    const struct scan_trans *trans = scan_states[state].trans;
+    uint32_t                 num_trans;
+
+    for(num_trans = scan_states[state].n_trans ; num_trans && !trans->condition() ; num_trans--, trans++);
+
+    return(num_trans ? trans->next_state : state);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static inline uint64_t Ns(void)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return((uint64_t)t.tv_sec * 1000000000 + t.tv_nsec);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static uint32_t CompiledEngine(struct cc_fsm *fsm, uint32_t state, uint32_t pair_cond)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    fsm->state = state;
+
+    return(ccFsmRT(fsm, pair_cond));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static uint32_t ScanEngine(struct cc_fsm *fsm, uint32_t state, uint32_t pair_cond)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    cond = pair_cond;
+
+    return(ScanRT(state));
+}
+
+// Both engines are called through volatile pointers so that neither can be inlined into the timing loop
+
+static uint32_t (* volatile engine[2])(struct cc_fsm *fsm, uint32_t state, uint32_t pair_cond) =
+{
+    CompiledEngine,
+    ScanEngine
+};
+
+volatile uint32_t fsmbench_sink;
+
+/*---------------------------------------------------------------------------------------------------------*/
+static double TimePair(struct cc_fsm *fsm, uint32_t engine_idx, uint32_t state, uint32_t pair_cond)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function returns the time in ns of one iteration from state with the condition word pair_cond.
+  The state is restored before each iteration so that every iteration does the same work.  The time is
+  the best of NUM_TRIALS means over NUM_REPEATS iterations, to exclude preemption of the benchmark.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint32_t    next_states = 0;
+    uint32_t    trial;
+    uint32_t    i;
+    uint64_t    t0;
+    double      ns;
+    double      min_ns = 1.0E30;
+
+    for(trial = 0 ; trial < NUM_TRIALS ; trial++)
+    {
+        t0 = Ns();
+
+        for(i = 0 ; i < NUM_REPEATS ; i++)
+        {
+            next_states += engine[engine_idx](fsm, state, pair_cond);
+        }
+
+        ns = (double)(Ns() - t0) / NUM_REPEATS;
+
+        if(ns < min_ns)
+        {
+            min_ns = ns;
+        }
+    }
+
+    fsmbench_sink = next_states;
+
+    return(min_ns);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    static const char  *label[2] = { "compiled", "scan" };
+    static struct cc_fsm fsm;
+    uint32_t            num_iters = argc > 1 ? strtoul(argv[1], NULL, 0) : DEFAULT_NUM_ITERS;
+    uint32_t            conds[NUM_CONDS];
+    uint32_t            num_errors = 0;
+    uint32_t            scan_state;
+    uint32_t            state;
+    uint32_t            i;
+    uint32_t            j;
+    double              ns;
+    double              sum_ns[2]    = { 0.0, 0.0 };
+    double              max_ns[2]    = { 0.0, 0.0 };
+    uint32_t            max_state[2] = { 0, 0 };
+    uint32_t            max_cond[2]  = { 0, 0 };
+
+    if(ccFsmInit(&fsm, &cc_pc_fsm_table, CC_PC_OFF, NULL, NULL) != CC_FSM_OK)
+    {
+        fputs("ccFsmInit failed\n", stderr);
+        exit(1);
+    }
+
+    srand(1);
+
+    // Check the compiled table against the scan from random states with random conditions
+
+    for(i = 0 ; i < num_iters ; i++)
+    {
+        cond       = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        state      = rand() % CC_PC_NUM_STATES;
+        fsm.state  = state;
+        scan_state = ScanRT(state);
+
+        if(ccFsmRT(&fsm, cond) != scan_state && num_errors++ < 10)
+        {
+            printf("Mismatch: state %.2s cond 0x%08X: table %.2s scan %.2s\n",
+                   &cc_pc_fsm_table.state_names[2 * state], cond,
+                   &cc_pc_fsm_table.state_names[2 * fsm.state],
+                   &cc_pc_fsm_table.state_names[2 * scan_state]);
+        }
+    }
+
+    printf("%u random (state, condition) pairs: %u mismatches\n\n", num_iters, num_errors);
+
+    // Time each state with conditions that include no bits, all bits and, if it can be found,
+    // a condition that fires no transition so the scan must check them all
+
+    for(state = 0 ; state < CC_PC_NUM_STATES ; state++)
+    {
+        conds[0] = 0;
+        conds[1] = ~0;
+
+        for(i = 2 ; i < NUM_CONDS ; i++)
+        {
+            conds[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        }
+
+        for(i = 0 ; i < 100000 ; i++)
+        {
+            cond = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+
+            if(ScanRT(state) == state)
+            {
+                conds[2] = cond;
+                break;
+            }
+        }
+
+        for(i = 0 ; i < NUM_CONDS ; i++)
+        {
+            for(j = 0 ; j < 2 ; j++)
+            {
+                ns         = TimePair(&fsm, j, state, conds[i]);
+                sum_ns[j] += ns;
+
+                if(ns > max_ns[j])
+                {
+                    max_ns[j]    = ns;
+                    max_state[j] = state;
+                    max_cond[j]  = conds[i];
+                }
+            }
+        }
+    }
+
+    printf("Iteration cost over %u states x %u conditions (best of %u x %u repeats, no state functions)\n\n",
+           CC_PC_NUM_STATES, NUM_CONDS, NUM_TRIALS, NUM_REPEATS);
+
+    for(j = 0 ; j < 2 ; j++)
+    {
+        printf("%-10s mean %6.2f ns   worst %6.2f ns (state %.2s cond 0x%08X)\n", label[j],
+               sum_ns[j] / (CC_PC_NUM_STATES * NUM_CONDS), max_ns[j],
+               &cc_pc_fsm_table.state_names[2 * max_state[j]], max_cond[j]);
+    }
+
+    return(num_errors > 0);
+}
+// EOF
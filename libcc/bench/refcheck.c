@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     refcheck.c                                                                  Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Check of the reference manager arm, start, replay and abort behaviour
+
+  Notes:    A TABLE function is armed for one cycle selector and played through the run delay, the
+            function and the coast after the end.  It is then played again without re-arming, re-armed
+            while it is running, and aborted with a ramp.  Each check prints a line and the program
+            returns the number of failed checks.
+
+            Usage: refcheck
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "libcc.h"
+#include "libfg/table.h"
+
+// Constants
+
+#define RUN_DELAY               0.5                     // Run delay (s)
+#define CYC_SEL                 3                       // Cycle selector used for the checks
+#define TOLERANCE               1.0E-5                  // Tolerance on reference values
+
+// Reference manager and its double-buffered TABLE parameters
+
+static struct cc_ref    ref_mgr;
+static struct fg_table  table_pars[2 * CC_REF_NUM_CYC_SELS];
+static uint32_t         num_errors;
+
+// Table functions
+
+static float            table1_time[] = { 0.0, 1.0, 2.0 };
+static float            table1_ref [] = { 1.0, 3.0, 3.0 };
+static float            table2_time[] = { 0.0, 1.0 };
+static float            table2_ref [] = { 1.0, 5.0 };
+
+/*---------------------------------------------------------------------------------------------------------*/
+static void Check(const char *label, bool is_ok)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    printf("%-60s %s\n", label, is_ok ? "ok" : "FAILED");
+
+    if(!is_ok)
+    {
+        num_errors++;
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static bool CheckRef(double time, float exp_ref, enum reg_mode exp_reg_mode, enum cc_ref_state exp_state)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function calls ccRef() at time and returns true if the reference, regulation mode and state are
+  as expected.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    float          ref;
+    enum reg_mode  reg_mode = ccRef(&ref_mgr, time, &ref);
+
+    return(fabs(ref - exp_ref) < TOLERANCE && reg_mode == exp_reg_mode && ref_mgr.state == exp_state);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static enum fg_error Arm(uint32_t cyc_sel, float *time, float *ref, uint32_t num_points, double delay)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function arms a TABLE function in the free buffer of cyc_sel, in the way a background thread would.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    struct fg_table *pars = ccRefArmPars(&ref_mgr, cyc_sel);
+    struct fg_meta   meta;
+
+    if(pars == NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    pars->ref  = NULL;
+    pars->time = NULL;
+
+    fgTableInit(NULL, false, false, delay, 0.1, ref, num_points, time, num_points, pars, &meta);
+
+    return(ccRefArm(&ref_mgr, cyc_sel, (fg_gen_func)fgTableGen, REG_CURRENT, &meta));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+int main(void)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    ccRefInit(&ref_mgr, table_pars, sizeof(struct fg_table), RUN_DELAY, 0.0);
+
+    // Idle reference manager holds the initial reference in voltage mode
+
+    Check("idle before arming",                    CheckRef(0.0, 0.0, REG_VOLTAGE, CC_REF_IDLE));
+    Check("start without an armed function fails", ccRefStartRT(&ref_mgr, CYC_SEL, 1.0) == false);
+
+    // Arming
+
+    Check("arm with a libfg delay is rejected",    Arm(CYC_SEL, table1_time, table1_ref, 3, 0.1) == FG_BAD_PARAMETER);
+    Check("arm TABLE 1",                           Arm(CYC_SEL, table1_time, table1_ref, 3, 0.0) == FG_OK);
+    Check("arm again before the start fails",      ccRefArmPars(&ref_mgr, CYC_SEL) == NULL);
+
+    // Start at t=10 and play the run delay, the function and the coast
+
+    Check("start TABLE 1 at t=10",                 ccRefStartRT(&ref_mgr, CYC_SEL, 10.0));
+    Check("run delay holds the initial ref",       CheckRef(10.1, 1.0, REG_CURRENT, CC_REF_RUN_DELAY));
+    Check("function starts after the run delay",   CheckRef(10.5, 1.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("function mid-segment",                  CheckRef(11.0, 2.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("function plateau",                      CheckRef(12.0, 3.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("idle after the end holds the last ref", CheckRef(13.0, 3.0, REG_CURRENT, CC_REF_IDLE));
+
+    // Replay the same function without re-arming, and re-arm while it is running
+
+    Check("replay TABLE 1 at t=20",                ccRefStartRT(&ref_mgr, CYC_SEL, 20.0));
+    Check("replay mid-segment",                    CheckRef(21.0, 2.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("arm TABLE 2 while TABLE 1 runs",        Arm(CYC_SEL, table2_time, table2_ref, 2, 0.0) == FG_OK);
+    Check("running function is unchanged",         CheckRef(22.0, 3.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("TABLE 1 ends",                          CheckRef(23.0, 3.0, REG_CURRENT, CC_REF_IDLE));
+    Check("start TABLE 2 at t=30",                 ccRefStartRT(&ref_mgr, CYC_SEL, 30.0));
+    Check("TABLE 2 mid-segment",                   CheckRef(31.0, 3.0, REG_CURRENT, CC_REF_RUNNING));
+
+    // Abort TABLE 2 with a ramp to zero
+
+    ccRefAbortRT(&ref_mgr, 31.0, 3.0, 4.0, false, false, 0.0, 10.0, 10.0, 10.0);
+
+    Check("abort ramp is running",                 CheckRef(31.1, 3.35, REG_CURRENT, CC_REF_ABORTING));
+    Check("start while aborting fails",            ccRefStartRT(&ref_mgr, CYC_SEL, 31.2) == false);
+    Check("abort ramp ends at the final ref",      CheckRef(40.0, 0.0, REG_CURRENT, CC_REF_IDLE));
+
+    // Once idle, TABLE 2 can be played again
+
+    Check("replay TABLE 2 after the abort",        ccRefStartRT(&ref_mgr, CYC_SEL, 50.0));
+    Check("TABLE 2 replay mid-segment",            CheckRef(51.25, 4.0, REG_CURRENT, CC_REF_RUNNING));
+    Check("TABLE 2 replay ends",                   CheckRef(52.0, 5.0, REG_CURRENT, CC_REF_IDLE));
+
+    printf("\n%u failed checks\n", num_errors);
+
+    return(num_errors > 0);
+}
+// EOF
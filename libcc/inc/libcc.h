@@ -32,6 +32,9 @@
 #include <libfg.h>
 #include <libreg.h>
 #include <libcc/ref.h>
+#include <libcc/fsm.h>
+#include <libcc/pc_fsm.h>
+#include <libcc/event.h>
 
 #endif // LIBCC_H
 // EOF
@@ -0,0 +1,92 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     libcc/event.h                                                             Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Timing event scheduler header file
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    Timing events (cycle start, run delay, dynamic economy, abort, ...) are scheduled on the
+            iteration tick at which they must be delivered.  The scheduler is a hierarchical timer wheel
+            with CC_EVENT_LEVELS levels of CC_EVENT_SLOTS slots.  Level 0 has one slot per tick and each
+            higher level has one slot per turn of the level below.  When level 0 turns, the events of
+            the next slot of level 1 are spread into level 0, and so on up the levels.
+
+            ccEventRT() is called once per iteration.  It only visits the slot of the current tick, so
+            its cost depends on the number of events that are due and not on the number pending.  Each
+            event is moved down at most CC_EVENT_LEVELS-1 times before it is delivered.
+
+            The events belong to the application and are linked into the wheel, so the scheduler never
+            allocates memory.  Events must only be added, cancelled and delivered by one thread.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef LIBCC_EVENT_H
+#define LIBCC_EVENT_H
+
+// Include header files
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Constants
+
+#define CC_EVENT_SLOT_BITS          6                               ///< Slots per level is 2^CC_EVENT_SLOT_BITS
+#define CC_EVENT_SLOTS              (1u << CC_EVENT_SLOT_BITS)      ///< Number of slots per level
+#define CC_EVENT_SLOT_MASK          (CC_EVENT_SLOTS - 1)            ///< Mask for the slot index in a level
+#define CC_EVENT_LEVELS             4                               ///< Levels cover 2^24 ticks before an event is re-queued
+
+struct cc_event_sched;
+
+// Timing event
+
+struct cc_event                                         ///< Timing event supplied by the application
+{
+    struct cc_event            *next;                   ///< Next event in the same slot
+    struct cc_event           **pprev;                  ///< Link to this event in its list (NULL if not scheduled - must be zero initially)
+    uint32_t                    tick;                   ///< Tick at which the event is delivered
+    void                      (*func)(struct cc_event_sched *sched, struct cc_event *event);  ///< Event function
+    void                       *data;                   ///< Application data for the event function (not used by libcc)
+};
+
+// Timing event scheduler
+
+struct cc_event_sched                                   ///< Timing event scheduler
+{
+    uint32_t                    tick;                   ///< Next tick to be processed by ccEventRT()
+    uint32_t                    num_pending;            ///< Number of events scheduled
+    void                       *user;                   ///< User data for the event functions (not used by libcc)
+    struct cc_event            *due;                    ///< Events being delivered by ccEventRT()
+    struct cc_event            *slot[CC_EVENT_LEVELS][CC_EVENT_SLOTS];  ///< Event lists
+};
+
+// Timing event scheduler functions
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void     ccEventInit        (struct cc_event_sched *sched, uint32_t tick, void *user);
+void     ccEventAddRT       (struct cc_event_sched *sched, struct cc_event *event, uint32_t tick);
+void     ccEventCancelRT    (struct cc_event_sched *sched, struct cc_event *event);
+uint32_t ccEventRT          (struct cc_event_sched *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBCC_EVENT_H
+// EOF
@@ -0,0 +1,118 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     libcc/fsm.h                                                               Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Table-driven state machine header file
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    A state machine is described by a table of transitions.  Each transition lists the states
+            from which it is checked (as a mask) and a condition on a 32-bit condition word that the
+            application prepares once per iteration.  The condition is true if:
+
+                ((cond ^ any_invert) & any_mask) != 0  ||  (cond & all_mask) == all_value
+
+            so it can test for any bit set or clear, or for a combination of bits.  The order of the
+            table gives the priority when more than one transition from a state is true.
+
+            ccFsmInit() compiles the table into one row per state.  ccFsmRT() then evaluates every
+            transition in the row of the current state without branches and takes the first that is
+            true, so the cost of an iteration is the same whatever the state and conditions.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef LIBCC_FSM_H
+#define LIBCC_FSM_H
+
+// Include header files
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Constants
+
+#define CC_FSM_MAX_STATES           32                  ///< States are identified by bits in from_states
+#define CC_FSM_MAX_STATE_TRANS      8                   ///< Maximum number of transitions from one state
+#define CC_FSM_STATE(state)         (1u << (state))     ///< Bit for state in cc_fsm_trans::from_states
+
+// Errors returned by ccFsmInit()
+
+enum cc_fsm_error
+{
+    CC_FSM_OK,
+    CC_FSM_BAD_STATE,                                   ///< A state is out of range
+    CC_FSM_TOO_MANY_TRANS,                              ///< More than CC_FSM_MAX_STATE_TRANS from one state
+};
+
+struct cc_fsm;
+
+// Transition table
+
+struct cc_fsm_trans                                     ///< Transition - one entry in the table
+{
+    uint32_t                    from_states;            ///< Mask of states from which the transition is checked
+    uint32_t                    to_state;               ///< Next state
+    uint32_t                    any_mask;               ///< True if any of these bits of cond^any_invert is set
+    uint32_t                    any_invert;             ///< Bits of any_mask that are true when clear
+    uint32_t                    all_mask;               ///< Or true if these bits of cond ...
+    uint32_t                    all_value;              ///< ... are equal to all_value (use all_mask 0 and all_value 1 for never)
+};
+
+struct cc_fsm_table                                     ///< State machine description
+{
+    uint32_t                    num_states;             ///< Number of states (up to CC_FSM_MAX_STATES)
+    const char                 *state_names;            ///< Two-character name for each state
+    uint32_t                    num_trans;              ///< Number of transitions in trans[]
+    const struct cc_fsm_trans  *trans;                  ///< Transitions in order of priority
+};
+
+// Compiled state machine
+
+struct cc_fsm_row                                       ///< Compiled transitions from one state, padded with transitions that are never true
+{
+    uint32_t                    any_mask  [CC_FSM_MAX_STATE_TRANS];
+    uint32_t                    any_invert[CC_FSM_MAX_STATE_TRANS];
+    uint32_t                    all_mask  [CC_FSM_MAX_STATE_TRANS];
+    uint32_t                    all_value [CC_FSM_MAX_STATE_TRANS];
+    uint8_t                     to_state  [CC_FSM_MAX_STATE_TRANS];
+};
+
+struct cc_fsm                                           ///< State machine
+{
+    uint32_t                    state;                  ///< Current state
+    uint32_t                    state_iters;            ///< Iterations since the current state was entered
+    const struct cc_fsm_table  *table;                  ///< Table from which the state machine was compiled
+    void                       *user;                   ///< User data for the state functions (not used by libcc)
+    void                      (*state_func[CC_FSM_MAX_STATES])(struct cc_fsm *fsm, bool first_f); ///< State functions (may be NULL)
+    struct cc_fsm_row           row[CC_FSM_MAX_STATES]; ///< Compiled transitions for each state
+};
+
+// State machine functions
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum cc_fsm_error ccFsmInit   (struct cc_fsm *fsm, const struct cc_fsm_table *table, uint32_t initial_state,
+                               void (* const *state_func)(struct cc_fsm *fsm, bool first_f), void *user);
+uint32_t          ccFsmRT     (struct cc_fsm *fsm, uint32_t cond);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBCC_FSM_H
+// EOF
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     libcc/pc_fsm.h                                                            Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Power converter state machine header file
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    The states and transitions are those of the FGC power converter state machine (see
+            libcc/resources).  The application sets the condition bits from its digital inputs,
+            faults and state flags once per iteration and passes them to ccFsmRT().
+\*---------------------------------------------------------------------------------------------------------*/
+
+#ifndef LIBCC_PC_FSM_H
+#define LIBCC_PC_FSM_H
+
+// Include header files
+
+#include <libcc/fsm.h>
+
+// Power converter states - the order matches the FGC state constants
+
+enum cc_pc_state
+{
+    CC_PC_FLT_OFF,                                      ///< FO
+    CC_PC_OFF,                                          ///< OF
+    CC_PC_FLT_STOPPING,                                 ///< FS
+    CC_PC_STOPPING,                                     ///< SP
+    CC_PC_STARTING,                                     ///< ST
+    CC_PC_SLOW_ABORT,                                   ///< SA
+    CC_PC_TO_STANDBY,                                   ///< TS
+    CC_PC_ON_STANDBY,                                   ///< SB
+    CC_PC_IDLE,                                         ///< IL
+    CC_PC_TO_CYCLING,                                   ///< TC
+    CC_PC_ARMED,                                        ///< AR
+    CC_PC_RUNNING,                                      ///< RN
+    CC_PC_ABORTING,                                     ///< AB
+    CC_PC_CYCLING,                                      ///< CY
+    CC_PC_NUM_STATES
+};
+
+// Power converter condition bits
+
+#define CC_PC_PWR_FAILURE           0x00000001          ///< Digital input: power failure
+#define CC_PC_FAST_ABORT            0x00000002          ///< Digital input: fast abort
+#define CC_PC_VS_POWER_ON           0x00000004          ///< Digital input: voltage source powered on
+#define CC_PC_VS_READY              0x00000008          ///< Digital input: voltage source ready
+#define CC_PC_VS_RUN                0x00000010          ///< Digital input: voltage source running
+#define CC_PC_INTLK_SPARE           0x00000020          ///< Digital input: spare interlock
+#define CC_PC_FLT_FAST_ABORT        0x00000040          ///< Fault: fast abort
+#define CC_PC_FLT_NO_PC_PERMIT      0x00000080          ///< Fault: no PC permit
+#define CC_PC_FIRST_FAULTS          0x00000100          ///< Faults that caused the trip have been latched
+#define CC_PC_START                 0x00000200          ///< State flag: start
+#define CC_PC_STOP                  0x00000400          ///< State flag: stop
+#define CC_PC_SLOW_ABORT_REQ        0x00000800          ///< State flag: slow abort
+#define CC_PC_TO_STANDBY_REQ        0x00001000          ///< State flag: to standby
+#define CC_PC_IDLE_REQ              0x00002000          ///< State flag: idle
+#define CC_PC_ARMED_REQ             0x00004000          ///< State flag: armed
+#define CC_PC_RUNNING_REQ           0x00008000          ///< State flag: running
+#define CC_PC_ABORTING_REQ          0x00010000          ///< State flag: aborting
+#define CC_PC_TO_CYCLING_REQ        0x00020000          ///< State flag: to cycling
+#define CC_PC_CYCLING_REQ           0x00040000          ///< State flag: cycling
+
+// Power converter state machine table
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const struct cc_fsm_table cc_pc_fsm_table;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBCC_PC_FSM_H
+// EOF
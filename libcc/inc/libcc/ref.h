@@ -16,9 +16,26 @@
             You should have received a copy of the GNU Lesser General Public License
             along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-  Purpose:  Control Control reference functions library header file
+  Purpose:  Converter Control reference manager header file
 
   Contact:  cclibs-devs@cern.ch
+
+  Notes:    The reference manager owns one double-buffered libfg function per cycle selector.  The
+            background thread arms a function in the free buffer of a cycle selector (ccRefArmPars()
+            then the libfg Init function, then ccRefArm()) while the real-time thread may be playing
+            the other buffer.  The armed function is only taken by the real-time thread when a cycle
+            with that selector starts (ccRefStartRT()), so a function is never changed while it runs.
+
+            A started function is played from start_time + run_delay.  The regulation mode of the
+            function is returned by ccRef() from the start of the cycle, so that regulation can settle
+            during the run delay.  ccRefAbortRT() replaces the running function with a ramp.
+
+            The run delay is applied by the reference manager, so functions must be armed with a libfg
+            delay of zero, otherwise the delay would be applied twice.  ccRefArm() returns
+            FG_BAD_PARAMETER if meta->delay is not zero.
+
+            ccRef() is called once per regulation period and only calls the libfg Gen function of the
+            active function, so its cost does not depend on the number of armed cycle selectors.
 \*---------------------------------------------------------------------------------------------------------*/
 
 #ifndef LIBCC_REF_H
@@ -27,21 +44,74 @@
 // Include header files
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <libfg.h>
+#include <libfg/ramp.h>
+#include <libfg/swap.h>
+#include <libreg.h>
+
+// Constants
 
-// Global power referter cculation structures
+#define CC_REF_NUM_CYC_SELS         32                  ///< Number of cycle selectors (0 to CC_REF_NUM_CYC_SELS-1)
 
-struct cc_ref_sim_meas                                ///< Measurement simulation structure
+// Reference manager states
+
+enum cc_ref_state
 {
-    float                       signal;                 ///< Simulated measured signal with noise and tone
+    CC_REF_IDLE,                                        ///< No function running - the last reference is held
+    CC_REF_RUN_DELAY,                                   ///< Cycle started, waiting for the end of the run delay
+    CC_REF_RUNNING,                                     ///< Function running
+    CC_REF_ABORTING,                                    ///< Abort ramp running
 };
 
-// Referter control functions
+// Reference manager structures
+
+struct cc_ref_func                                      ///< Armed function information for one buffer
+{
+    enum reg_mode               reg_mode;               ///< Regulation mode for the function
+    float                       duration;               ///< Function duration from meta (not including delays)
+    float                       initial_ref;            ///< Reference at the start of the function from meta
+};
+
+struct cc_ref_slot                                      ///< Functions for one cycle selector
+{
+    struct fg_swap              swap;                   ///< Double-buffered libfg function
+    struct cc_ref_func          func[2];                ///< Function information for swap.buf[0] and swap.buf[1]
+};
+
+struct cc_ref                                           ///< Reference manager
+{
+    double                      run_delay;              ///< Delay between the cycle start and the function start
+    enum cc_ref_state           state;                  ///< Reference manager state
+    enum reg_mode               reg_mode;               ///< Regulation mode returned by ccRef()
+    enum fg_gen_status          fg_gen_status;          ///< Status returned by the last call to the Gen function
+    uint32_t                    cyc_sel;                ///< Cycle selector of the last cycle started
+    float                       ref;                    ///< Last reference value
+    double                      func_start_time;        ///< Time origin of the running function or abort ramp
+    fg_gen_func                 gen;                    ///< Gen function of the running function or abort ramp
+    void                       *pars;                   ///< Parameters of the running function or abort ramp
+    const struct cc_ref_func   *func;                   ///< Information for the running function (NULL if none)
+    struct fg_ramp              abort;                  ///< Abort ramp parameters
+    struct cc_ref_slot          slot[CC_REF_NUM_CYC_SELS];  ///< Armed functions for each cycle selector
+};
+
+// Reference manager functions
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-float    ccRefPureDelay       (uint32_t cc_period_iters);
+void          ccRefInit           (struct cc_ref *ref_mgr, void *pars, size_t size_of_pars, double run_delay, float ref);
+void         *ccRefArmPars        (struct cc_ref *ref_mgr, uint32_t cyc_sel);
+enum fg_error ccRefArm            (struct cc_ref *ref_mgr, uint32_t cyc_sel, fg_gen_func gen, enum reg_mode reg_mode,
+                                   const struct fg_meta *meta);
+bool          ccRefStartRT        (struct cc_ref *ref_mgr, uint32_t cyc_sel, double start_time);
+void          ccRefAbortRT        (struct cc_ref *ref_mgr, double time, float init_ref, float init_rate,
+                                   bool is_pol_switch_auto, bool is_pol_switch_neg, float final_ref,
+                                   float acceleration, float linear_rate, float deceleration);
+enum reg_mode ccRef               (struct cc_ref *ref_mgr, double time, float *ref);
+float         ccRefPureDelay      (uint32_t cc_period_iters);
 
 #ifdef __cplusplus
 }
@@ -49,4 +119,3 @@ float    ccRefPureDelay       (uint32_t cc_period_iters);
 
 #endif // LIBCC_REF_H
 // EOF
-
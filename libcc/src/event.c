@@ -0,0 +1,174 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     event.c                                                                      Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Timing event scheduler based on a hierarchical timer wheel keyed on iteration ticks
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include "libcc.h"
+
+// Number of ticks covered by all the levels - events further in the future are re-queued from the top level
+
+#define CC_EVENT_RANGE              (1u << (CC_EVENT_LEVELS * CC_EVENT_SLOT_BITS))
+
+static void ccEventLink(struct cc_event **head, struct cc_event *event)
+{
+    if((event->next = *head) != NULL)
+    {
+        event->next->pprev = &event->next;
+    }
+
+    *head        = event;
+    event->pprev = head;
+}
+
+static void ccEventQueue(struct cc_event_sched *sched, struct cc_event *event)
+{
+    uint32_t tick  = event->tick;
+    uint32_t delta = tick - sched->tick;
+    uint32_t level;
+
+    // An event that is already due is delivered at the next tick processed, and an event beyond the range
+    // of the wheel waits in the last slot of the top level, from where it will be queued again
+
+    if((int32_t)delta < 0)
+    {
+        tick  = sched->tick;
+        delta = 0;
+    }
+    else if(delta >= CC_EVENT_RANGE)
+    {
+        delta = CC_EVENT_RANGE - 1;
+        tick  = sched->tick + delta;
+    }
+
+    // Choose the lowest level that covers the delay to the event
+
+    for(level = 0 ; level < (CC_EVENT_LEVELS - 1) && delta >= (1u << ((level + 1) * CC_EVENT_SLOT_BITS)) ; level++);
+
+    ccEventLink(&sched->slot[level][(tick >> (level * CC_EVENT_SLOT_BITS)) & CC_EVENT_SLOT_MASK], event);
+}
+
+static void ccEventCascade(struct cc_event_sched *sched, uint32_t level, uint32_t idx)
+{
+    struct cc_event *event = sched->slot[level][idx];
+    struct cc_event *next;
+
+    // Spread the events of one slot into the levels below
+
+    sched->slot[level][idx] = NULL;
+
+    while(event != NULL)
+    {
+        next = event->next;
+
+        ccEventQueue(sched, event);
+
+        event = next;
+    }
+}
+//-----------------------------------------------------------------------------------------------------------
+// Non-Real-Time Functions - do not call these from the real-time thread or interrupt
+//-----------------------------------------------------------------------------------------------------------
+void ccEventInit(struct cc_event_sched *sched, uint32_t tick, void *user)
+{
+    memset(sched, 0, sizeof(*sched));
+
+    sched->tick = tick;
+    sched->user = user;
+}
+//-----------------------------------------------------------------------------------------------------------
+// Real-Time Functions
+//-----------------------------------------------------------------------------------------------------------
+void ccEventAddRT(struct cc_event_sched *sched, struct cc_event *event, uint32_t tick)
+{
+    // An event that is already scheduled is moved to the new tick
+
+    ccEventCancelRT(sched, event);
+
+    event->tick = tick;
+
+    ccEventQueue(sched, event);
+
+    sched->num_pending++;
+}
+//-----------------------------------------------------------------------------------------------------------
+void ccEventCancelRT(struct cc_event_sched *sched, struct cc_event *event)
+{
+    if(event->pprev != NULL)
+    {
+        if((*event->pprev = event->next) != NULL)
+        {
+            event->next->pprev = event->pprev;
+        }
+
+        event->next  = NULL;
+        event->pprev = NULL;
+
+        sched->num_pending--;
+    }
+}
+//-----------------------------------------------------------------------------------------------------------
+uint32_t ccEventRT(struct cc_event_sched *sched)
+{
+    struct cc_event *event;
+    uint32_t         idx = sched->tick & CC_EVENT_SLOT_MASK;
+    uint32_t         level_idx;
+    uint32_t         level;
+    uint32_t         num_events = 0;
+
+    // When level 0 wraps, bring down the next slot of level 1, and so on while the higher levels wrap
+
+    if(idx == 0)
+    {
+        for(level = 1 ; level < CC_EVENT_LEVELS ; level++)
+        {
+            level_idx = (sched->tick >> (level * CC_EVENT_SLOT_BITS)) & CC_EVENT_SLOT_MASK;
+
+            ccEventCascade(sched, level, level_idx);
+
+            if(level_idx != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    // Take the events for this tick - they are kept in sched->due so that an event function can cancel
+    // other events of the same tick, and events added by an event function for this tick go to the next one
+
+    if((sched->due = sched->slot[0][idx]) != NULL)
+    {
+        sched->due->pprev = &sched->due;
+    }
+
+    sched->slot[0][idx] = NULL;
+    sched->tick++;
+
+    while((event = sched->due) != NULL)
+    {
+        ccEventCancelRT(sched, event);
+
+        event->func(sched, event);
+
+        num_events++;
+    }
+
+    return(num_events);
+}
+// EOF
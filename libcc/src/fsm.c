@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     fsm.c                                                                        Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Table-driven state machine compiled into fixed-size rows of transitions per state
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include "libcc.h"
+
+// Index of the lowest bit set in a non-zero mask
+
+#if defined(__GNUC__)
+#define CC_FSM_LOWEST_BIT(mask)     ((uint32_t)__builtin_ctz(mask))
+#else
+static inline uint32_t CC_FSM_LOWEST_BIT(uint32_t mask)
+{
+    uint32_t idx = 0;
+
+    while((mask & 1) == 0)
+    {
+        mask >>= 1;
+        idx++;
+    }
+
+    return(idx);
+}
+#endif
+
+// Bit for each transition in a row
+
+static const uint32_t trans_bit[CC_FSM_MAX_STATE_TRANS] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+//-----------------------------------------------------------------------------------------------------------
+// Non-Real-Time Functions - do not call these from the real-time thread or interrupt
+//-----------------------------------------------------------------------------------------------------------
+enum cc_fsm_error ccFsmInit(struct cc_fsm *fsm, const struct cc_fsm_table *table, uint32_t initial_state,
+                            void (* const *state_func)(struct cc_fsm *fsm, bool first_f), void *user)
+{
+    const struct cc_fsm_trans *trans;
+    struct cc_fsm_row         *row;
+    uint32_t                   num_row_trans[CC_FSM_MAX_STATES];
+    uint32_t                   state;
+    uint32_t                   i;
+    uint32_t                   n;
+
+    if(table->num_states > CC_FSM_MAX_STATES || initial_state >= table->num_states)
+    {
+        return(CC_FSM_BAD_STATE);
+    }
+
+    memset(fsm, 0, sizeof(*fsm));
+    memset(num_row_trans, 0, sizeof(num_row_trans));
+
+    // Pad every row with transitions that are never true: (cond & 0) is never equal to 1
+
+    for(state = 0 ; state < CC_FSM_MAX_STATES ; state++)
+    {
+        for(n = 0 ; n < CC_FSM_MAX_STATE_TRANS ; n++)
+        {
+            fsm->row[state].all_value[n] = 1;
+        }
+    }
+
+    // Append each transition to the rows of its from states, in the order of the table
+
+    for(i = 0, trans = table->trans ; i < table->num_trans ; i++, trans++)
+    {
+        if(trans->to_state >= table->num_states ||
+          (table->num_states < CC_FSM_MAX_STATES && (trans->from_states >> table->num_states) != 0))
+        {
+            return(CC_FSM_BAD_STATE);
+        }
+
+        for(state = 0 ; state < table->num_states ; state++)
+        {
+            if((trans->from_states & CC_FSM_STATE(state)) != 0)
+            {
+                if((n = num_row_trans[state]++) >= CC_FSM_MAX_STATE_TRANS)
+                {
+                    return(CC_FSM_TOO_MANY_TRANS);
+                }
+
+                row = &fsm->row[state];
+
+                row->any_mask  [n] = trans->any_mask;
+                row->any_invert[n] = trans->any_invert;
+                row->all_mask  [n] = trans->all_mask;
+                row->all_value [n] = trans->all_value;
+                row->to_state  [n] = trans->to_state;
+            }
+        }
+    }
+
+    if(state_func != NULL)
+    {
+        memcpy(fsm->state_func, state_func, table->num_states * sizeof(fsm->state_func[0]));
+    }
+
+    fsm->table = table;
+    fsm->user  = user;
+    fsm->state = initial_state;
+
+    return(CC_FSM_OK);
+}
+//-----------------------------------------------------------------------------------------------------------
+// Real-Time Functions
+//-----------------------------------------------------------------------------------------------------------
+uint32_t ccFsmRT(struct cc_fsm *fsm, uint32_t cond)
+{
+    const struct cc_fsm_row *row = &fsm->row[fsm->state];
+    uint32_t                 true_mask = 0;
+    uint32_t                 next_state;
+    uint32_t                 n;
+
+    // Evaluate all the transitions in the row - the loop has no branches, so the cost does not depend on
+    // cond, and it is written as an OR reduction so that the compiler can vectorise it
+
+    for(n = 0 ; n < CC_FSM_MAX_STATE_TRANS ; n++)
+    {
+        true_mask |= ((((cond ^ row->any_invert[n]) & row->any_mask[n]) != 0) |
+                      ((cond & row->all_mask[n]) == row->all_value[n])) ? trans_bit[n] : 0;
+    }
+
+    if(true_mask != 0)
+    {
+        // Call the function of the new state while fsm->state is still the old state
+
+        next_state = row->to_state[CC_FSM_LOWEST_BIT(true_mask)];
+
+        if(fsm->state_func[next_state] != NULL)
+        {
+            fsm->state_func[next_state](fsm, true);
+        }
+
+        fsm->state       = next_state;
+        fsm->state_iters = 0;
+    }
+    else
+    {
+        if(fsm->state_func[fsm->state] != NULL)
+        {
+            fsm->state_func[fsm->state](fsm, false);
+        }
+
+        fsm->state_iters++;
+    }
+
+    return(fsm->state);
+}
+// EOF
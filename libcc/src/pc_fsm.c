@@ -0,0 +1,186 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     pc_fsm.c                                                                     Copyright CERN 2015
+
+  License:  This file is part of libcc.
+
+            libcc is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Power converter state machine transition table
+
+  Notes:    The transitions and their priorities are those of transitions_class.h and transitions_class.c
+            in libcc/resources.  Within each state, the transitions are checked in the order of the table.
+            This is the order of the FGC engine, whose scan in resources/pc_fsm.c starts from the leftmost
+            transition of each trans_XX[] list, so faults (XXtoFS, XXtoSP) take priority over requests.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include "libcc.h"
+
+// Condition helpers
+
+#define ANY(mask)               (mask), 0                               // Any bit of mask is set
+#define ANY_CLR(mask, clr)      ((mask) | (clr)), (clr)                 // Any bit of mask is set or of clr is clear
+#define ALL(mask, value)        (mask), (value)                         // Bits of mask are equal to value
+#define NONE                    0, 0                                    // No bit test (for ANY)
+#define NEVER                   0, 1                                    // No bit test (for ALL)
+
+#define PC_TRIP                 (CC_PC_PWR_FAILURE | CC_PC_FLT_FAST_ABORT | CC_PC_FLT_NO_PC_PERMIT)
+
+// Mask of states from which the common XXtoYY transitions are checked
+
+#define S(state)                CC_FSM_STATE(CC_PC_##state)
+
+#define XX_IL_UP                (S(IDLE) | S(TO_CYCLING) | S(ARMED) | S(RUNNING) | S(ABORTING) | S(CYCLING))
+#define XX_TS_UP                (S(TO_STANDBY) | S(ON_STANDBY) | XX_IL_UP)
+#define XX_SA_UP                (S(SLOW_ABORT) | XX_TS_UP)
+#define XX_SP_UP                (S(STOPPING)   | XX_SA_UP)
+
+// Transition table - see fsm.h for the condition
+
+static const struct cc_fsm_trans pc_trans[] =
+{
+    {   // OFtoFO
+        S(OFF), CC_PC_FLT_OFF,
+        ANY(PC_TRIP),
+        NEVER
+    },
+    {   // FStoFO
+        S(FLT_STOPPING), CC_PC_FLT_OFF,
+        NONE,
+        ALL(CC_PC_VS_POWER_ON | CC_PC_FIRST_FAULTS, CC_PC_FIRST_FAULTS)
+    },
+    {   // FOtoOF
+        S(FLT_OFF), CC_PC_OFF,
+        NONE,
+        ALL(PC_TRIP, 0)
+    },
+    {   // STtoFS
+        S(STARTING), CC_PC_FLT_STOPPING,
+        ANY(PC_TRIP),
+        NEVER
+    },
+    {   // XXtoFS
+        XX_SP_UP, CC_PC_FLT_STOPPING,
+        ANY(CC_PC_PWR_FAILURE | CC_PC_FAST_ABORT),
+        ALL(CC_PC_VS_READY | CC_PC_FLT_NO_PC_PERMIT, CC_PC_FLT_NO_PC_PERMIT)
+    },
+    {   // STtoSP
+        S(STARTING), CC_PC_STOPPING,
+        ANY(CC_PC_STOP),
+        ALL(CC_PC_START | CC_PC_VS_RUN, 0)
+    },
+    {   // XXtoSP
+        XX_SA_UP, CC_PC_STOPPING,
+        ANY_CLR(CC_PC_STOP, CC_PC_VS_READY | CC_PC_VS_RUN),
+        NEVER
+    },
+    {   // SPtoOF
+        S(STOPPING), CC_PC_OFF,
+        NONE,
+        ALL(CC_PC_STOP | CC_PC_VS_POWER_ON, 0)
+    },
+    {   // OFtoST
+        S(OFF), CC_PC_STARTING,
+        ANY(CC_PC_START),
+        NEVER
+    },
+    {   // XXtoSA
+        XX_TS_UP, CC_PC_SLOW_ABORT,
+        ANY(CC_PC_INTLK_SPARE | CC_PC_SLOW_ABORT_REQ),
+        NEVER
+    },
+    {   // STtoTS
+        S(STARTING), CC_PC_TO_STANDBY,
+        NONE,
+        ALL(CC_PC_VS_POWER_ON | CC_PC_VS_READY, CC_PC_VS_POWER_ON | CC_PC_VS_READY)
+    },
+    {   // XXtoTS
+        XX_IL_UP, CC_PC_TO_STANDBY,
+        NONE,
+        ALL(CC_PC_TO_STANDBY_REQ | CC_PC_CYCLING_REQ, CC_PC_TO_STANDBY_REQ)
+    },
+    {   // TStoAB
+        S(TO_STANDBY), CC_PC_ABORTING,
+        ANY(CC_PC_ABORTING_REQ),
+        NEVER
+    },
+    {   // TStoSB
+        S(TO_STANDBY), CC_PC_ON_STANDBY,
+        ANY_CLR(0, CC_PC_TO_STANDBY_REQ),
+        NEVER
+    },
+    {   // SBtoIL
+        S(ON_STANDBY), CC_PC_IDLE,
+        ANY(CC_PC_IDLE_REQ),
+        NEVER
+    },
+    {   // SBtoTC
+        S(ON_STANDBY), CC_PC_TO_CYCLING,
+        ANY(CC_PC_TO_CYCLING_REQ),
+        NEVER
+    },
+    {   // ILtoAR
+        S(IDLE), CC_PC_ARMED,
+        ANY(CC_PC_ARMED_REQ),
+        NEVER
+    },
+    {   // ILtoTC
+        S(IDLE), CC_PC_TO_CYCLING,
+        ANY(CC_PC_TO_CYCLING_REQ),
+        NEVER
+    },
+    {   // TCtoCY
+        S(TO_CYCLING), CC_PC_CYCLING,
+        ANY(CC_PC_CYCLING_REQ),
+        NEVER
+    },
+    {   // ARtoIL
+        S(ARMED), CC_PC_IDLE,
+        ANY(CC_PC_IDLE_REQ),
+        NEVER
+    },
+    {   // ARtoRN
+        S(ARMED), CC_PC_RUNNING,
+        ANY(CC_PC_RUNNING_REQ),
+        NEVER
+    },
+    {   // RNtoIL
+        S(RUNNING), CC_PC_IDLE,
+        ANY_CLR(0, CC_PC_RUNNING_REQ),
+        NEVER
+    },
+    {   // RNtoAB
+        S(RUNNING), CC_PC_ABORTING,
+        ANY(CC_PC_ABORTING_REQ),
+        NEVER
+    },
+    {   // ABtoIL
+        S(ABORTING), CC_PC_IDLE,
+        ANY_CLR(0, CC_PC_ABORTING_REQ),
+        NEVER
+    },
+    {   // SAtoAB
+        S(SLOW_ABORT), CC_PC_ABORTING,
+        ANY(CC_PC_ABORTING_REQ),
+        NEVER
+    },
+};
+
+const struct cc_fsm_table cc_pc_fsm_table =
+{
+    CC_PC_NUM_STATES,
+    "FOOFFSSPSTSATSSBILTCARRNABCY",
+    sizeof(pc_trans) / sizeof(pc_trans[0]),
+    pc_trans
+};
+// EOF
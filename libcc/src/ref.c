@@ -16,8 +16,7 @@
             You should have received a copy of the GNU Lesser General Public License
             along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-  Purpose:  This provides a higher level access to libreg with functions that combine all the elements
-            needed to regulate current or field in converter.
+  Purpose:  Reference manager - arms, starts and aborts the libfg functions for each cycle selector
 \*---------------------------------------------------------------------------------------------------------*/
 
 #include <string.h>
@@ -26,11 +25,156 @@
 //-----------------------------------------------------------------------------------------------------------
 // Non-Real-Time Functions - do not call these from the real-time thread or interrupt
 //-----------------------------------------------------------------------------------------------------------
+void ccRefInit(struct cc_ref *ref_mgr, void *pars, size_t size_of_pars, double run_delay, float ref)
+{
+    uint32_t cyc_sel;
+    char    *pars0 = pars;
+
+    // pars must point to 2 * CC_REF_NUM_CYC_SELS parameter structures of size_of_pars bytes
+
+    memset(ref_mgr, 0, sizeof(*ref_mgr));
+
+    for(cyc_sel = 0 ; cyc_sel < CC_REF_NUM_CYC_SELS ; cyc_sel++)
+    {
+        fgSwapInit(pars0 + size_of_pars * (2 * cyc_sel), pars0 + size_of_pars * (2 * cyc_sel + 1),
+                   &ref_mgr->slot[cyc_sel].swap);
+    }
+
+    ref_mgr->run_delay     = run_delay;
+    ref_mgr->state         = CC_REF_IDLE;
+    ref_mgr->reg_mode      = REG_VOLTAGE;
+    ref_mgr->fg_gen_status = FG_GEN_AFTER_FUNC;
+    ref_mgr->ref           = ref;
+}
+//-----------------------------------------------------------------------------------------------------------
+void *ccRefArmPars(struct cc_ref *ref_mgr, uint32_t cyc_sel)
+{
+    if(cyc_sel >= CC_REF_NUM_CYC_SELS)
+    {
+        return(NULL);
+    }
+
+    // NULL until the function armed previously for this cycle selector has been taken by a cycle start
+
+    return(fgSwapNext(&ref_mgr->slot[cyc_sel].swap));
+}
+//-----------------------------------------------------------------------------------------------------------
+enum fg_error ccRefArm(struct cc_ref *ref_mgr, uint32_t cyc_sel, fg_gen_func gen, enum reg_mode reg_mode,
+                       const struct fg_meta *meta)
+{
+    struct cc_ref_slot *slot;
+    struct cc_ref_func *func;
+    void               *pars;
+
+    // The run delay is applied by ccRefStartRT() so the function must not have its own delay
+
+    if(cyc_sel >= CC_REF_NUM_CYC_SELS || reg_mode == REG_NONE ||
+       meta->fg_error != FG_OK || meta->delay != 0.0)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    slot = &ref_mgr->slot[cyc_sel];
+
+    if((pars = fgSwapNext(&slot->swap)) == NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    // The function information is written before fgSwapArm() publishes the buffer
+
+    func = &slot->func[pars == slot->swap.buf[1].pars];
+
+    func->reg_mode    = reg_mode;
+    func->duration    = meta->duration;
+    func->initial_ref = meta->range.start;
+
+    // A published function can be taken by the next cycle start, whatever its time
+
+    return(fgSwapArm(&slot->swap, gen, -HUGE_VAL));
+}
 //-----------------------------------------------------------------------------------------------------------
 // Real-Time Functions
 //-----------------------------------------------------------------------------------------------------------
-enum reg_mode ccRef(float *ref)
+bool ccRefStartRT(struct cc_ref *ref_mgr, uint32_t cyc_sel, double start_time)
+{
+    struct cc_ref_slot       *slot;
+    const struct fg_swap_buf *active;
+
+    // A cycle cannot start while an abort ramp is running
+
+    if(cyc_sel >= CC_REF_NUM_CYC_SELS || ref_mgr->state == CC_REF_ABORTING)
+    {
+        return(false);
+    }
+
+    // Take the function armed for this cycle selector, or play the last one again if none is pending
+
+    slot = &ref_mgr->slot[cyc_sel];
+
+    if((active = fgSwapActive(&slot->swap, start_time)) == NULL)
+    {
+        return(false);
+    }
+
+    ref_mgr->cyc_sel         = cyc_sel;
+    ref_mgr->gen             = active->gen;
+    ref_mgr->pars            = active->pars;
+    ref_mgr->func            = &slot->func[active - slot->swap.buf];
+    ref_mgr->reg_mode        = ref_mgr->func->reg_mode;
+    ref_mgr->func_start_time = start_time + ref_mgr->run_delay;
+    ref_mgr->state           = CC_REF_RUN_DELAY;
+
+    return(true);
+}
+//-----------------------------------------------------------------------------------------------------------
+void ccRefAbortRT(struct cc_ref *ref_mgr, double time, float init_ref, float init_rate,
+                  bool is_pol_switch_auto, bool is_pol_switch_neg, float final_ref,
+                  float acceleration, float linear_rate, float deceleration)
 {
-    return(REG_VOLTAGE);
+    // Take over from the running function with a ramp starting from the last reference and rate
+
+    fgRampCalc(is_pol_switch_auto,
+               is_pol_switch_neg,
+               0.0,
+               init_rate,
+               init_ref,
+               final_ref,
+               acceleration,
+               linear_rate,
+               deceleration,
+               &ref_mgr->abort,
+               NULL);
+
+    ref_mgr->gen             = (fg_gen_func)fgRampGen;
+    ref_mgr->pars            = &ref_mgr->abort;
+    ref_mgr->func            = NULL;
+    ref_mgr->func_start_time = time;
+    ref_mgr->state           = CC_REF_ABORTING;
+}
+//-----------------------------------------------------------------------------------------------------------
+enum reg_mode ccRef(struct cc_ref *ref_mgr, double time, float *ref)
+{
+    double func_time;
+
+    if(ref_mgr->state != CC_REF_IDLE)
+    {
+        func_time = time - ref_mgr->func_start_time;
+
+        ref_mgr->fg_gen_status = ref_mgr->gen(ref_mgr->pars, &func_time, &ref_mgr->ref);
+
+        if(ref_mgr->fg_gen_status == FG_GEN_AFTER_FUNC)
+        {
+            ref_mgr->state = CC_REF_IDLE;
+        }
+        else if(ref_mgr->state == CC_REF_RUN_DELAY && func_time >= 0.0)
+        {
+            ref_mgr->state = CC_REF_RUNNING;
+        }
+    }
+
+    *ref = ref_mgr->ref;
+
+    return(ref_mgr->reg_mode);
 }
 // EOF
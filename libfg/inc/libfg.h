@@ -50,6 +50,7 @@ enum fg_gen_status
     FG_GEN_AFTER_FUNC,
     FG_GEN_DURING_FUNC,
     FG_GEN_BEFORE_FUNC,
+    FG_GEN_UNDERRUN,                            //!< STREAM function is waiting for its next point
 };
 
 /*!
@@ -0,0 +1,96 @@
+/*!
+ * @file    arm.h
+ * @brief   Arm many functions concurrently.
+ *
+ * fgArm() runs a list of arming jobs, each of which calls one of the fgXxxInit()
+ * functions with its own parameters, limits and meta data. The jobs are taken
+ * in turn by the calling thread and up to num_threads - 1 worker threads, so
+ * that a large set of functions, e.g. one per cycle selector, can be validated
+ * in parallel. The jobs must be independent: no two jobs may write to the same
+ * parameter structure or meta data, and the limits and input arrays must not
+ * change until fgArm() returns. The result of each job is then the same as if
+ * the jobs were run one after the other.
+ *
+ * Worker threads use POSIX threads on Unix-like systems, so applications that call
+ * fgArm() must be linked with -lpthread. On other platforms the jobs are run by
+ * the calling thread.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_ARM_H
+#define LIBFG_ARM_H
+
+#include "libfg.h"
+
+// Constants
+
+#define FG_ARM_MAX_THREADS      64              //!< Maximum number of threads
+
+/*!
+ * Arming function, e.g. a function that calls fgTableInit() for the parameters selected by idx
+ */
+typedef enum fg_error (*fg_arm_func)(struct fg_meta *meta, uint32_t idx);
+
+/*!
+ * Arming job
+ */
+struct fg_arm_job
+{
+    fg_arm_func         init;                   //!< Arming function.
+    uint32_t            idx;                    //!< Index passed to init, e.g. a cycle selector.
+    struct fg_meta     *meta;                   //!< Meta data passed to init (may be NULL).
+    enum fg_error       fg_error;               //!< Error returned by init.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Run arming jobs on several threads. Every job is run, even if other jobs fail, and its result is
+ * returned in fg_arm_job::fg_error and fg_arm_job::meta.
+ *
+ * @param[in,out] jobs            Array of arming jobs.
+ * @param[in]     num_jobs        Number of arming jobs.
+ * @param[in]     num_threads     Number of threads to use, including the calling thread (1 to FG_ARM_MAX_THREADS).
+ *
+ * @retval FG_OK if all the jobs succeeded
+ * @retval FG_BAD_PARAMETER if jobs is NULL or num_threads is out of range, in which case no jobs are run
+ * @retval Otherwise the error from the first job in the array that failed
+ */
+enum fg_error fgArm(struct fg_arm_job *jobs, uint32_t num_jobs, uint32_t num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
@@ -143,6 +143,23 @@ enum fg_error fgPlepInit(struct fg_limits *limits,
  */
 enum fg_gen_status fgPlepGen(struct fg_plep *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the PLEP function at any time without changing the parameters.
+ *
+ * fgPlepGen() calls this function since PLEP generation has no running state.
+ *
+ * @param[in]  pars             Pointer to PLEP function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgPlepEval(const struct fg_plep *pars, double time, float *ref);
+
 #ifdef __cplusplus
 }
 #endif
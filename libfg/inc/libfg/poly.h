@@ -0,0 +1,293 @@
+/*!
+ * @file    poly.h
+ * @brief   Compile functions into a common piecewise-polynomial form.
+ *
+ * Each function type has its own generator, with its own branches and
+ * per-sample arithmetic. A function that has been initialised by its Init
+ * function may optionally be compiled into a fg_poly, which describes it as
+ * a sequence of cubic segments. A single kernel then evaluates every type of
+ * function with the same cost per sample: a segment search followed by a
+ * Horner evaluation of the cubic.
+ *
+ * Segment i starts at fg_poly_seg::time and ends where segment i+1 starts.
+ * Within the segment, with t relative to the start of the segment:
+ *
+ * \f$ref = c_{0} + c_{1} \cdot t + c_{2} \cdot t^{2} + c_{3} \cdot t^{3}\f$
+ *
+ * The last segment starts at the end of the function and describes the
+ * reference after the function (constant, except for PLEP which continues
+ * with its final rate). The first segment starts at time zero.
+ *
+ * TABLE, PPPL, RAMP and TRIM functions and the STEPS and SQUARE TEST functions
+ * are polynomial and are compiled exactly, apart from float rounding. The
+ * exponential segment of a PLEP function and SINE and COSINE TEST functions are
+ * approximated by cubic segments that are subdivided until the error at a set
+ * of test points is within the tolerance supplied by the application. The RAMP
+ * function is compiled as it was armed, without the rate limit or the time shift
+ * that fgRampGen() may apply while it is running.
+ *
+ * The times at which one segment ends and the next begins may be classed as
+ * the end of the earlier segment by the original Gen function. The value is
+ * the same, but the status returned at the end of the function can differ.
+ * If a compile function returns an error, the fg_poly must not be used.
+ *
+ * A compiled function can also be generated from an integer tick count with
+ * fgPolyGenTicks(), after fgPolyTicksInit() has converted the start of each
+ * segment into ticks. Tick zero is time zero and the ticks may be nanoseconds,
+ * iterations or any other fixed period. The real-time path then uses integer
+ * comparisons to find the segment, and the time within the segment is
+ * calculated in double precision from the integer number of ticks since the
+ * start of the segment. Since the tick count is exact, the time does not drift
+ * during long runs, even in segments longer than 2^24 ticks.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_POLY_H
+#define LIBFG_POLY_H
+
+#include "libfg.h"
+#include "libfg/plep.h"
+#include "libfg/pppl.h"
+#include "libfg/ramp.h"
+#include "libfg/table.h"
+#include "libfg/test.h"
+#include "libfg/trim.h"
+
+// Constants
+
+#define FG_POLY_NUM_COEFFS      4               //!< Number of coefficients per segment (cubic)
+#define FG_POLY_MAX_FIT_DEPTH   20              //!< Maximum number of times a fitted segment can be halved
+#define FG_POLY_NUM_FIT_CHECKS  16              //!< Number of points at which the error of a fitted segment is checked
+
+/*!
+ * Piecewise-polynomial segment
+ */
+struct fg_poly_seg
+{
+    float       time;                           //!< Start time of segment.
+    float       c[FG_POLY_NUM_COEFFS];          //!< Coefficients \f$c_{0}\f$ to \f$c_{3}\f$ for time relative to the start of the segment.
+    float       tick_offset;                    //!< Time from the start of the segment to fg_poly_seg::tick. Set by fgPolyTicksInit().
+    int64_t     tick;                           //!< First tick at or after the start of the segment. Set by fgPolyTicksInit().
+};
+
+/*!
+ * Compiled function parameters
+ */
+struct fg_poly
+{
+    double              delay;                  //!< Time before start of function.
+    uint32_t            seg_idx;                //!< Current segment index for fgPolyGen().
+    uint32_t            num_segs;               //!< Number of segments, including the segment after the end of the function.
+    uint32_t            max_segs;               //!< Length of the segment array.
+    float               initial_ref;            //!< Reference before the start of the function.
+    double              tick_period;            //!< Time between ticks. Set by fgPolyTicksInit().
+    struct fg_poly_seg *segs;                   //!< Segment array supplied by the application.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Initialise a compiled function with the segment array to be filled by the fgPolyCompileXxx() functions.
+ * This only needs to be called once for each segment array.
+ *
+ * @param[in]  segs               Segment array.
+ * @param[in]  max_segs           Number of segments in the array.
+ * @param[out] poly               Pointer to compiled function parameters.
+ */
+void fgPolyInit(struct fg_poly_seg *segs, uint32_t max_segs, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a TABLE function. One segment is needed for each point in the table.
+ *
+ * @param[in]  pars               Pointer to table function parameters.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ */
+enum fg_error fgPolyCompileTable(const struct fg_table *pars, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a PPPL function. One segment is needed for each PPPL segment, plus one.
+ *
+ * @param[in]  pars               Pointer to PPPL function parameters.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ */
+enum fg_error fgPolyCompilePppl(const struct fg_pppl *pars, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a RAMP function. Up to three segments are needed.
+ *
+ * @param[in]  pars               Pointer to ramp function parameters.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ */
+enum fg_error fgPolyCompileRamp(const struct fg_ramp *pars, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a TRIM function. Up to two segments are needed.
+ *
+ * @param[in]  pars               Pointer to trim function parameters.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ */
+enum fg_error fgPolyCompileTrim(const struct fg_trim *pars, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a PLEP function. The exponential segment is approximated within tolerance.
+ *
+ * @param[in]  pars               Pointer to PLEP function parameters.
+ * @param[in]  tolerance          Maximum error of the exponential approximation.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ * @retval FG_BAD_PARAMETER if tolerance is not positive or cannot be reached in FG_POLY_MAX_FIT_DEPTH subdivisions
+ */
+enum fg_error fgPolyCompilePlep(const struct fg_plep *pars, float tolerance, struct fg_poly *poly);
+
+
+
+/*!
+ * Compile a TEST function. SINE and COSINE functions are approximated within tolerance, while the
+ * tolerance is not used for STEPS and SQUARE functions.
+ *
+ * @param[in]  pars               Pointer to test function parameters.
+ * @param[in]  tolerance          Maximum error of the SINE or COSINE approximation.
+ * @param[out] poly               Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the segment array is too short
+ * @retval FG_BAD_PARAMETER if the type is invalid or the tolerance is not positive or cannot be reached
+ */
+enum fg_error fgPolyCompileTest(const struct fg_test *pars, float tolerance, struct fg_poly *poly);
+
+
+
+/*!
+ * Generate the reference for a compiled function. The current segment is remembered so that the cost
+ * is constant while time increases. If time goes backwards, the segments are searched from the start.
+ *
+ * @param[in,out] pars            Pointer to compiled function parameters.
+ * @param[in]     time            Pointer to time within the function.
+ * @param[out]    ref             Pointer to reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgPolyGen(struct fg_poly *pars, const double *time, float *ref);
+
+
+
+/*!
+ * Evaluate a compiled function at any time without changing pars. The segment is found by binary search,
+ * so this may be used with fgRender().
+ *
+ * @param[in]  pars             Pointer to compiled function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgPolyEval(const struct fg_poly *pars, double time, float *ref);
+
+
+
+/*!
+ * Prepare a compiled function to be generated by fgPolyGenTicks(). This must be called after each call to a
+ * compile function. The delay is rounded to the nearest tick.
+ *
+ * @param[in]     tick_period     Time between ticks, e.g. 1.0E-9 for nanoseconds or the iteration period.
+ * @param[in,out] poly            Pointer to compiled function parameters.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_PARAMETER if tick_period is not positive or the ticks would overflow
+ */
+enum fg_error fgPolyTicksInit(double tick_period, struct fg_poly *poly);
+
+
+
+/*!
+ * Generate the reference for a compiled function from a tick count. The current segment is remembered so
+ * that the cost is constant while the tick count increases.
+ *
+ * @param[in,out] pars            Pointer to compiled function parameters prepared by fgPolyTicksInit().
+ * @param[in]     tick            Tick count, where tick zero is time zero.
+ * @param[out]    ref             Pointer to reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if tick is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if tick is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if tick is after the end of the function.
+ */
+enum fg_gen_status fgPolyGenTicks(struct fg_poly *pars, int64_t tick, float *ref);
+
+
+
+/*!
+ * Render a compiled function at regular times. Point i is evaluated at time start_time + i * period.
+ * The points in each segment are evaluated in a loop without branches that the compiler can vectorise.
+ *
+ * @param[in]  pars               Pointer to compiled function parameters.
+ * @param[in]  start_time         Time of the first point.
+ * @param[in]  period             Time between points (must be positive).
+ * @param[in]  num_points         Number of points to render.
+ * @param[out] ref                Array of num_points reference values.
+ */
+void fgPolyRender(const struct fg_poly *pars, double start_time, double period, uint32_t num_points, float *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
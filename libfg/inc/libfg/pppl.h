@@ -148,6 +148,24 @@ enum fg_error fgPpplInit(struct   fg_limits *limits,
  */
 enum fg_gen_status fgPpplGen(struct fg_pppl *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the PPPL function at any time without changing the parameters.
+ *
+ * The segment is found by a binary search of the segment end times instead of
+ * from fg_pppl::seg_idx, so the result is the same as fgPpplGen() with increasing time.
+ *
+ * @param[in]  pars             Pointer to PPPL function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgPpplEval(const struct fg_pppl *pars, double time, float *ref);
+
 #ifdef __cplusplus
 }
 #endif
@@ -171,6 +171,25 @@ void fgRampCalc(bool   is_pol_switch_auto,
  */
 enum fg_gen_status fgRampGen(struct fg_ramp *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the RAMP function at any time without changing the parameters.
+ *
+ * This returns the initialised parabola-parabola ramp. It ignores the linear rate limit and
+ * any time shift due to the application clipping the reference, so it matches fgRampGen()
+ * only if fg_ramp::linear_rate is zero and the reference is not clipped.
+ *
+ * @param[in]  pars             Pointer to RAMP function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgRampEval(const struct fg_ramp *pars, double time, float *ref);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,91 @@
+/*!
+ * @file    render.h
+ * @brief   Render a function at regular times using several threads.
+ *
+ * fgRender() fills an array with the reference of a function at regular times
+ * by calling one of the stateless fgXxxEval() functions, e.g. fgTableEval().
+ * The points are split into chunks of FG_RENDER_CHUNK_LEN points that are taken
+ * in turn by the calling thread and up to num_threads - 1 worker threads, so the
+ * result does not depend on the number of threads.
+ *
+ * Worker threads use POSIX threads on Unix-like systems, so applications that call
+ * fgRender() must be linked with -lpthread. On other platforms the function is
+ * rendered by the calling thread.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_RENDER_H
+#define LIBFG_RENDER_H
+
+#include "libfg.h"
+
+// Constants
+
+#define FG_RENDER_CHUNK_LEN     4096            //!< Number of points rendered by a thread at a time
+#define FG_RENDER_MAX_THREADS   64              //!< Maximum number of threads
+
+/*!
+ * Stateless evaluation function, e.g. (fg_eval_func)fgTableEval
+ */
+typedef enum fg_gen_status (*fg_eval_func)(const void *pars, double time, float *ref);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Render a function at regular times. Point i is evaluated at time start_time + i * period.
+ *
+ * @param[in]  eval               Stateless evaluation function for the function type.
+ * @param[in]  pars               Pointer to function parameters, which must not change while rendering.
+ * @param[in]  start_time         Time of the first point.
+ * @param[in]  period             Time between points.
+ * @param[in]  num_points         Number of points to render.
+ * @param[in]  num_threads        Number of threads to use, including the calling thread (1 to FG_RENDER_MAX_THREADS).
+ * @param[out] ref                Array of num_points reference values.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_PARAMETER if eval, pars or ref is NULL or num_threads is out of range
+ */
+enum fg_error fgRender(fg_eval_func eval,
+                       const void  *pars,
+                       double       start_time,
+                       double       period,
+                       uint32_t     num_points,
+                       uint32_t     num_threads,
+                       float       *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
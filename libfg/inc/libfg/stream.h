@@ -0,0 +1,186 @@
+/*!
+ * @file    stream.h
+ * @brief   Generate linearly interpolated functions from a stream of points.
+ *
+ * The STREAM function is a TABLE function whose points do not need to be known
+ * when the function starts. A background producer appends (time, ref) points
+ * with fgStreamAppend() while the real-time consumer calls fgStreamGen(), which
+ * interpolates linearly between the points in the same way as fgTableGen().
+ * The length of the function is therefore unbounded.
+ *
+ * The points are passed through a lock-free single-producer/single-consumer ring
+ * buffer supplied by the application. The length of the buffer must be a power
+ * of two. Only one thread may append points and only one thread may generate the
+ * reference. The consumer frees each slot as soon as it has started the segment
+ * that ends at that point.
+ *
+ * The times of the points are doubles since the stream is unbounded: a float
+ * time would lose sub-millisecond resolution after a few hours.
+ *
+ * Points are checked as they are appended: the times must start at zero and
+ * increase by at least min_time_step and the reference values and rates are
+ * checked against the limits. Since the polarity of the function is not known
+ * in advance, the limits are inverted according to is_pol_switch_neg, even if
+ * the polarity switch can be changed automatically.
+ *
+ * If the consumer reaches the last point before the producer has appended the
+ * next one, fgStreamGen() returns FG_GEN_UNDERRUN and holds the reference of the
+ * last point. The function only ends once fgStreamEnd() has been called and the
+ * last point has been reached.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_STREAM_H
+#define LIBFG_STREAM_H
+
+#include "libfg.h"
+
+/*!
+ * Stream point
+ */
+struct fg_stream_point
+{
+    double      time;                       //!< Time of point. Double so that long streams keep sub-ms resolution.
+    float       ref;                        //!< Reference value at time.
+};
+
+/*!
+ * STREAM function parameters
+ */
+struct fg_stream
+{
+    double                  delay;          //!< Time before start of function.
+    struct fg_stream_point *buf;            //!< Ring buffer of points supplied by the application.
+    uint32_t                buf_mask;       //!< Ring buffer length - 1.
+
+    // Producer - written only by fgStreamAppend() and fgStreamEnd()
+
+    uint32_t                write_idx;      //!< Number of points appended (published to the consumer).
+    uint32_t                is_end;         //!< Set by fgStreamEnd() (published to the consumer).
+    struct fg_limits       *limits;         //!< Limits for appended points (NULL if no limits checking required).
+    float                   min_time_step;  //!< Minimum time between points, adjusted to avoid rounding errors.
+    struct fg_stream_point  last;           //!< Last appended point.
+    struct fg_meta          meta;           //!< Meta data for all the points appended so far.
+
+    // Consumer - written only by fgStreamGen()
+
+    uint32_t                read_idx;       //!< Number of points consumed (published to the producer).
+    struct fg_stream_point  seg_start;      //!< Start of current segment.
+    struct fg_stream_point  seg_end;        //!< End of current segment.
+    float                   seg_grad;       //!< Gradient of reference for the current segment.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Initialise STREAM function. The function starts with the point (0, initial_ref). This must be called
+ * before the producer and consumer threads use the function.
+ *
+ * @param[in]  limits             Pointer to fgc_limits structure (or NULL if no limits checking required).
+ * @param[in]  is_pol_switch_auto True if polarity switch can be changed automatically.
+ * @param[in]  is_pol_switch_neg  True if polarity switch is currently in the negative position.
+ * @param[in]  delay              Delay before the start of the function.
+ * @param[in]  min_time_step      Minimum time between points.
+ * @param[in]  initial_ref        Reference value at time zero.
+ * @param[in] *buf                Ring buffer for points.
+ * @param[in]  buf_len            Number of points in the ring buffer (must be a power of 2).
+ * @param[out] pars               Pointer to stream function parameters.
+ * @param[out] meta               Pointer to diagnostic information. Set to NULL if not required.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if buf_len is not a power of 2 greater than 1
+ * @retval FG_OUT_OF_LIMITS if initial_ref exceeds limits
+ */
+enum fg_error fgStreamInit(struct   fg_limits *limits,
+                           bool     is_pol_switch_auto,
+                           bool     is_pol_switch_neg,
+                           double   delay,
+                           float    min_time_step,
+                           float    initial_ref,
+                           struct   fg_stream_point *buf,
+                           uint32_t buf_len,
+                           struct   fg_stream *pars,
+                           struct   fg_meta *meta);
+
+
+
+/*!
+ * Append a point to a STREAM function. This must only be called by the producer thread. If an error
+ * is returned, the point is not appended and fg_stream::meta contains the details of the error.
+ *
+ * @param[in,out] pars            Pointer to stream function parameters.
+ * @param[in]     time            Time of the point.
+ * @param[in]     ref             Reference value at time.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if the ring buffer is full - the point can be appended again later
+ * @retval FG_BAD_PARAMETER if fgStreamEnd() has already been called
+ * @retval FG_INVALID_TIME if time is not at least min_time_step after the previous point
+ * @retval FG_OUT_OF_LIMITS if reference value exceeds limits
+ * @retval FG_OUT_OF_RATE_LIMITS if rate of change of reference exceeds limits
+ */
+enum fg_error fgStreamAppend(struct fg_stream *pars, double time, float ref);
+
+
+
+/*!
+ * End a STREAM function. This must only be called by the producer thread. The function will end
+ * after the last appended point.
+ *
+ * @param[in,out] pars            Pointer to stream function parameters.
+ */
+void fgStreamEnd(struct fg_stream *pars);
+
+
+
+/*!
+ * Generate the reference for the STREAM function. This must only be called by the consumer thread and
+ * time must not go backwards.
+ *
+ * @param[in]  pars             Pointer to stream function parameters.
+ * @param[in]  time             Pointer to time within the function.
+ * @param[out] ref              Pointer to reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_UNDERRUN      if time is after the last point and the stream has not ended.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgStreamGen(struct fg_stream *pars, const double *time, float *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
@@ -0,0 +1,156 @@
+/*!
+ * @file    swap.h
+ * @brief   Double-buffered function parameters for re-arming while generating.
+ *
+ * The Init functions write the parameter structure of a function in place, so a
+ * function cannot be re-armed while the real-time thread is generating it. A
+ * fg_swap holds two parameter structures supplied by the application. The real-time
+ * thread generates the active function while a background thread arms the other
+ * one and publishes it with the time from which it must be used. The first time
+ * fgSwapGen() or fgSwapActive() is called at or after that time, the new function
+ * becomes active. The change is a single pointer exchange, so the real-time thread
+ * never waits.
+ *
+ * The background thread may only arm a function when fgSwapNext() returns a
+ * buffer, which is once the previously published function has become active. The
+ * buffer it returns is the one that was active before, which the real-time thread
+ * no longer uses.
+ *
+ * Only one thread may arm functions and only one thread may generate them.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_SWAP_H
+#define LIBFG_SWAP_H
+
+#include "libfg.h"
+
+/*!
+ * Generation function, e.g. (fg_gen_func)fgTableGen
+ */
+typedef enum fg_gen_status (*fg_gen_func)(void *pars, const double *time, float *ref);
+
+/*!
+ * Function buffer
+ */
+struct fg_swap_buf
+{
+    fg_gen_func             gen;            //!< Generation function for the parameters.
+    void                   *pars;           //!< Function parameters supplied by the application.
+    double                  time;           //!< Time from which the function is used.
+};
+
+/*!
+ * Double-buffered function
+ */
+struct fg_swap
+{
+    struct fg_swap_buf      buf[2];         //!< Function buffers.
+    struct fg_swap_buf     *active;         //!< Buffer used by the real-time thread (NULL until the first function is active).
+    struct fg_swap_buf     *next;           //!< Buffer published by the background thread (NULL if none is pending).
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Initialise a double-buffered function. No function is active until one has been armed.
+ *
+ * @param[in]  pars0              First parameter structure, e.g. a union of the fg_xxx structures.
+ * @param[in]  pars1              Second parameter structure, of the same type as pars0.
+ * @param[out] swap               Pointer to double-buffered function.
+ */
+void fgSwapInit(void *pars0, void *pars1, struct fg_swap *swap);
+
+
+
+/*!
+ * Get the parameter structure to arm. This must only be called by the background thread.
+ *
+ * @param[in]  swap               Pointer to double-buffered function.
+ *
+ * @retval Pointer to the parameter structure that is free to be armed.
+ * @retval NULL if the previously armed function has not yet become active.
+ */
+void *fgSwapNext(struct fg_swap *swap);
+
+
+
+/*!
+ * Publish the function armed in the parameter structure returned by fgSwapNext(). This must only be
+ * called by the background thread.
+ *
+ * @param[in,out] swap            Pointer to double-buffered function.
+ * @param[in]     gen             Generation function for the armed parameters.
+ * @param[in]     time            Time from which the function is used, e.g. the start of the next cycle.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_PARAMETER if gen is NULL or the previously armed function has not yet become active
+ */
+enum fg_error fgSwapArm(struct fg_swap *swap, fg_gen_func gen, double time);
+
+
+
+/*!
+ * Get the active function, first making the published function active if time has reached its start time.
+ * This must only be called by the real-time thread and time must not go backwards.
+ *
+ * @param[in,out] swap            Pointer to double-buffered function.
+ * @param[in]     time            Time of the iteration.
+ *
+ * @retval Pointer to the active function buffer.
+ * @retval NULL if no function is active.
+ */
+const struct fg_swap_buf *fgSwapActive(struct fg_swap *swap, double time);
+
+
+
+/*!
+ * Generate the reference for the active function, after calling fgSwapActive(). This must only be called
+ * by the real-time thread and time must not go backwards.
+ *
+ * @param[in,out] swap            Pointer to double-buffered function.
+ * @param[in]     time            Pointer to time within the function.
+ * @param[out]    ref             Pointer to reference value. Not changed if no function is active.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if no function is active or time is before the start of the active function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the active function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the active function.
+ */
+enum fg_gen_status fgSwapGen(struct fg_swap *swap, const double *time, float *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
@@ -59,6 +59,16 @@ struct fg_table
     float       seg_grad;           //!< Gradient of reference for segment fg_table::prev_seg_idx.
 };
 
+/*!
+ * Result of fgTableReduce()
+ */
+struct fg_table_reduction
+{
+    uint32_t    num_points;         //!< Number of points in the reduced table.
+    float       max_error;          //!< Largest interpolation error at the removed points.
+    float       compression;        //!< Number of input points / number of points in the reduced table.
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -68,6 +78,10 @@ extern "C" {
 /*!
  * Initialise TABLE function.
  *
+ * If fg_table::ref and fg_table::time are NULL, they are set to point to the ref and time arrays, which are then
+ * used in place and must remain valid while the function is generated. Otherwise the arrays are copied into them.
+ * This allows large tables, such as those mapped from a file by fgTableFileOpen(), to be used without a copy.
+ *
  * @param[in]  limits             Pointer to fgc_limits structure (or NULL if no limits checking required).
  * @param[in]  is_pol_switch_auto True if polarity switch can be changed automatically.
  * @param[in]  is_pol_switch_neg  True if polarity switch is currently in the negative position.
@@ -114,6 +128,66 @@ enum fg_error fgTableInit(struct   fg_limits *limits,
  */
 enum fg_gen_status fgTableGen(struct fg_table *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the Table function at any time without changing the parameters.
+ *
+ * The segment is found by a binary search of the time array instead of from
+ * fg_table::seg_idx, so the result is the same as fgTableGen() with increasing time.
+ * Long tables can therefore be sampled out of order or rendered by several threads.
+ *
+ * @param[in]  pars             Pointer to table function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgTableEval(const struct fg_table *pars, double time, float *ref);
+
+
+
+/*!
+ * Reduce the number of points in a table using the Douglas-Peucker algorithm.
+ *
+ * The first and last points are kept. Each segment of the reduced table is split at the removed point with
+ * the largest interpolation error until every removed point is within tolerance of the reduced table, when
+ * interpolated as in fgTableGen(). The split ranges are held on a heap allocated stack instead of by
+ * recursion, so tables of millions of points can be reduced.
+ *
+ * If limits are supplied, a segment is also split if its rate of change, or the acceleration at its first
+ * point, exceeds the limits. The acceleration is the change in gradient divided by the mean length of the two
+ * segments. Segments of the original table are never split, so limit errors in the original table remain and
+ * will be reported by fgTableInit().
+ *
+ * The reduced table may be written over the original table by passing the same arrays.
+ *
+ * @param[in]  limits             Pointer to fgc_limits structure (or NULL if no limits checking required).
+ * @param[in]  is_pol_switch_neg  True if the limits must be inverted.
+ * @param[in]  tolerance          Maximum interpolation error at the removed points.
+ * @param[in] *ref                Array of reference values.
+ * @param[in] *time               Array of time values.
+ * @param[in]  num_points         Number of points in the ref and time arrays.
+ * @param[out] *reduced_ref       Array for the reduced reference values (may be ref).
+ * @param[out] *reduced_time      Array for the reduced time values (may be time).
+ * @param[out] reduction          Pointer to the number of points, error and compression of the reduced table.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_ARRAY_LEN if there are less than two points
+ * @retval FG_BAD_PARAMETER if tolerance is negative or the stack cannot be allocated
+ */
+enum fg_error fgTableReduce(struct fg_limits          *limits,
+                            bool                       is_pol_switch_neg,
+                            float                      tolerance,
+                            const float               *ref,
+                            const float               *time,
+                            uint32_t                   num_points,
+                            float                     *reduced_ref,
+                            float                     *reduced_time,
+                            struct fg_table_reduction *reduction);
+
 #ifdef __cplusplus
 }
 #endif
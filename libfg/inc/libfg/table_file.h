@@ -0,0 +1,132 @@
+/*!
+ * @file    table_file.h
+ * @brief   Memory-mapped binary table files for the TABLE function.
+ *
+ * A table file holds the time and reference columns of a TABLE function in a
+ * form that can be mapped into memory and passed straight to fgTableInit(), so
+ * that large tables are neither parsed nor copied. The file starts with a
+ * fg_table_file_header, followed by the time and reference columns. Each
+ * column is a contiguous array of 32-bit floats or 64-bit doubles in native
+ * byte order, starting at an offset that is a multiple of FG_TABLE_FILE_ALIGN.
+ *
+ * With float columns, fg_table_file::time and fg_table_file::ref point into
+ * the mapped file. To use them without a copy, fg_table::ref and
+ * fg_table::time must be NULL when fgTableInit() is called. Double columns
+ * are converted to float arrays when the file is opened.
+ *
+ * Memory mapping is used on Unix-like systems. On other platforms the columns
+ * are read into allocated arrays.
+ *
+ * <h2>Contact</h2>
+ *
+ * cclibs-devs@cern.ch
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBFG_TABLE_FILE_H
+#define LIBFG_TABLE_FILE_H
+
+#include <stddef.h>
+#include "libfg.h"
+
+// Constants
+
+#define FG_TABLE_FILE_MAGIC     "FGTABLE"       //!< Table file magic string (including the terminating nul)
+#define FG_TABLE_FILE_VERSION   1               //!< Table file format version
+#define FG_TABLE_FILE_ALIGN     4096            //!< Alignment of the columns in the file (page size)
+
+/*!
+ * Table file header - all fields are in native byte order
+ */
+struct fg_table_file_header
+{
+    char        magic[8];                       //!< FG_TABLE_FILE_MAGIC
+    uint32_t    version;                        //!< FG_TABLE_FILE_VERSION
+    uint32_t    element_size;                   //!< Size of column elements: 4 (float) or 8 (double)
+    uint64_t    num_points;                     //!< Number of points in the table
+    uint64_t    time_offset;                    //!< Offset of the time column from the start of the file
+    uint64_t    ref_offset;                     //!< Offset of the reference column from the start of the file
+};
+
+/*!
+ * Open table file
+ */
+struct fg_table_file
+{
+    void       *map;                            //!< Mapped file (NULL if the columns were read or converted).
+    size_t      map_len;                        //!< Length of the mapped file.
+    float      *time;                           //!< Table time values.
+    float      *ref;                            //!< Table reference values.
+    uint32_t    num_points;                     //!< Number of points in table.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External functions
+
+/*!
+ * Open a table file and map its columns into memory.
+ *
+ * @param[in]  filename           Name of the table file.
+ * @param[out] file               Pointer to table file structure.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_PARAMETER if the file cannot be opened, mapped or read, or the header is invalid (errno is set for system errors)
+ * @retval FG_BAD_ARRAY_LEN if the columns do not fit in the file
+ */
+enum fg_error fgTableFileOpen(const char *filename, struct fg_table_file *file);
+
+
+
+/*!
+ * Close a table file opened by fgTableFileOpen(). The time and ref arrays must no longer be in use.
+ *
+ * @param[in,out] file            Pointer to table file structure.
+ */
+void fgTableFileClose(struct fg_table_file *file);
+
+
+
+/*!
+ * Write a table file with float columns.
+ *
+ * @param[in]  filename           Name of the table file.
+ * @param[in] *time               Array of time values.
+ * @param[in] *ref                Array of reference values.
+ * @param[in]  num_points         Number of points in the time and ref arrays.
+ *
+ * @retval FG_OK on success
+ * @retval FG_BAD_PARAMETER if the file cannot be written (errno is set)
+ */
+enum fg_error fgTableFileWrite(const char *filename, const float *time, const float *ref, uint32_t num_points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+// EOF
@@ -135,6 +135,23 @@ enum fg_error fgTestInit(struct fg_limits *limits,
  */
 enum fg_gen_status fgTestGen(struct fg_test *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the Test function at any time without changing the parameters.
+ *
+ * fgTestGen() calls this function since the test functions have no running state.
+ *
+ * @param[in]  pars             Pointer to test function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgTestEval(const struct fg_test *pars, double time, float *ref);
+
 #ifdef __cplusplus
 }
 #endif
@@ -131,6 +131,23 @@ enum fg_error fgTrimInit(struct fg_limits *limits,
  */
 enum fg_gen_status fgTrimGen (struct fg_trim *pars, const double *time, float *ref);
 
+
+
+/*!
+ * Evaluate the Trim function at any time without changing the parameters.
+ *
+ * fgTrimGen() calls this function since trim generation has no running state.
+ *
+ * @param[in]  pars             Pointer to trim function parameters.
+ * @param[in]  time             Time within the function.
+ * @param[out] ref              Pointer to the reference value.
+ *
+ * @retval FG_GEN_BEFORE_FUNC   if time is before the start of the function.
+ * @retval FG_GEN_DURING_FUNC   if time is during the function.
+ * @retval FG_GEN_AFTER_FUNC    if time is after the end of the function.
+ */
+enum fg_gen_status fgTrimEval (const struct fg_trim *pars, double time, float *ref);
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,7 @@ struct fg_meta * fgResetMeta(struct fg_meta *meta, struct fg_meta *local_meta, d
             meta->error.data[idx] = 0.0;
         }
 
+        meta->fg_error        = FG_OK;
         meta->error.index     = 0;
         meta->polarity        = FG_FUNC_POL_ZERO;
         meta->limits_inverted = false;
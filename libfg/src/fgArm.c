@@ -0,0 +1,144 @@
+/*!
+ * @file  fgArm.c
+ * @brief Arm many functions concurrently.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+// Worker threads are only available on Unix-like systems
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FG_ARM_THREADS
+#include <pthread.h>
+#endif
+
+#include "libfg/arm.h"
+
+#if defined(__GNUC__)
+#define FG_ARM_NEXT_JOB(arm)    __atomic_fetch_add(&(arm)->next_job, 1, __ATOMIC_RELAXED)
+#else
+#define FG_ARM_NEXT_JOB(arm)    ((arm)->next_job++)
+#endif
+
+/*!
+ * Arming jobs shared by the threads
+ */
+struct fg_arm
+{
+    struct fg_arm_job  *jobs;               //!< Array of arming jobs.
+    uint32_t            num_jobs;           //!< Number of arming jobs.
+    uint32_t            next_job;           //!< Index of the next job to run.
+};
+
+
+
+static void fgArmJobs(struct fg_arm *arm)
+{
+    struct fg_arm_job  *job;
+    uint32_t            job_idx;
+
+    // Jobs are taken one at a time because the time to arm a function depends on its length
+
+    while((job_idx = FG_ARM_NEXT_JOB(arm)) < arm->num_jobs)
+    {
+        job = &arm->jobs[job_idx];
+
+        job->fg_error = job->init(job->meta, job->idx);
+    }
+}
+
+
+
+#ifdef FG_ARM_THREADS
+static void *fgArmThread(void *arm)
+{
+    fgArmJobs(arm);
+
+    return(NULL);
+}
+#endif
+
+
+
+enum fg_error fgArm(struct fg_arm_job *jobs, uint32_t num_jobs, uint32_t num_threads)
+{
+    struct fg_arm   arm;
+    uint32_t        job_idx;
+
+    if(jobs == NULL || num_threads < 1 || num_threads > FG_ARM_MAX_THREADS)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    arm.jobs     = jobs;
+    arm.num_jobs = num_jobs;
+    arm.next_job = 0;
+
+#ifdef FG_ARM_THREADS
+    pthread_t       threads[FG_ARM_MAX_THREADS];
+    uint32_t        num_workers;
+    uint32_t        thread_idx;
+
+    // There is no point in starting more threads than there are jobs
+
+    if(num_threads > num_jobs)
+    {
+        num_threads = num_jobs > 0 ? num_jobs : 1;
+    }
+
+    // Start the worker threads - if a thread cannot be created, the remaining threads run its jobs
+
+    for(num_workers = 0 ; num_workers < num_threads - 1 ; num_workers++)
+    {
+        if(pthread_create(&threads[num_workers], NULL, fgArmThread, &arm) != 0)
+        {
+            break;
+        }
+    }
+
+    fgArmJobs(&arm);
+
+    for(thread_idx = 0 ; thread_idx < num_workers ; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+#else
+    fgArmJobs(&arm);
+#endif
+
+    // Report the first failure in job order so that the result does not depend on the number of threads
+
+    for(job_idx = 0 ; job_idx < num_jobs ; job_idx++)
+    {
+        if(jobs[job_idx].fg_error != FG_OK)
+        {
+            return(jobs[job_idx].fg_error);
+        }
+    }
+
+    return(FG_OK);
+}
+
+// EOF
@@ -338,16 +338,16 @@ enum fg_error fgPlepInit(struct fg_limits *limits,
 
 
 
-enum fg_gen_status fgPlepGen(struct fg_plep *pars, const double *time, float *ref)
+enum fg_gen_status fgPlepEval(const struct fg_plep *pars, double time, float *ref)
 {
     enum fg_gen_status status = FG_GEN_DURING_FUNC; // Set default return status
     float              r;                           // Normalised reference
     double             func_time;                   // Time within function
     float              seg_time;                    // Time within segment
 
-    // Both *time and delay must be 64-bit doubles if time is UNIX time
+    // Both time and delay must be 64-bit doubles if time is UNIX time
 
-    func_time = *time - pars->delay;
+    func_time = time - pars->delay;
 
     // Pre-acceleration coast
 
@@ -433,4 +433,11 @@ enum fg_gen_status fgPlepGen(struct fg_plep *pars, const double *time, float *re
     return(status);
 }
 
+
+
+enum fg_gen_status fgPlepGen(struct fg_plep *pars, const double *time, float *ref)
+{
+    return(fgPlepEval(pars, *time, ref));
+}
+
 // EOF
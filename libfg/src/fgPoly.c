@@ -0,0 +1,618 @@
+/*!
+ * @file  fgPoly.c
+ * @brief Compile functions into a common piecewise-polynomial form.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libfg/poly.h"
+#include "libfg/render.h"
+
+
+
+static enum fg_error fgPolyAddSeg(struct fg_poly *poly, float start, double origin,
+                                  double k0, double k1, double k2, double k3)
+{
+    struct fg_poly_seg *seg;
+    double              d;
+
+    // The first segment starts at time zero
+
+    if(start < 0.0)
+    {
+        start = 0.0;
+    }
+
+    // A segment that starts at the same time as the previous segment replaces it
+
+    if(poly->num_segs > 0 && start <= poly->segs[poly->num_segs - 1].time)
+    {
+        seg = &poly->segs[poly->num_segs - 1];
+    }
+    else if(poly->num_segs < poly->max_segs)
+    {
+        seg = &poly->segs[poly->num_segs++];
+    }
+    else
+    {
+        return(FG_BAD_ARRAY_LEN);
+    }
+
+    // Move the origin of the cubic k0 + k1.t + k2.t^2 + k3.t^3 to the start of the segment
+
+    d = start - origin;
+
+    seg->time = start;
+    seg->c[0] = k0 + d * (k1 + d * (k2 + d * k3));
+    seg->c[1] = k1 + d * (2.0 * k2 + 3.0 * k3 * d);
+    seg->c[2] = k2 + 3.0 * k3 * d;
+    seg->c[3] = k3;
+
+    return(FG_OK);
+}
+
+
+
+static enum fg_error fgPolyFit(struct fg_poly *poly,
+                               fg_eval_func    eval,
+                               const void     *pars,
+                               double          delay,
+                               float           start,
+                               float           end,
+                               float           tolerance,
+                               uint32_t        depth)
+{
+    enum fg_error       fg_error;
+    struct fg_poly_seg *seg;
+    float               h = end - start;
+    float               y[FG_POLY_NUM_COEFFS];
+    float               ref;
+    float               t;
+    double              d1;
+    double              d2;
+    double              d3;
+    double              a;
+    double              b;
+    uint32_t            i;
+
+    if(h <= 0.0)
+    {
+        return(FG_OK);
+    }
+
+    // Interpolate the function at the start, end and two thirds of the segment
+
+    for(i = 0 ; i < FG_POLY_NUM_COEFFS ; i++)
+    {
+        eval(pars, delay + (i < FG_POLY_NUM_COEFFS - 1 ? start + h * i / 3.0 : end), &y[i]);
+    }
+
+    // Solve for the cubic p(u) = y0 + a.u + b.u^2 + c.u^3 with u = t / h through u = 0, 1/3, 2/3 and 1
+
+    d1 = y[1] - y[0];
+    d2 = y[2] - y[0];
+    d3 = y[3] - y[0];
+
+    a  = 9.0 * d1 - 4.5 * d2 + d3;
+    b  = 0.5 * (27.0 * d1 - d3 - 8.0 * a);
+
+    if((fg_error = fgPolyAddSeg(poly, start, start, y[0], a / h, b / (h * h), (27.0 * d1 - 9.0 * a - 3.0 * b) / (h * h * h))))
+    {
+        return(fg_error);
+    }
+
+    // Check the error of the segment between the interpolation points, using the coefficients as stored
+
+    seg = &poly->segs[poly->num_segs - 1];
+
+    for(i = 0 ; i < FG_POLY_NUM_FIT_CHECKS ; i++)
+    {
+        t = h * (i + 0.5) / FG_POLY_NUM_FIT_CHECKS;
+
+        eval(pars, delay + start + t, &ref);
+
+        if(fabs(ref - (seg->c[0] + t * (seg->c[1] + t * (seg->c[2] + t * seg->c[3])))) > tolerance)
+        {
+            break;
+        }
+    }
+
+    if(i == FG_POLY_NUM_FIT_CHECKS)
+    {
+        return(FG_OK);
+    }
+
+    // Tolerance not reached - replace the segment by two segments of half the length
+
+    if(depth >= FG_POLY_MAX_FIT_DEPTH)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    poly->num_segs--;
+
+    t = start + 0.5 * h;
+
+    if((fg_error = fgPolyFit(poly, eval, pars, delay, start, t, tolerance, depth + 1)))
+    {
+        return(fg_error);
+    }
+
+    return(fgPolyFit(poly, eval, pars, delay, t, end, tolerance, depth + 1));
+}
+
+
+
+static void fgPolyStart(double delay, float initial_ref, struct fg_poly *poly)
+{
+    poly->delay       = delay;
+    poly->seg_idx     = 0;
+    poly->num_segs    = 0;
+    poly->initial_ref = initial_ref;
+    poly->tick_period = 0.0;
+}
+
+
+
+static uint32_t fgPolyFindSeg(const struct fg_poly *pars, double func_time)
+{
+    uint32_t seg_idx   = 0;
+    uint32_t upper_idx = pars->num_segs - 1;
+    uint32_t mid_idx;
+
+    // Binary search for the last segment that starts at or before func_time
+
+    while(seg_idx < upper_idx)
+    {
+        mid_idx = upper_idx - (upper_idx - seg_idx) / 2;
+
+        if(func_time >= pars->segs[mid_idx].time)
+        {
+            seg_idx = mid_idx;
+        }
+        else
+        {
+            upper_idx = mid_idx - 1;
+        }
+    }
+
+    return(seg_idx);
+}
+
+
+
+static enum fg_gen_status fgPolySegRef(const struct fg_poly *pars, uint32_t seg_idx, double func_time, float *ref)
+{
+    const struct fg_poly_seg *seg = &pars->segs[seg_idx];
+    float                     t   = func_time - seg->time;
+
+    *ref = seg->c[0] + t * (seg->c[1] + t * (seg->c[2] + t * seg->c[3]));
+
+    return(seg_idx < pars->num_segs - 1 ? FG_GEN_DURING_FUNC : FG_GEN_AFTER_FUNC);
+}
+
+
+
+static uint32_t fgPolyPointIdx(const struct fg_poly *pars, double start_time, double period,
+                               double func_time, uint32_t min_idx, uint32_t num_points)
+{
+    double   idx = ceil((func_time + pars->delay - start_time) / period);
+    uint32_t point_idx;
+
+    // Estimate the index of the first point at or after func_time, then correct it for rounding
+
+    point_idx = idx <= min_idx ? min_idx : (idx >= num_points ? num_points : (uint32_t)idx);
+
+    while(point_idx > min_idx && (start_time + (point_idx - 1) * period) - pars->delay >= func_time)
+    {
+        point_idx--;
+    }
+
+    while(point_idx < num_points && (start_time + point_idx * period) - pars->delay < func_time)
+    {
+        point_idx++;
+    }
+
+    return(point_idx);
+}
+
+
+
+void fgPolyInit(struct fg_poly_seg *segs, uint32_t max_segs, struct fg_poly *poly)
+{
+    poly->segs     = segs;
+    poly->max_segs = max_segs;
+
+    fgPolyStart(0.0, 0.0, poly);
+}
+
+
+
+enum fg_error fgPolyCompileTable(const struct fg_table *pars, struct fg_poly *poly)
+{
+    enum fg_error fg_error = FG_OK;
+    uint32_t      i;
+
+    fgPolyStart(pars->delay, pars->ref[0], poly);
+
+    // Each segment is anchored on its end point as in fgTableGen()
+
+    for(i = 1 ; i < pars->num_points && fg_error == FG_OK ; i++)
+    {
+        fg_error = fgPolyAddSeg(poly, pars->time[i-1], pars->time[i], pars->ref[i],
+                                (pars->ref[i] - pars->ref[i-1]) / (pars->time[i] - pars->time[i-1]), 0.0, 0.0);
+    }
+
+    if(fg_error == FG_OK)
+    {
+        fg_error = fgPolyAddSeg(poly, pars->time[pars->num_points - 1], 0.0, pars->ref[pars->num_points - 1], 0.0, 0.0, 0.0);
+    }
+
+    return(fg_error);
+}
+
+
+
+enum fg_error fgPolyCompilePppl(const struct fg_pppl *pars, struct fg_poly *poly)
+{
+    enum fg_error fg_error = FG_OK;
+    uint32_t      i;
+
+    fgPolyStart(pars->delay, pars->initial_ref, poly);
+
+    // PPPL coefficients are relative to the end of each segment
+
+    for(i = 0 ; i < pars->num_segs && fg_error == FG_OK ; i++)
+    {
+        fg_error = fgPolyAddSeg(poly, i > 0 ? pars->time[i-1] : 0.0, pars->time[i],
+                                pars->a0[i], pars->a1[i], pars->a2[i], 0.0);
+    }
+
+    if(fg_error == FG_OK)
+    {
+        fg_error = fgPolyAddSeg(poly, pars->time[pars->num_segs - 1], 0.0, pars->a0[pars->num_segs - 1], 0.0, 0.0, 0.0);
+    }
+
+    return(fg_error);
+}
+
+
+
+enum fg_error fgPolyCompileRamp(const struct fg_ramp *pars, struct fg_poly *poly)
+{
+    enum fg_error fg_error;
+
+    fgPolyStart(pars->delay, pars->initial_ref, poly);
+
+    // Accelerating parabola from time zero, decelerating parabola to the end, then coast
+
+    if((fg_error = fgPolyAddSeg(poly, 0.0,           0.0,           pars->ref[0], 0.0, 0.5 * pars->acceleration, 0.0)) ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[1], pars->time[2], pars->ref[2], 0.0, 0.5 * pars->deceleration, 0.0)) ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[2], 0.0,           pars->ref[2], 0.0, 0.0, 0.0)))
+    {
+        return(fg_error);
+    }
+
+    return(FG_OK);
+}
+
+
+
+enum fg_error fgPolyCompileTrim(const struct fg_trim *pars, struct fg_poly *poly)
+{
+    enum fg_error fg_error;
+
+    fgPolyStart(pars->delay, pars->initial_ref, poly);
+
+    // Cubic about time_offset, then coast
+
+    if((fg_error = fgPolyAddSeg(poly, 0.0,            pars->time_offset, pars->ref_offset, pars->c, 0.0, pars->a)) ||
+       (fg_error = fgPolyAddSeg(poly, pars->duration, 0.0,               pars->final_ref,  0.0,     0.0, 0.0)))
+    {
+        return(fg_error);
+    }
+
+    return(FG_OK);
+}
+
+
+
+enum fg_error fgPolyCompilePlep(const struct fg_plep *pars, float tolerance, struct fg_poly *poly)
+{
+    enum fg_error fg_error;
+    double        norm = pars->normalisation;
+
+    if(!(tolerance > 0.0))
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    fgPolyStart(pars->delay, norm * pars->ref[0], poly);
+
+    // The reference is de-normalised by scaling the coefficients. Segments with zero length are replaced
+    // by the following segment.
+
+    if((fg_error = fgPolyAddSeg(poly, 0.0,           pars->time[0], norm * pars->ref[0], 0.0, norm * 0.5 * pars->acceleration, 0.0)) ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[1], pars->time[1], norm * pars->ref[1], norm * pars->linear_rate, 0.0, 0.0))    ||
+       (fg_error = fgPolyFit   (poly, (fg_eval_func)fgPlepEval, pars, pars->delay, pars->time[2], pars->time[3], tolerance, 0))  ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[3], pars->time[4], norm * pars->ref[4], 0.0, -norm * 0.5 * pars->acceleration, 0.0)) ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[4], pars->time[4], norm * pars->ref[4], 0.0, norm * 0.5 * pars->final_acc, 0.0))     ||
+       (fg_error = fgPolyAddSeg(poly, pars->time[5], pars->time[5], norm * pars->ref[5], norm * pars->final_rate, 0.0, 0.0)))
+    {
+        return(fg_error);
+    }
+
+    return(FG_OK);
+}
+
+
+
+enum fg_error fgPolyCompileTest(const struct fg_test *pars, float tolerance, struct fg_poly *poly)
+{
+    enum fg_error fg_error = FG_OK;
+    uint32_t      num_halves = pars->num_cycles;
+    uint32_t      i;
+
+    fgPolyStart(pars->delay, pars->initial_ref, poly);
+
+    switch(pars->type)
+    {
+        case FG_TEST_STEPS:
+
+            for(i = 0 ; i < pars->num_cycles && fg_error == FG_OK ; i++)
+            {
+                fg_error = fgPolyAddSeg(poly, 2.0 * pars->half_period * i, 0.0,
+                                        pars->initial_ref + pars->amplitude * (float)(i + 1), 0.0, 0.0, 0.0);
+            }
+            break;
+
+        case FG_TEST_SQUARE:
+
+            // For SQUARE, fg_test::num_cycles is the number of half periods
+
+            for(i = 0 ; i < pars->num_cycles && fg_error == FG_OK ; i++)
+            {
+                fg_error = fgPolyAddSeg(poly, pars->half_period * i, 0.0,
+                                        pars->initial_ref + (i & 0x1 ? 0.0 : pars->amplitude), 0.0, 0.0, 0.0);
+            }
+            break;
+
+        case FG_TEST_SINE:
+        case FG_TEST_COSINE:
+
+            if(!(tolerance > 0.0))
+            {
+                return(FG_BAD_PARAMETER);
+            }
+
+            // Fit each half period separately so that the ends of the window are segment boundaries
+
+            num_halves *= 2;
+
+            for(i = 0 ; i < num_halves && fg_error == FG_OK ; i++)
+            {
+                fg_error = fgPolyFit(poly, (fg_eval_func)fgTestEval, pars, pars->delay,
+                                     pars->half_period * i, i < num_halves - 1 ? pars->half_period * (i + 1) : pars->duration,
+                                     tolerance, 0);
+            }
+            break;
+
+        default:
+
+            return(FG_BAD_PARAMETER);
+    }
+
+    if(fg_error == FG_OK)
+    {
+        fg_error = fgPolyAddSeg(poly, pars->duration, 0.0, pars->final_ref, 0.0, 0.0, 0.0);
+    }
+
+    return(fg_error);
+}
+
+
+
+enum fg_gen_status fgPolyGen(struct fg_poly *pars, const double *time, float *ref)
+{
+    double   func_time;                     // Time within function
+    uint32_t seg_idx = pars->seg_idx;       // Segment index from previous call
+
+    // Both *time and delay must be 64-bit doubles if time is UNIX time
+
+    func_time = *time - pars->delay;
+
+    // Pre-function coast
+
+    if(func_time < 0.0)
+    {
+        *ref = pars->initial_ref;
+
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    // Restart from the first segment if time has gone backwards
+
+    if(func_time < pars->segs[seg_idx].time)
+    {
+        seg_idx = 0;
+    }
+
+    while(seg_idx < pars->num_segs - 1 && func_time >= pars->segs[seg_idx + 1].time)
+    {
+        seg_idx++;
+    }
+
+    pars->seg_idx = seg_idx;
+
+    return(fgPolySegRef(pars, seg_idx, func_time, ref));
+}
+
+
+
+enum fg_gen_status fgPolyEval(const struct fg_poly *pars, double time, float *ref)
+{
+    double   func_time = time - pars->delay;
+
+    if(func_time < 0.0)
+    {
+        *ref = pars->initial_ref;
+
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    return(fgPolySegRef(pars, fgPolyFindSeg(pars, func_time), func_time, ref));
+}
+
+
+
+enum fg_error fgPolyTicksInit(double tick_period, struct fg_poly *poly)
+{
+    struct fg_poly_seg *seg;
+    double              delay_ticks;
+    double              seg_ticks;
+    uint32_t            i;
+
+    if(!(tick_period > 0.0))
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    // Segment ticks are relative to the rounded delay so that they are exact even if the delay is large
+
+    delay_ticks = floor(poly->delay / tick_period + 0.5);
+
+    for(i = 0 ; i < poly->num_segs ; i++)
+    {
+        seg       = &poly->segs[i];
+        seg_ticks = ceil(seg->time / tick_period);
+
+        if(fabs(delay_ticks + seg_ticks) >= 9.0E18)
+        {
+            return(FG_BAD_PARAMETER);
+        }
+
+        seg->tick        = (int64_t)delay_ticks + (int64_t)seg_ticks;
+        seg->tick_offset = seg_ticks * tick_period - seg->time;
+    }
+
+    poly->tick_period = tick_period;
+    poly->seg_idx     = 0;
+
+    return(FG_OK);
+}
+
+
+
+enum fg_gen_status fgPolyGenTicks(struct fg_poly *pars, int64_t tick, float *ref)
+{
+    const struct fg_poly_seg *seg;
+    uint32_t                  seg_idx = pars->seg_idx;
+    float                     t;
+
+    // Pre-function coast - the first segment starts with the function
+
+    if(tick < pars->segs[0].tick)
+    {
+        *ref = pars->initial_ref;
+
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    // Restart from the first segment if the tick count has gone backwards
+
+    if(tick < pars->segs[seg_idx].tick)
+    {
+        seg_idx = 0;
+    }
+
+    while(seg_idx < pars->num_segs - 1 && tick >= pars->segs[seg_idx + 1].tick)
+    {
+        seg_idx++;
+    }
+
+    pars->seg_idx = seg_idx;
+
+    // Time within the segment from the number of ticks since the first tick in the segment. This is
+    // calculated in double precision since a float tick count is not exact beyond 2^24 ticks.
+
+    seg = &pars->segs[seg_idx];
+    t   = (double)(tick - seg->tick) * pars->tick_period + seg->tick_offset;
+
+    *ref = seg->c[0] + t * (seg->c[1] + t * (seg->c[2] + t * seg->c[3]));
+
+    return(seg_idx < pars->num_segs - 1 ? FG_GEN_DURING_FUNC : FG_GEN_AFTER_FUNC);
+}
+
+
+
+void fgPolyRender(const struct fg_poly *pars, double start_time, double period, uint32_t num_points, float *ref)
+{
+    const struct fg_poly_seg *seg;
+    uint32_t                  seg_idx;
+    uint32_t                  end_idx;
+    uint32_t                  i;
+    double                    seg_start;
+    float                     c0, c1, c2, c3;
+    float                     t;
+
+    // Pre-function coast
+
+    end_idx = fgPolyPointIdx(pars, start_time, period, 0.0, 0, num_points);
+
+    for(i = 0 ; i < end_idx ; i++)
+    {
+        ref[i] = pars->initial_ref;
+    }
+
+    if(i == num_points)
+    {
+        return;
+    }
+
+    // Render the points in each segment in turn, starting with the segment containing point i
+
+    for(seg_idx = fgPolyFindSeg(pars, (start_time + i * period) - pars->delay) ; i < num_points ; seg_idx++)
+    {
+        seg = &pars->segs[seg_idx];
+
+        end_idx = seg_idx < pars->num_segs - 1
+                ? fgPolyPointIdx(pars, start_time, period, pars->segs[seg_idx + 1].time, i, num_points)
+                : num_points;
+
+        seg_start = seg->time;
+        c0 = seg->c[0];
+        c1 = seg->c[1];
+        c2 = seg->c[2];
+        c3 = seg->c[3];
+
+        // Same arithmetic as fgPolyEval(), without branches
+
+        for( ; i < end_idx ; i++)
+        {
+            t      = ((start_time + i * period) - pars->delay) - seg_start;
+            ref[i] = c0 + t * (c1 + t * (c2 + t * c3));
+        }
+    }
+}
+
+// EOF
@@ -366,4 +366,62 @@ enum fg_gen_status fgPpplGen(struct fg_pppl *pars, const double *time, float *re
     return(FG_GEN_DURING_FUNC);
 }
 
+
+
+enum fg_gen_status fgPpplEval(const struct fg_pppl *pars, double time, float *ref)
+{
+    double   func_time;                     // Time within function
+    float    seg_time;                      // Time within segment
+    uint32_t seg_idx;                       // Index of the segment containing func_time
+    uint32_t upper_idx;                     // Binary search upper bound
+    uint32_t mid_idx;                       // Binary search mid point
+
+    func_time = time - pars->delay;
+
+    // Coast during run delay
+
+    if(func_time < 0.0)
+    {
+        *ref = pars->initial_ref;
+
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    // Coast from last reference after the end of the function
+
+    if(func_time > pars->time[pars->num_segs - 1])
+    {
+        *ref = pars->a0[pars->num_segs - 1];
+
+        return(FG_GEN_AFTER_FUNC);
+    }
+
+    // Binary search for the first segment that ends at or after func_time
+
+    seg_idx   = 0;
+    upper_idx = pars->num_segs - 1;
+
+    while(seg_idx < upper_idx)
+    {
+        mid_idx = seg_idx + (upper_idx - seg_idx) / 2;
+
+        if(func_time > pars->time[mid_idx])
+        {
+            seg_idx = mid_idx + 1;
+        }
+        else
+        {
+            upper_idx = mid_idx;
+        }
+    }
+
+    // seg_time is time within the segment
+
+    seg_time = func_time - pars->time[seg_idx];
+
+    *ref = pars->a0[seg_idx] + (pars->a1[seg_idx] + pars->a2[seg_idx] * seg_time) * seg_time;
+
+    return(FG_GEN_DURING_FUNC);
+}
+
 // EOF
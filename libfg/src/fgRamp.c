@@ -373,4 +373,48 @@ enum fg_gen_status fgRampGen(struct fg_ramp *pars, const double *time, float *re
     return(status);
 }
 
+
+
+enum fg_gen_status fgRampEval(const struct fg_ramp *pars, double time, float *ref)
+{
+    double      ref_time;                           // Time within the segment in seconds
+
+    // Pre-function coast
+
+    if(time < pars->delay)
+    {
+        *ref = pars->initial_ref;
+
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    ref_time = time - pars->delay;
+
+    // Parabolic acceleration
+
+    if(ref_time <= pars->time[1])
+    {
+        *ref = pars->ref[0] + 0.5 * pars->acceleration * ref_time * ref_time;
+    }
+
+    // Parabolic deceleration
+
+    else if(ref_time <= pars->time[2])
+    {
+        ref_time -= pars->time[2];        // ref_time is relative to end of parabola (negative)
+        *ref = pars->ref[2] + 0.5 * pars->deceleration * ref_time * ref_time;
+    }
+
+    // Coast
+
+    else
+    {
+        *ref = pars->ref[2];
+
+        return(FG_GEN_AFTER_FUNC);
+    }
+
+    return(FG_GEN_DURING_FUNC);
+}
+
 // EOF
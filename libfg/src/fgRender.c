@@ -0,0 +1,164 @@
+/*!
+ * @file  fgRender.c
+ * @brief Render a function at regular times using several threads.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+// Worker threads are only available on Unix-like systems
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FG_RENDER_THREADS
+#include <pthread.h>
+#endif
+
+#include "libfg/render.h"
+
+#if defined(__GNUC__)
+#define FG_RENDER_NEXT_CHUNK(render)    __atomic_fetch_add(&(render)->next_chunk, 1, __ATOMIC_RELAXED)
+#else
+#define FG_RENDER_NEXT_CHUNK(render)    ((render)->next_chunk++)
+#endif
+
+/*!
+ * Rendering job shared by the threads
+ */
+struct fg_render
+{
+    fg_eval_func    eval;                   //!< Stateless evaluation function.
+    const void     *pars;                   //!< Function parameters.
+    double          start_time;             //!< Time of the first point.
+    double          period;                 //!< Time between points.
+    uint32_t        num_points;             //!< Number of points to render.
+    uint32_t        next_chunk;             //!< Index of the next chunk to render.
+    float          *ref;                    //!< Rendered reference values.
+};
+
+
+
+static void fgRenderChunks(struct fg_render *render)
+{
+    uint64_t    first_idx;
+    uint64_t    end_idx;
+    uint64_t    idx;
+
+    // Take chunks until all the points have been rendered
+
+    for(;;)
+    {
+        first_idx = (uint64_t)FG_RENDER_NEXT_CHUNK(render) * FG_RENDER_CHUNK_LEN;
+
+        if(first_idx >= render->num_points)
+        {
+            return;
+        }
+
+        end_idx = first_idx + FG_RENDER_CHUNK_LEN;
+
+        if(end_idx > render->num_points)
+        {
+            end_idx = render->num_points;
+        }
+
+        for(idx = first_idx ; idx < end_idx ; idx++)
+        {
+            render->eval(render->pars, render->start_time + idx * render->period, &render->ref[idx]);
+        }
+    }
+}
+
+
+
+#ifdef FG_RENDER_THREADS
+static void *fgRenderThread(void *render)
+{
+    fgRenderChunks(render);
+
+    return(NULL);
+}
+#endif
+
+
+
+enum fg_error fgRender(fg_eval_func eval,
+                       const void  *pars,
+                       double       start_time,
+                       double       period,
+                       uint32_t     num_points,
+                       uint32_t     num_threads,
+                       float       *ref)
+{
+    struct fg_render    render;
+
+    if(eval == NULL || pars == NULL || ref == NULL || num_threads < 1 || num_threads > FG_RENDER_MAX_THREADS)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    render.eval       = eval;
+    render.pars       = pars;
+    render.start_time = start_time;
+    render.period     = period;
+    render.num_points = num_points;
+    render.next_chunk = 0;
+    render.ref        = ref;
+
+#ifdef FG_RENDER_THREADS
+    pthread_t           threads[FG_RENDER_MAX_THREADS];
+    uint32_t            num_chunks = (num_points + (FG_RENDER_CHUNK_LEN - 1ULL)) / FG_RENDER_CHUNK_LEN;
+    uint32_t            num_workers;
+    uint32_t            thread_idx;
+
+    // There is no point in starting more threads than there are chunks
+
+    if(num_threads > num_chunks)
+    {
+        num_threads = num_chunks > 0 ? num_chunks : 1;
+    }
+
+    // Start the worker threads - if a thread cannot be created, the remaining threads render its share
+
+    for(num_workers = 0 ; num_workers < num_threads - 1 ; num_workers++)
+    {
+        if(pthread_create(&threads[num_workers], NULL, fgRenderThread, &render) != 0)
+        {
+            break;
+        }
+    }
+
+    fgRenderChunks(&render);
+
+    for(thread_idx = 0 ; thread_idx < num_workers ; thread_idx++)
+    {
+        pthread_join(threads[thread_idx], NULL);
+    }
+#else
+    fgRenderChunks(&render);
+#endif
+
+    return(FG_OK);
+}
+
+// EOF
@@ -0,0 +1,256 @@
+/*!
+ * @file  fgStream.c
+ * @brief Generate linearly interpolated functions from a stream of points.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libfg/stream.h"
+
+// The ring indexes are published with release stores and read with acquire loads, so that a point
+// is visible to the consumer before the write index that covers it, and a slot is only reused once
+// the consumer has copied it. Without GCC atomics (e.g. single core DSPs) volatile access is used.
+
+#if defined(__GNUC__)
+#define FG_STREAM_LOAD_ACQUIRE(var)           __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define FG_STREAM_STORE_RELEASE(var, value)   __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#else
+#define FG_STREAM_LOAD_ACQUIRE(var)           (*(volatile uint32_t *)&(var))
+#define FG_STREAM_STORE_RELEASE(var, value)   (*(volatile uint32_t *)&(var) = (value))
+#endif
+
+
+
+enum fg_error fgStreamInit(struct   fg_limits *limits,
+                           bool     is_pol_switch_auto,
+                           bool     is_pol_switch_neg,
+                           double   delay,
+                           float    min_time_step,
+                           float    initial_ref,
+                           struct   fg_stream_point *buf,
+                           uint32_t buf_len,
+                           struct   fg_stream *pars,
+                           struct   fg_meta *meta)
+{
+    enum fg_error  fg_error;       // Limit checking status
+    struct fg_meta local_meta;     // Local meta data in case user meta is NULL
+
+    // Reset meta structure - uses local_meta if meta is NULL
+
+    meta = fgResetMeta(meta, &local_meta, delay, initial_ref);
+
+    // Ring buffer length must be a power of 2
+
+    if(buf == NULL || buf_len < 2 || (buf_len & (buf_len - 1)) != 0)
+    {
+        meta->error.data[0] = (float)buf_len;
+
+        fg_error = FG_BAD_ARRAY_LEN;
+        goto error;
+    }
+
+    // The polarity of the rest of the function is unknown so the limits follow the switch position
+
+    fgSetFuncPolarity(meta, is_pol_switch_auto, is_pol_switch_neg);
+
+    meta->limits_inverted = is_pol_switch_neg;
+
+    if(limits != NULL && (fg_error = fgCheckRef(limits, initial_ref, 0.0, 0.0, meta)))
+    {
+        goto error;
+    }
+
+    // Prepare stream parameters - the first segment ends at the initial point
+
+    pars->delay          = delay;
+    pars->buf            = buf;
+    pars->buf_mask       = buf_len - 1;
+    pars->write_idx      = 0;
+    pars->is_end         = 0;
+    pars->limits         = limits;
+    pars->min_time_step  = min_time_step * (1.0 - FG_CLIP_LIMIT_FACTOR);  // Adjust min time step to avoid rounding errs
+    pars->last.time      = 0.0;
+    pars->last.ref       = initial_ref;
+    pars->meta           = *meta;
+    pars->read_idx       = 0;
+    pars->seg_start      = pars->last;
+    pars->seg_end        = pars->last;
+    pars->seg_grad       = 0.0;
+
+    return(FG_OK);
+
+    // Error - store error code in meta and return to caller
+
+    error:
+
+        meta->fg_error = fg_error;
+        return(fg_error);
+}
+
+
+
+enum fg_error fgStreamAppend(struct fg_stream *pars, double time, float ref)
+{
+    enum fg_error   fg_error;                       // Limit checking status
+    struct fg_meta *meta = &pars->meta;             // Meta data for the stream
+    uint32_t        write_idx = pars->write_idx;    // Only the producer writes write_idx
+    float           grad;                           // Segment gradient
+
+    if(pars->is_end != 0)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    // Report a full ring without an error in meta since the point can be appended later
+
+    if(write_idx - FG_STREAM_LOAD_ACQUIRE(pars->read_idx) > pars->buf_mask)
+    {
+        return(FG_BAD_ARRAY_LEN);
+    }
+
+    // Check the time and limits for the new segment
+
+    if(time < (pars->last.time + pars->min_time_step))
+    {
+        meta->error.index   = write_idx + 1;
+        meta->error.data[0] = time;
+        meta->error.data[1] = pars->last.time + pars->min_time_step;
+        meta->error.data[2] = pars->min_time_step;
+
+        fg_error = FG_INVALID_TIME;
+        goto error;
+    }
+
+    if(pars->limits != NULL)
+    {
+        grad = (ref - pars->last.ref) / (time - pars->last.time);
+
+        if((fg_error = fgCheckRef(pars->limits, ref,            grad, 0.0, meta)) ||
+           (fg_error = fgCheckRef(pars->limits, pars->last.ref, grad, 0.0, meta)))
+        {
+            meta->error.index = write_idx + 1;
+            goto error;
+        }
+    }
+
+    // Publish the point to the consumer
+
+    pars->buf[write_idx & pars->buf_mask].time = time;
+    pars->buf[write_idx & pars->buf_mask].ref  = ref;
+
+    FG_STREAM_STORE_RELEASE(pars->write_idx, write_idx + 1);
+
+    // Update meta data
+
+    pars->last.time = time;
+    pars->last.ref  = ref;
+
+    fgSetMinMax(meta, ref);
+
+    if(ref > 0.0)
+    {
+        meta->polarity |= FG_FUNC_POL_POSITIVE;
+    }
+    else if(ref < 0.0)
+    {
+        meta->polarity |= FG_FUNC_POL_NEGATIVE;
+    }
+
+    meta->duration  = time;
+    meta->range.end = ref;
+
+    return(FG_OK);
+
+    // Error - store error code in meta and return to caller
+
+    error:
+
+        meta->fg_error = fg_error;
+        return(fg_error);
+}
+
+
+
+void fgStreamEnd(struct fg_stream *pars)
+{
+    FG_STREAM_STORE_RELEASE(pars->is_end, 1);
+}
+
+
+
+enum fg_gen_status fgStreamGen(struct fg_stream *pars, const double *time, float *ref)
+{
+    double   func_time;                     // Time within function
+    uint32_t read_idx;                      // Only the consumer writes read_idx
+
+    // Both *time and delay must be 64-bit doubles if time is UNIX time
+
+    func_time = *time - pars->delay;
+
+    // Pre-acceleration coast
+
+    if(func_time < 0.0)
+    {
+         *ref = pars->seg_start.ref;
+
+         return(FG_GEN_BEFORE_FUNC);
+    }
+
+    // Take points from the ring until the segment contains the current time
+
+    while(func_time >= pars->seg_end.time)
+    {
+        read_idx = pars->read_idx;
+
+        if(read_idx == FG_STREAM_LOAD_ACQUIRE(pars->write_idx))
+        {
+            // No more points - hold the last point and check whether the stream has ended. The write index
+            // is read again after is_end because the producer may have appended a point before ending.
+
+            *ref = pars->seg_end.ref;
+
+            if(FG_STREAM_LOAD_ACQUIRE(pars->is_end) != 0 && read_idx == FG_STREAM_LOAD_ACQUIRE(pars->write_idx))
+            {
+                return(FG_GEN_AFTER_FUNC);
+            }
+
+            return(FG_GEN_UNDERRUN);
+        }
+
+        pars->seg_start = pars->seg_end;
+        pars->seg_end   = pars->buf[read_idx & pars->buf_mask];
+
+        FG_STREAM_STORE_RELEASE(pars->read_idx, read_idx + 1);
+
+        pars->seg_grad  = (pars->seg_end.ref  - pars->seg_start.ref) /
+                          (pars->seg_end.time - pars->seg_start.time);
+    }
+
+    // Calculate reference using segment gradient
+
+    *ref = pars->seg_end.ref - (pars->seg_end.time - func_time) * pars->seg_grad;
+
+    return(FG_GEN_DURING_FUNC);
+}
+
+// EOF
@@ -0,0 +1,126 @@
+/*!
+ * @file  fgSwap.c
+ * @brief Double-buffered function parameters for re-arming while generating.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libfg/swap.h"
+
+// The background thread writes a buffer before publishing it with a release store, and the real-time
+// thread releases the old buffer by clearing swap::next after it has stored the new active pointer.
+
+#if defined(__GNUC__)
+#define FG_SWAP_LOAD_ACQUIRE(var)           __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define FG_SWAP_STORE_RELEASE(var, value)   __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#else
+#define FG_SWAP_LOAD_ACQUIRE(var)           (*(struct fg_swap_buf * volatile *)&(var))
+#define FG_SWAP_STORE_RELEASE(var, value)   (*(struct fg_swap_buf * volatile *)&(var) = (value))
+#endif
+
+
+
+static struct fg_swap_buf *fgSwapFreeBuf(struct fg_swap *swap)
+{
+    // The free buffer is the one that is not active
+
+    return(FG_SWAP_LOAD_ACQUIRE(swap->active) == &swap->buf[0] ? &swap->buf[1] : &swap->buf[0]);
+}
+
+
+
+void fgSwapInit(void *pars0, void *pars1, struct fg_swap *swap)
+{
+    swap->buf[0].gen  = NULL;
+    swap->buf[0].pars = pars0;
+    swap->buf[0].time = 0.0;
+    swap->buf[1].gen  = NULL;
+    swap->buf[1].pars = pars1;
+    swap->buf[1].time = 0.0;
+    swap->active      = NULL;
+    swap->next        = NULL;
+}
+
+
+
+void *fgSwapNext(struct fg_swap *swap)
+{
+    if(FG_SWAP_LOAD_ACQUIRE(swap->next) != NULL)
+    {
+        return(NULL);
+    }
+
+    return(fgSwapFreeBuf(swap)->pars);
+}
+
+
+
+enum fg_error fgSwapArm(struct fg_swap *swap, fg_gen_func gen, double time)
+{
+    struct fg_swap_buf *buf;
+
+    if(gen == NULL || FG_SWAP_LOAD_ACQUIRE(swap->next) != NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    buf = fgSwapFreeBuf(swap);
+
+    buf->gen  = gen;
+    buf->time = time;
+
+    FG_SWAP_STORE_RELEASE(swap->next, buf);
+
+    return(FG_OK);
+}
+
+
+
+const struct fg_swap_buf *fgSwapActive(struct fg_swap *swap, double time)
+{
+    struct fg_swap_buf *next = FG_SWAP_LOAD_ACQUIRE(swap->next);
+
+    if(next != NULL && time >= next->time)
+    {
+        FG_SWAP_STORE_RELEASE(swap->active, next);
+        FG_SWAP_STORE_RELEASE(swap->next,   NULL);
+    }
+
+    return(swap->active);
+}
+
+
+
+enum fg_gen_status fgSwapGen(struct fg_swap *swap, const double *time, float *ref)
+{
+    const struct fg_swap_buf *active = fgSwapActive(swap, *time);
+
+    if(active == NULL)
+    {
+        return(FG_GEN_BEFORE_FUNC);
+    }
+
+    return(active->gen(active->pars, time, ref));
+}
+
+// EOF
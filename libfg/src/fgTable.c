@@ -46,6 +46,9 @@ enum fg_error fgTableInit(struct   fg_limits *limits,
     uint32_t       i;              // loop variable
     uint32_t       num_points;     // Number of points in the table
     float          grad;           // Segment gradient
+    bool           check_limits;   // Check limits in the same pass as the time values
+    enum fg_error  limits_error;   // First limit error found while checking the time values
+    uint32_t       error_idx;      // Index of first limit error
     struct fg_meta local_meta;     // Local meta data in case user meta is NULL
 
     // Reset meta structure - uses local_meta if meta is NULL
@@ -77,6 +80,18 @@ enum fg_error fgTableInit(struct   fg_limits *limits,
     num_points     = ref_num_els;
     min_time_step *= (1.0 - FG_CLIP_LIMIT_FACTOR);      // Adjust min time step to avoid rounding errs
 
+    // If the limits inversion does not depend on the function polarity, the limits can be checked in the
+    // same pass as the time values so that large tables are only scanned once
+
+    check_limits = limits != NULL && is_pol_switch_auto == false;
+    limits_error = FG_OK;
+    error_idx    = 0;
+
+    if(check_limits)
+    {
+        meta->limits_inverted = is_pol_switch_neg;
+    }
+
     for(i = 1 ; i < num_points ; i++)
     {
         if(time[i] < (time[i - 1] + min_time_step))        // Check time values
@@ -91,6 +106,19 @@ enum fg_error fgTableInit(struct   fg_limits *limits,
         }
 
         fgSetMinMax(meta, ref[i]);
+
+        // Keep the first limit error but continue to check the time values, which take precedence
+
+        if(check_limits && limits_error == FG_OK)
+        {
+            grad = (ref[i] - ref[i - 1]) / (time[i] - time[i - 1]);
+
+            if((limits_error = fgCheckRef(limits, ref[i],     grad, 0.0, meta)) ||
+               (limits_error = fgCheckRef(limits, ref[i - 1], grad, 0.0, meta)))
+            {
+                error_idx = i;
+            }
+        }
     }
 
     // Complete meta data
@@ -102,7 +130,14 @@ enum fg_error fgTableInit(struct   fg_limits *limits,
 
     // Check reference function limits if provided
 
-    if(limits != NULL)
+    if(limits_error != FG_OK)
+    {
+        meta->error.index = error_idx;
+        fg_error = limits_error;
+        goto error;
+    }
+
+    if(limits != NULL && check_limits == false)
     {
         for(i = 1 ; i < num_points ; i++)
         {
@@ -209,4 +244,180 @@ enum fg_gen_status fgTableGen(struct fg_table *pars, const double *time, float *
     return(FG_GEN_DURING_FUNC);
 }
 
+
+
+enum fg_gen_status fgTableEval(const struct fg_table *pars, double time, float *ref)
+{
+    double   func_time;                     // Time within function
+    uint32_t seg_idx;                       // Index of the end of the segment containing func_time
+    uint32_t upper_idx;                     // Binary search upper bound
+    uint32_t mid_idx;                       // Binary search mid point
+    float    seg_grad;                      // Segment gradient
+
+    func_time = time - pars->delay;
+
+    // Pre-acceleration coast
+
+    if(func_time < 0.0)
+    {
+         *ref = pars->ref[0];
+
+         return(FG_GEN_BEFORE_FUNC);
+    }
+
+    // Coast after the end of the table
+
+    if(func_time >= pars->time[pars->num_points - 1])
+    {
+        *ref = pars->ref[pars->num_points - 1];
+
+        return(FG_GEN_AFTER_FUNC);
+    }
+
+    // Binary search for the first point after func_time - time[0] is zero so the segment index is at least 1
+
+    seg_idx   = 1;
+    upper_idx = pars->num_points - 1;
+
+    while(seg_idx < upper_idx)
+    {
+        mid_idx = seg_idx + (upper_idx - seg_idx) / 2;
+
+        if(func_time >= pars->time[mid_idx])
+        {
+            seg_idx = mid_idx + 1;
+        }
+        else
+        {
+            upper_idx = mid_idx;
+        }
+    }
+
+    // Calculate reference in the same way as fgTableGen()
+
+    seg_grad = (pars->ref [seg_idx] - pars->ref [seg_idx - 1]) /
+               (pars->time[seg_idx] - pars->time[seg_idx - 1]);
+
+    *ref = pars->ref[seg_idx] - (pars->time[seg_idx] - func_time) * seg_grad;
+
+    return(FG_GEN_DURING_FUNC);
+}
+
+
+enum fg_error fgTableReduce(struct fg_limits          *limits,
+                            bool                       is_pol_switch_neg,
+                            float                      tolerance,
+                            const float               *ref,
+                            const float               *time,
+                            uint32_t                   num_points,
+                            float                     *reduced_ref,
+                            float                     *reduced_time,
+                            struct fg_table_reduction *reduction)
+{
+    struct fg_meta meta;            // Meta data for fgCheckRef()
+    uint32_t      *stack;           // Stack of the ends of the ranges still to be reduced
+    uint32_t       stack_len = 0;   // Number of ranges on the stack
+    uint32_t       start_idx = 0;   // Start of current range (already in reduced table)
+    uint32_t       end_idx;         // End of current range
+    uint32_t       max_idx;         // Index of the point with the largest error in the current range
+    uint32_t       num_reduced = 1; // Number of points in reduced table
+    uint32_t       i;               // loop variable
+    float          grad;            // Gradient of current range
+    float          acceleration;    // Acceleration at the start of current range
+    float          prev_grad = 0.0; // Gradient of the previous segment in the reduced table
+    float          prev_dt   = 0.0; // Length of the previous segment in the reduced table
+    float          err;             // Interpolation error
+    float          max_err;         // Largest interpolation error in current range
+    float          max_error = 0.0; // Largest interpolation error in reduced table
+
+    if(num_points < 2)
+    {
+        return(FG_BAD_ARRAY_LEN);
+    }
+
+    if(!(tolerance >= 0.0) || (stack = malloc(num_points * sizeof(uint32_t))) == NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    fgResetMeta(&meta, NULL, 0.0, ref[0]);
+
+    meta.limits_inverted = is_pol_switch_neg;
+
+    // Ranges are reduced from left to right so the points are written in order, at or before their
+    // original index. This allows the reduced table to overwrite the original.
+
+    reduced_ref [0] = ref [0];
+    reduced_time[0] = time[0];
+
+    end_idx = num_points - 1;
+
+    for(;;)
+    {
+        // Find the point furthest from the straight line between the ends of the range
+
+        grad    = (ref[end_idx] - ref[start_idx]) / (time[end_idx] - time[start_idx]);
+        max_err = 0.0;
+        max_idx = start_idx;
+
+        for(i = start_idx + 1 ; i < end_idx ; i++)
+        {
+            err = fabs(ref[i] - (ref[end_idx] - (time[end_idx] - time[i]) * grad));
+
+            if(err > max_err)
+            {
+                max_err = err;
+                max_idx = i;
+            }
+        }
+
+        acceleration = num_reduced > 1 ? (grad - prev_grad) / (0.5 * (prev_dt + time[end_idx] - time[start_idx])) : 0.0;
+
+        // Keep the range as one segment if it is within tolerance and limits, or if it cannot be split
+
+        if(end_idx == start_idx + 1 ||
+          (max_err <= tolerance && fgCheckRef(limits, ref[end_idx], grad, acceleration, &meta) == FG_OK))
+        {
+            reduced_ref [num_reduced] = ref [end_idx];
+            reduced_time[num_reduced] = time[end_idx];
+            num_reduced++;
+
+            if(max_err > max_error)
+            {
+                max_error = max_err;
+            }
+
+            if(stack_len == 0)
+            {
+                break;
+            }
+
+            prev_grad = grad;
+            prev_dt   = time[end_idx] - time[start_idx];
+            start_idx = end_idx;
+            end_idx   = stack[--stack_len];
+        }
+        else
+        {
+            // Split at the furthest point, or in the middle if the range was only rejected by the limits
+
+            if(max_err <= tolerance)
+            {
+                max_idx = start_idx + (end_idx - start_idx) / 2;
+            }
+
+            stack[stack_len++] = end_idx;
+            end_idx = max_idx;
+        }
+    }
+
+    free(stack);
+
+    reduction->num_points  = num_reduced;
+    reduction->max_error   = max_error;
+    reduction->compression = (float)num_points / (float)num_reduced;
+
+    return(FG_OK);
+}
+
 // EOF
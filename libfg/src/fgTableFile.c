@@ -0,0 +1,319 @@
+/*!
+ * @file  fgTableFile.c
+ * @brief Memory-mapped binary table files for the TABLE function.
+ *
+ * <h2>Copyright</h2>
+ *
+ * Copyright CERN 2015. This project is released under the GNU Lesser General
+ * Public License version 3.
+ *
+ * <h2>License</h2>
+ *
+ * This file is part of libfg.
+ *
+ * libfg is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Memory mapping is only available on Unix-like systems
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FG_TABLE_FILE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "libfg/table_file.h"
+
+#define FG_TABLE_FILE_BLOCK_LEN     1024        // Number of elements read at a time when not mapped
+
+
+
+static enum fg_error fgTableFileCheckHeader(const struct fg_table_file_header *header, uint64_t file_len)
+{
+    uint64_t    column_len;
+
+    if(memcmp(header->magic, FG_TABLE_FILE_MAGIC, sizeof(FG_TABLE_FILE_MAGIC)) != 0 ||
+       header->version != FG_TABLE_FILE_VERSION ||
+      (header->element_size != sizeof(float) && header->element_size != sizeof(double)) ||
+       header->time_offset < sizeof(*header) || header->time_offset % header->element_size != 0 ||
+       header->ref_offset  < sizeof(*header) || header->ref_offset  % header->element_size != 0)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    // Check that both columns lie within the file
+
+    column_len = header->num_points * header->element_size;
+
+    if(header->num_points > UINT32_MAX ||
+       header->time_offset > file_len || column_len > file_len - header->time_offset ||
+       header->ref_offset  > file_len || column_len > file_len - header->ref_offset)
+    {
+        return(FG_BAD_ARRAY_LEN);
+    }
+
+    return(FG_OK);
+}
+
+
+
+#ifdef FG_TABLE_FILE_MMAP
+static float *fgTableFileConvert(const char *column, uint32_t num_points)
+{
+    float      *values = malloc((num_points + 1) * sizeof(float));
+    double      value;
+    uint32_t    i;
+
+    if(values != NULL)
+    {
+        for(i = 0 ; i < num_points ; i++)
+        {
+            memcpy(&value, column + i * sizeof(double), sizeof(double));
+
+            values[i] = (float)value;
+        }
+    }
+
+    return(values);
+}
+
+#else
+
+static float *fgTableFileReadColumn(FILE *f, uint64_t offset, uint32_t element_size, uint32_t num_points)
+{
+    float      *values = malloc((num_points + 1) * sizeof(float));
+    double      block[FG_TABLE_FILE_BLOCK_LEN];
+    uint32_t    num_read;
+    uint32_t    i;
+    uint32_t    j;
+
+    if(values == NULL || fseek(f, (long)offset, SEEK_SET) != 0)
+    {
+        free(values);
+        return(NULL);
+    }
+
+    // Float columns are read in place while double columns are read in blocks and converted
+
+    if(element_size == sizeof(float))
+    {
+        if(fread(values, sizeof(float), num_points, f) != num_points)
+        {
+            free(values);
+            return(NULL);
+        }
+
+        return(values);
+    }
+
+    for(i = 0 ; i < num_points ; i += num_read)
+    {
+        num_read = num_points - i < FG_TABLE_FILE_BLOCK_LEN ? num_points - i : FG_TABLE_FILE_BLOCK_LEN;
+
+        if(fread(block, sizeof(double), num_read, f) != num_read)
+        {
+            free(values);
+            return(NULL);
+        }
+
+        for(j = 0 ; j < num_read ; j++)
+        {
+            values[i + j] = (float)block[j];
+        }
+    }
+
+    return(values);
+}
+#endif
+
+
+
+enum fg_error fgTableFileOpen(const char *filename, struct fg_table_file *file)
+{
+    struct fg_table_file_header header;
+    enum fg_error               fg_error;
+
+    memset(file, 0, sizeof(*file));
+
+#ifdef FG_TABLE_FILE_MMAP
+    struct stat     file_stat;
+    char           *map;
+    int             fd;
+
+    // Map the whole file read-only
+
+    fd = open(filename, O_RDONLY);
+
+    if(fd < 0)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    if(fstat(fd, &file_stat) != 0 || file_stat.st_size < (off_t)sizeof(header))
+    {
+        close(fd);
+        return(FG_BAD_PARAMETER);
+    }
+
+    map = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    file->map     = map;
+    file->map_len = file_stat.st_size;
+
+    memcpy(&header, map, sizeof(header));
+
+    if((fg_error = fgTableFileCheckHeader(&header, file->map_len)) != FG_OK)
+    {
+        fgTableFileClose(file);
+        return(fg_error);
+    }
+
+    file->num_points = (uint32_t)header.num_points;
+
+    // The table is validated and generated by scanning forwards through the columns
+
+    madvise(map, file->map_len, MADV_SEQUENTIAL);
+
+    if(header.element_size == sizeof(float))
+    {
+        file->time = (float *)(map + header.time_offset);
+        file->ref  = (float *)(map + header.ref_offset);
+
+        return(FG_OK);
+    }
+
+    // Double columns are converted to float and the file is then unmapped
+
+    file->time = fgTableFileConvert(map + header.time_offset, file->num_points);
+    file->ref  = fgTableFileConvert(map + header.ref_offset,  file->num_points);
+
+    munmap(map, file->map_len);
+
+    file->map     = NULL;
+    file->map_len = 0;
+#else
+    FILE           *f;
+    long            file_len;
+
+    // Read the columns into allocated arrays
+
+    f = fopen(filename, "rb");
+
+    if(f == NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    if(fread(&header, sizeof(header), 1, f) != 1 ||
+       fseek(f, 0, SEEK_END) != 0 || (file_len = ftell(f)) < 0)
+    {
+        fclose(f);
+        return(FG_BAD_PARAMETER);
+    }
+
+    if((fg_error = fgTableFileCheckHeader(&header, (uint64_t)file_len)) != FG_OK)
+    {
+        fclose(f);
+        return(fg_error);
+    }
+
+    file->num_points = (uint32_t)header.num_points;
+    file->time       = fgTableFileReadColumn(f, header.time_offset, header.element_size, file->num_points);
+    file->ref        = fgTableFileReadColumn(f, header.ref_offset,  header.element_size, file->num_points);
+
+    fclose(f);
+#endif
+
+    if(file->time == NULL || file->ref == NULL)
+    {
+        fgTableFileClose(file);
+        return(FG_BAD_PARAMETER);
+    }
+
+    return(FG_OK);
+}
+
+
+
+void fgTableFileClose(struct fg_table_file *file)
+{
+#ifdef FG_TABLE_FILE_MMAP
+    if(file->map != NULL)
+    {
+        munmap(file->map, file->map_len);
+    }
+    else
+#endif
+    {
+        free(file->time);
+        free(file->ref);
+    }
+
+    memset(file, 0, sizeof(*file));
+}
+
+
+
+enum fg_error fgTableFileWrite(const char *filename, const float *time, const float *ref, uint32_t num_points)
+{
+    struct fg_table_file_header header;
+    static const char           padding[FG_TABLE_FILE_ALIGN];
+    uint64_t                    column_len = (uint64_t)num_points * sizeof(float);
+    uint64_t                    padded_len = (column_len + FG_TABLE_FILE_ALIGN - 1) / FG_TABLE_FILE_ALIGN * FG_TABLE_FILE_ALIGN;
+    FILE                       *f;
+    int                         is_error;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FG_TABLE_FILE_MAGIC, sizeof(FG_TABLE_FILE_MAGIC));
+
+    header.version      = FG_TABLE_FILE_VERSION;
+    header.element_size = sizeof(float);
+    header.num_points   = num_points;
+    header.time_offset  = FG_TABLE_FILE_ALIGN;
+    header.ref_offset   = FG_TABLE_FILE_ALIGN + padded_len;
+
+    f = fopen(filename, "wb");
+
+    if(f == NULL)
+    {
+        return(FG_BAD_PARAMETER);
+    }
+
+    // Header and time column are padded so that the columns start on page boundaries
+
+    is_error = fwrite(&header, sizeof(header), 1, f) != 1 ||
+               fwrite(padding, 1, FG_TABLE_FILE_ALIGN - sizeof(header), f) != FG_TABLE_FILE_ALIGN - sizeof(header) ||
+               fwrite(time, sizeof(float), num_points, f) != num_points ||
+               fwrite(padding, 1, padded_len - column_len, f) != padded_len - column_len ||
+               fwrite(ref, sizeof(float), num_points, f) != num_points;
+
+    is_error |= fclose(f) != 0;
+
+    return(is_error ? FG_BAD_PARAMETER : FG_OK);
+}
+
+// EOF
@@ -172,16 +172,16 @@ enum fg_error fgTestInit(struct fg_limits *limits,
 
 
 
-enum fg_gen_status fgTestGen(struct fg_test *pars, const double *time, float *ref)
+enum fg_gen_status fgTestEval(const struct fg_test *pars, double time, float *ref)
 {
     double      radians;
     float       cos_rads = 0.0;
     float       delta_ref;
     double      func_time;                     // Time within function
 
-    // Both *time and delay must be 64-bit doubles if time is UNIX time
+    // Both time and delay must be 64-bit doubles if time is UNIX time
 
-    func_time = *time - pars->delay;
+    func_time = time - pars->delay;
 
     // Pre-acceleration coast
 
@@ -270,4 +270,11 @@ enum fg_gen_status fgTestGen(struct fg_test *pars, const double *time, float *re
     return(FG_GEN_AFTER_FUNC);
 }
 
+
+
+enum fg_gen_status fgTestGen(struct fg_test *pars, const double *time, float *ref)
+{
+    return(fgTestEval(pars, *time, ref));
+}
+
 // EOF
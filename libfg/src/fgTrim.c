@@ -205,14 +205,14 @@ enum fg_error fgTrimInit(struct fg_limits *limits,
 
 
 
-enum fg_gen_status fgTrimGen(struct fg_trim *pars, const double *time, float *ref)
+enum fg_gen_status fgTrimEval(const struct fg_trim *pars, double time, float *ref)
 {
     double   func_time;                     // Time within function
     float    seg_time;                      // Time within segment
 
-    // Both *time and delay must be 64-bit doubles if time is UNIX time
+    // Both time and delay must be 64-bit doubles if time is UNIX time
 
-    func_time = *time - pars->delay;
+    func_time = time - pars->delay;
 
     // Pre-trim coast
 
@@ -240,4 +240,11 @@ enum fg_gen_status fgTrimGen(struct fg_trim *pars, const double *time, float *re
     return(FG_GEN_AFTER_FUNC);
 }
 
+
+
+enum fg_gen_status fgTrimGen(struct fg_trim *pars, const double *time, float *ref)
+{
+    return(fgTrimEval(pars, *time, ref));
+}
+
 // EOF
@@ -173,6 +173,17 @@ void regMeasFilterInit(struct reg_meas_filter *filter, uint32_t fir_length[2],
 void regMeasSetNoiseAndTone(struct reg_noise_and_tone *noise_and_tone, float noise_pp,
                             float tone_amp, uint32_t tone_half_period_iters);
 
+/*!
+ * Set the seed of the pseudo-random number generator used for the noise by regMeasNoiseAndToneRT().
+ * The generator is shared by all simulated measurements, so the seed defines the noise sequence for
+ * all of them. Setting the same seed before a simulation reproduces the same noise.
+ *
+ * This is a non-Real-Time function: do not call from the real-time thread or interrupt
+ *
+ * @param[in]     seed                       New generator state. Zero restores the initial seed.
+ */
+void regMeasSetNoiseSeed(uint32_t seed);
+
 /*!
  * Filter the measurement with a two-stage cascaded box car filter and extrapolate
  * to estimate the measurement without the measurement and FIR filtering delays.
@@ -29,6 +29,16 @@
 #include <string.h>
 #include "libreg.h"
 
+/*!
+ * Initial seed of the simulated measurement noise generator.
+ */
+#define REG_MEAS_NOISE_INITIAL_SEED     0x8E35B19C
+
+/*!
+ * State of the simulated measurement noise generator, which is shared by all simulated measurements.
+ */
+static uint32_t noise_random_generator = REG_MEAS_NOISE_INITIAL_SEED;
+
 /*!
  * Classical two-stage box-car FIR filter used by regMeasFilterRT() and regMeasFilterInit().
  *
@@ -176,6 +186,15 @@ void regMeasSetNoiseAndTone(struct reg_noise_and_tone *noise_and_tone, float noi
 
 
 
+void regMeasSetNoiseSeed(uint32_t seed)
+{
+    // A zero state would lock the generator at zero, so zero restores the initial seed
+
+    noise_random_generator = seed != 0 ? seed : REG_MEAS_NOISE_INITIAL_SEED;
+}
+
+
+
 // Real-Time Functions
 
 static float regMeasFirFilterRT(struct reg_meas_filter *filter)
@@ -287,7 +306,6 @@ float regMeasNoiseAndToneRT(struct reg_noise_and_tone *noise_and_tone)
 {
     float            noise;                                 // Roughly white noise
     float            tone;                                  // Square wave tone
-    static uint32_t  noise_random_generator = 0x8E35B19C;   // Use fixed initial seed
 
     // Use efficient random number generator to calculate the roughly white noise
 
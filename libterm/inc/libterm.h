@@ -23,6 +23,7 @@
 #define LIBTERM_H
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // Useful ANSI terminal sequences
@@ -74,6 +75,54 @@
 #define TERM_BG_CYAN                    ";46"
 #define TERM_BG_WHITE                   ";47"
 
+// Terminal line editor constants
+
+#define TERM_NUM_LINE_BUFS              32                      // Must be a power of 2 !!!
+#define TERM_MAX_LINE_LEN               254                     // Maximum line length - the current maximum
+                                                                // is given by term::max_line_len
+#define TERM_OUT_BUF_LEN                4096                    // Output buffer length
+
+// Terminal structure - one per terminal served by the process
+
+struct term
+{
+    uint16_t     max_line_len;                                  // Max line len is number_of_columns-2
+    uint16_t     level;                                         // Keyboard character processing level
+    uint16_t     line_idx;                                      // Line editor buffer index
+    uint16_t     line_end;                                      // Line editor end of buffer contents index
+    uint16_t     cur_line;                                      // Current line in line_bufs[] history
+    uint16_t     recall_line;                                   // Recall line in line_bufs[] history
+    uint16_t     line_len[TERM_NUM_LINE_BUFS];                  // History line lengths
+    char         line_buf[TERM_MAX_LINE_LEN+2];                 // Edit line buffer
+    char         line_bufs[TERM_NUM_LINE_BUFS][TERM_MAX_LINE_LEN+2]; // Line buffers for history
+    FILE        *file;                                          // Stream for writing to the terminal
+    void        (*term_line)(struct term *term, char *line, uint16_t line_len); // User callback for command lines
+    void        *user;                                          // User data for the callback (not used by libterm)
+    char         prompt;                                        // Prompt character
+    uint16_t     out_len;                                       // Number of characters in out_buf
+    uint16_t     batch_f;                                       // Echo suppressed while processing a chunk
+    uint16_t     redraw_f;                                      // Line must be redrawn at the end of the chunk
+    uint16_t     bell_f;                                        // Bell must be rung at the end of the chunk
+    char         out_buf[TERM_OUT_BUF_LEN];                     // Output buffer flushed once per chunk
+};
+
+// Real-time display constants
+
+#define TERM_RTD_MAX_ROWS               8                       // Maximum number of RTD lines
+#define TERM_RTD_MAX_COLS               160                     // Maximum number of RTD columns
+
+// Real-time display structure - a block of lines that is updated by sending only the cells that change
+
+struct term_rtd
+{
+    uint16_t     first_row;                                     // Terminal row of the first RTD line (from 1)
+    uint16_t     num_rows;                                      // Number of RTD lines
+    uint16_t     num_cols;                                      // Number of RTD columns
+    uint16_t     redraw_f;                                      // All cells must be sent on the next update
+    char         screen[TERM_RTD_MAX_ROWS][TERM_RTD_MAX_COLS];  // Shadow of the cells shown on the terminal
+    char         next[TERM_RTD_MAX_ROWS][TERM_RTD_MAX_COLS];    // Cells to be shown on the next update
+};
+
 // Function declarations
 
 #ifdef __cplusplus
@@ -83,6 +132,21 @@ extern "C" {
 void     TermLibInit    (FILE *file, void (*term_line)(char *line, uint16_t line_len), char prompt);
 void     TermInit       (uint16_t number_of_columns);
 uint16_t TermChar       (char keyboard_ch);
+uint16_t TermChars      (const char *buf, size_t len);
+
+// Reentrant versions for applications that serve more than one terminal
+
+void     TermLibInitR   (struct term *term, FILE *file,
+                         void (*term_line)(struct term *term, char *line, uint16_t line_len), char prompt);
+void     TermInitR      (struct term *term, uint16_t number_of_columns);
+uint16_t TermCharR      (struct term *term, char keyboard_ch);
+uint16_t TermCharsR     (struct term *term, const char *buf, size_t len);
+
+// Real-time display
+
+void     TermRtdInit    (struct term_rtd *rtd, uint16_t first_row, uint16_t num_rows, uint16_t num_cols);
+void     TermRtdPrintf  (struct term_rtd *rtd, uint16_t row, uint16_t col, const char *format, ...);
+uint32_t TermRtdUpdate  (struct term_rtd *rtd, FILE *file);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------------------------------------*\
+  File:     rtd.c                                                                       Copyright CERN 2015
+
+  License:  This file is part of libterm.
+
+            libterm is free software: you can redistribute it and/or modify
+            it under the terms of the GNU Lesser General Public License as published by
+            the Free Software Foundation, either version 3 of the License, or
+            (at your option) any later version.
+
+            This program is distributed in the hope that it will be useful,
+            but WITHOUT ANY WARRANTY; without even the implied warranty of
+            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+            GNU Lesser General Public License for more details.
+
+            You should have received a copy of the GNU Lesser General Public License
+            along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  Purpose:  Real-time display (RTD) support for ANSI terminals
+
+  Contact:  cclibs-devs@cern.ch
+
+  Notes:    The RTD is a block of lines at a fixed position on the terminal.  The application prints the
+            complete display into the next screen buffer with TermRtdPrintf() and then calls TermRtdUpdate().
+            This compares the next screen with a shadow copy of what the terminal shows and only sends
+            the cursor moves and characters for the cells that have changed.  A value that does not
+            change therefore costs nothing on the link.
+\*---------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include <stdarg.h>
+
+#include "libterm.h"
+
+// Private constants (this file only)
+
+#define RTD_MIN_GAP             8                       // Unchanged cells that justify a new cursor move
+#define RTD_GOTO_MAX_LEN        12                      // ESC [ row ; col H with a 5-digit row and 3-digit col
+#define RTD_MAX_RUNS            ((TERM_RTD_MAX_COLS+RTD_MIN_GAP)/(RTD_MIN_GAP+1))  // Max runs per row
+#define RTD_OUT_BUF_LEN         (TERM_RTD_MAX_ROWS*(TERM_RTD_MAX_COLS+RTD_MAX_RUNS*RTD_GOTO_MAX_LEN)+16)
+
+/*---------------------------------------------------------------------------------------------------------*/
+void TermRtdInit(struct term_rtd *rtd, uint16_t first_row, uint16_t num_rows, uint16_t num_cols)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function prepares an RTD of num_rows lines starting at terminal row first_row (1 is the top line).
+  It must be called again whenever the terminal is reset or resized, since this forces the next update
+  to redraw every cell.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    rtd->first_row = first_row;
+    rtd->num_rows  = num_rows < TERM_RTD_MAX_ROWS ? num_rows : TERM_RTD_MAX_ROWS;
+    rtd->num_cols  = num_cols < TERM_RTD_MAX_COLS ? num_cols : TERM_RTD_MAX_COLS;
+    rtd->redraw_f  = 1;
+
+    memset(rtd->next, ' ', sizeof(rtd->next));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void TermRtdPrintf(struct term_rtd *rtd, uint16_t row, uint16_t col, const char *format, ...)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function prints into the next screen at row and col (both start from 0).  Text beyond the width of
+  the RTD is discarded.  Nothing is sent to the terminal until TermRtdUpdate() is called.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char        buf[TERM_RTD_MAX_COLS+1];
+    va_list     args;
+    int         len;
+
+    if(row >= rtd->num_rows || col >= rtd->num_cols)
+    {
+        return;
+    }
+
+    va_start(args, format);
+    len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if(len > 0)
+    {
+        if(len > rtd->num_cols - col)
+        {
+            len = rtd->num_cols - col;
+        }
+
+        memcpy(&rtd->next[row][col], buf, len);
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+uint32_t TermRtdUpdate(struct term_rtd *rtd, FILE *file)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function sends the changes between the next screen and the shadow screen to the terminal with a
+  single write.  Changed cells that are separated by fewer than RTD_MIN_GAP unchanged cells are sent as one
+  run, since a cursor move costs about as much as a few characters.  The cursor position is saved and
+  restored so the RTD can be updated while the user is typing.  The function returns the number of
+  characters written, which is zero if nothing has changed.
+
+  Runs are separated by at least RTD_MIN_GAP unchanged cells, so a row can never need more than
+  RTD_MAX_RUNS cursor moves and RTD_OUT_BUF_LEN holds the worst case.  The space left is still checked
+  before each run, and the buffer is written early if the run would not fit.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char        out_buf[RTD_OUT_BUF_LEN];
+    char        goto_buf[RTD_GOTO_MAX_LEN+1];
+    uint32_t    out_len = 0;
+    uint32_t    num_written = 0;
+    int         goto_len;
+    uint16_t    row;
+    uint16_t    col;
+    uint16_t    start;
+    uint16_t    end;
+
+    for(row = 0 ; row < rtd->num_rows ; row++)
+    {
+        col = 0;
+
+        while(col < rtd->num_cols)
+        {
+            // Skip unchanged cells
+
+            if(!rtd->redraw_f && rtd->next[row][col] == rtd->screen[row][col])
+            {
+                col++;
+                continue;
+            }
+
+            // Extend the run until RTD_MIN_GAP consecutive cells are unchanged
+
+            start = col;
+            end   = col + 1;
+
+            for(col++ ; col < rtd->num_cols && col - end < RTD_MIN_GAP ; col++)
+            {
+                if(rtd->redraw_f || rtd->next[row][col] != rtd->screen[row][col])
+                {
+                    end = col + 1;
+                }
+            }
+
+            // Move the cursor to the start of the run and send the changed characters
+
+            if(out_len + num_written == 0)
+            {
+                memcpy(out_buf, TERM_SAVE_POS, sizeof(TERM_SAVE_POS) - 1);
+                out_len = sizeof(TERM_SAVE_POS) - 1;
+            }
+
+            goto_len = snprintf(goto_buf, sizeof(goto_buf), TERM_CSI "%u;%u" TERM_GOTO,
+                                rtd->first_row + row, start + 1);
+
+            // Write the buffer early if the run and the final restore would not fit
+
+            if(out_len + goto_len + (end - start) + sizeof(TERM_RESTORE_POS) - 1 > RTD_OUT_BUF_LEN)
+            {
+                fwrite(out_buf, 1, out_len, file);
+                num_written += out_len;
+                out_len      = 0;
+            }
+
+            memcpy(&out_buf[out_len], goto_buf, goto_len);
+            out_len += goto_len;
+
+            memcpy(&out_buf[out_len], &rtd->next[row][start], end - start);
+            memcpy(&rtd->screen[row][start], &rtd->next[row][start], end - start);
+
+            out_len += end - start;
+            col      = end;
+        }
+    }
+
+    rtd->redraw_f = 0;
+
+    if(out_len + num_written > 0)
+    {
+        memcpy(&out_buf[out_len], TERM_RESTORE_POS, sizeof(TERM_RESTORE_POS) - 1);
+        out_len += sizeof(TERM_RESTORE_POS) - 1;
+
+        fwrite(out_buf, 1, out_len, file);
+        fflush(file);
+    }
+
+    return(out_len + num_written);
+}
+// EOF
@@ -24,67 +24,107 @@
 \*---------------------------------------------------------------------------------------------------------*/
 
 #include <string.h>
+#include <stdarg.h>
 
 #include "libterm.h"
 
 // Private constants (this file only)
 
-#define NUM_LINE_BUFS           32                      // Must be a power of 2 !!!
-#define LINE_BUFS_MASK          (NUM_LINE_BUFS-1)       // Mask for circular history buffer
-#define MAX_LINE_LEN            254                     // Maximum line length - the current maximum
-                                                        // is given by term_s.max_line_len
+#define LINE_BUFS_MASK          (TERM_NUM_LINE_BUFS-1)  // Mask for circular history buffer
+
 // Static variables (this file only)
 
-static struct term_static
-{
-    uint16_t     max_line_len;                                  // Mex line len is number_of_columns-1
-    uint16_t     level;                                         // Keyboard character processing level
-    uint16_t     line_idx;                                      // Line editor buffer index
-    uint16_t     line_end;                                      // Line editor end of buffer contents index
-    uint16_t     cur_line;                                      // Current line in line_bufs[] history
-    uint16_t     recall_line;                                   // Recall line in line_bufs[] history
-    uint16_t     line_len[NUM_LINE_BUFS];                       // History line lengths
-    char         line_buf[MAX_LINE_LEN+2];                      // Edit line buffer
-    char         line_bufs[NUM_LINE_BUFS][MAX_LINE_LEN+2];      // Line buffers for history
-    FILE        *file;                                          // Stream for writing to the terminal
-    void        (*term_line)(char *line, uint16_t line_len);    // User callback for command lines
-    char         prompt;                                        // Prompt character
-} term_s;
+static struct term term_s;                              // Terminal used by the single terminal functions
+
+static void (*term_s_line)(char *line, uint16_t line_len);  // User callback for term_s command lines
 
 // Static function prototypes (this file only)
 
-static  uint16_t TermLevel0               (char);
-static  uint16_t TermLevel1               (char);
-static  uint16_t TermLevel2               (char);
-static  uint16_t TermLevel3               (char);
-static  uint16_t TermLevel4               (char);
-static  void     TermInsertChar           (char);
-static  void     TermNewline              (void);
-static  void     TermCursorLeft           (void);
-static  void     TermCursorRight          (void);
-static  void     TermStartOfLine          (void);
-static  void     TermEndOfLine            (void);
-static  void     TermDeleteLine           (void);
-static  void     TermDeleteLeft           (void);
-static  void     TermDeleteRight          (void);
-static  void     TermShiftRemains         (void);
-static  void     TermRepeatLine           (void);
-static  void     TermPreviousLine         (void);
-static  void     TermNextLine             (void);
-static  void     TermRecallLine           (uint16_t);
+static  uint16_t TermLevel0               (struct term *, char);
+static  uint16_t TermLevel1               (struct term *, char);
+static  uint16_t TermLevel2               (struct term *, char);
+static  uint16_t TermLevel3               (struct term *, char);
+static  uint16_t TermLevel4               (struct term *, char);
+static  void     TermInsertChar           (struct term *, char);
+static  void     TermNewline              (struct term *);
+static  void     TermCursorLeft           (struct term *);
+static  void     TermCursorRight          (struct term *);
+static  void     TermStartOfLine          (struct term *);
+static  void     TermEndOfLine            (struct term *);
+static  void     TermDeleteLine           (struct term *);
+static  void     TermDeleteLeft           (struct term *);
+static  void     TermDeleteRight          (struct term *);
+static  void     TermShiftRemains         (struct term *);
+static  void     TermRepeatLine           (struct term *);
+static  void     TermPreviousLine         (struct term *);
+static  void     TermNextLine             (struct term *);
+static  void     TermRecallLine           (struct term *, uint16_t);
+static  void     TermRedrawLine           (struct term *);
+static  void     TermFlush                (struct term *);
+static  void     TermOut                  (struct term *, const char *, uint16_t);
+static  void     TermPutc                 (struct term *, char);
+static  void     TermVprintf              (struct term *, const char *, va_list);
+static  void     TermPrintf               (struct term *, const char *, ...);
+static  void     TermEcho                 (struct term *, const char *, ...);
+static  void     TermBell                 (struct term *);
 
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermLine(struct term *term, char *line, uint16_t line_len)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function passes command lines from term_s to the callback given to TermLibInit().
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    term_s_line(line, line_len);
+}
 /*---------------------------------------------------------------------------------------------------------*/
 void TermLibInit(FILE *file, void (*term_line)(char *line, uint16_t line_len), char prompt)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is used to initialise the terminal structure.
 \*---------------------------------------------------------------------------------------------------------*/
 {
-    term_s.term_line = term_line;
-    term_s.file      = file;
-    term_s.prompt    = prompt;
+    term_s_line = term_line;
+
+    TermLibInitR(&term_s, file, TermLine, prompt);
 }
 /*---------------------------------------------------------------------------------------------------------*/
 void TermInit(uint16_t number_of_columns)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    TermInitR(&term_s, number_of_columns);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+uint16_t TermChar(char keyboard_ch)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    return(TermCharR(&term_s, keyboard_ch));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+uint16_t TermChars(const char *buf, size_t len)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    return(TermCharsR(&term_s, buf, len));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void TermLibInitR(struct term *term, FILE *file,
+                  void (*term_line)(struct term *term, char *line, uint16_t line_len), char prompt)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is used to initialise a terminal structure.  Each terminal keeps its own line editor
+  state and history, so one process can serve several terminals.  The user pointer in the structure is
+  not changed and may be set by the application to identify the terminal in the callback.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    term->term_line   = term_line;
+    term->file        = file;
+    term->prompt      = prompt;
+    term->cur_line    = 0;
+    term->recall_line = 0;
+    term->out_len     = 0;
+    term->batch_f     = 0;
+
+    memset(term->line_len, 0, sizeof(term->line_len));
+}
+/*---------------------------------------------------------------------------------------------------------*/
+void TermInitR(struct term *term, uint16_t number_of_columns)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is used to initialise the terminal.  Some old terminals take time to reset and
   ignore characters while they are resetting.  So this function sends dummy spaces to give time for the
@@ -95,34 +135,51 @@ void TermInit(uint16_t number_of_columns)
 
     // Reset terminal
 
-    fputs(TERM_RESET, term_s.file);
+    fputs(TERM_RESET, term->file);
 
     // Send spaces to allow time for terminal to reset
 
     for ( i = 0 ; i < 32; i++ )
     {
-        fputc(' ', term_s.file);
+        fputc(' ', term->file);
     }
 
     // Clear screen, enable line wrap, ring bell
 
-    fputs(TERM_INIT, term_s.file);
+    fputs(TERM_INIT, term->file);
 
     // Reset line buffer variables
 
-    term_s.line_idx     = 0;
-    term_s.line_end     = 0;
-    term_s.level        = 0;
+    term->line_idx     = 0;
+    term->line_end     = 0;
+    term->level        = 0;
+    term->redraw_f     = 0;
+    term->bell_f       = 0;
 
     // Set max line length to  number of terminal columns minus 1 (for the prompt character)
 
-    term_s.max_line_len = number_of_columns - 2;
+    term->max_line_len = number_of_columns - 2;
 }
 /*---------------------------------------------------------------------------------------------------------*/
-uint16_t TermChar(char keyboard_ch)
+uint16_t TermCharR(struct term *term, char keyboard_ch)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function processes one keyboard character.  The echo is written to the terminal stream as soon as
+  the character has been processed.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    return(TermCharsR(term, &keyboard_ch, 1));
+}
 /*---------------------------------------------------------------------------------------------------------*/
+uint16_t TermCharsR(struct term *term, const char *buf, size_t len)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function processes a chunk of keyboard characters, for example everything returned by one read()
+  from the terminal.  The output is collected in term->out_buf and written to the terminal stream with a
+  single write at the end of the chunk.  If the chunk contains more than one character, the echo for each
+  edit is suppressed and the line is redrawn once in its final state, before each completed line is
+  passed to the user's callback and at the end of the chunk.  The bell rings at most once per chunk.
+\*---------------------------------------------------------------------------------------------------------*/
 {
-    static uint16_t       (*term_func[])(char) =         // Keyboard character functions
+    static uint16_t       (*term_func[])(struct term *, char) = // Keyboard character functions
     {
         TermLevel0,                                       // Level 0 : Normal characters
         TermLevel1,                                       // Level 1 : ESC pressed
@@ -131,20 +188,35 @@ uint16_t TermChar(char keyboard_ch)
         TermLevel4,                                       // Level 4 : PF1-PF4 keys
     };
 
-    // Process keyboard character according to level
+    term->batch_f = (len > 1);
+
+    // Process keyboard characters according to level
+
+    while(len-- > 0)
+    {
+        term->level = term_func[term->level](term, *buf++);
+    }
+
+    // Redraw the line if it was edited, ring the bell if required and write the output
 
-    term_s.level = term_func[term_s.level](keyboard_ch);
+    TermRedrawLine(term);
 
-    // Flush the terminal stream
+    if(term->bell_f)
+    {
+        TermPutc(term, TERM_BELL);
+        term->bell_f = 0;
+    }
 
-    fflush(term_s.file);
+    term->batch_f = 0;
+
+    TermFlush(term);
 
     // Return the level
 
-    return(term_s.level);
+    return(term->level);
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static uint16_t TermLevel0(char keyboard_ch)
+static uint16_t TermLevel0(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   Level 0: The keyboard character is analysed directly.  If the ESC code (0x1B) is received, the level
   changes to 1, otherwise the character is processed and the state remains 0.
@@ -156,27 +228,27 @@ static uint16_t TermLevel0(char keyboard_ch)
 
     case 0x7F:                                          // [Delete]     Delete left
 
-    case 0x08:  TermDeleteLeft();            break;     // [Backspace]  Delete left
+    case 0x08:  TermDeleteLeft(term);            break;     // [Backspace]  Delete left
 
-    case 0x04:  TermDeleteRight();           break;     // [CTRL-D]     Delete right
+    case 0x04:  TermDeleteRight(term);           break;     // [CTRL-D]     Delete right
 
-    case 0x15:  TermDeleteLine();            break;     // [CTRL-U]     Delete line
+    case 0x15:  TermDeleteLine(term);            break;     // [CTRL-U]     Delete line
 
-    case 0x01:  TermStartOfLine();           break;     // [CTRL-A]     Move to start of line
+    case 0x01:  TermStartOfLine(term);           break;     // [CTRL-A]     Move to start of line
 
-    case 0x05:  TermEndOfLine();             break;     // [CTRL-E]     Move to end of line
+    case 0x05:  TermEndOfLine(term);             break;     // [CTRL-E]     Move to end of line
 
-    case 0x12:  TermRepeatLine();            break;     // [CTRL-R]     Repeat line
+    case 0x12:  TermRepeatLine(term);            break;     // [CTRL-R]     Repeat line
 
-    case 0x0D:  TermNewline();               break;     // [Return]     Carriage return - return line
+    case 0x0D:  TermNewline(term);               break;     // [Return]     Carriage return - return line
 
-    default:    TermInsertChar(keyboard_ch); break;     // [others]     Insert character
+    default:    TermInsertChar(term, keyboard_ch); break;     // [others]     Insert character
     }
 
     return(0);                                  // Continue with level 0
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static uint16_t TermLevel1(char keyboard_ch)
+static uint16_t TermLevel1(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   Level 1: The previous character was [ESC].
 \*---------------------------------------------------------------------------------------------------------*/
@@ -191,7 +263,7 @@ static uint16_t TermLevel1(char keyboard_ch)
     return(0);                                      // All other characters - return to level 0
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static uint16_t TermLevel2(char keyboard_ch)
+static uint16_t TermLevel2(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   Level 2: The key pressed was either a cursor key or a function key.  Cursors keys have the code
   sequence "ESC[A" to "ESC[D", while function keys have the code sequence "ESC[???~" where ??? is a
@@ -200,19 +272,19 @@ static uint16_t TermLevel2(char keyboard_ch)
 {
     switch(keyboard_ch)                              // Switch according to next code
     {
-    case 0x41:  TermPreviousLine();      return(0);      // [Up]         Previous history line
+    case 0x41:  TermPreviousLine(term);      return(0);      // [Up]         Previous history line
 
-    case 0x42:  TermNextLine();          return(0);      // [Down]       Next history line
+    case 0x42:  TermNextLine(term);          return(0);      // [Down]       Next history line
 
-    case 0x43:  TermCursorRight();       return(0);      // [Right]      Move cursor right
+    case 0x43:  TermCursorRight(term);       return(0);      // [Right]      Move cursor right
 
-    case 0x44:  TermCursorLeft();        return(0);      // [Left]       Move cursor left
+    case 0x44:  TermCursorLeft(term);        return(0);      // [Left]       Move cursor left
     }
 
     return(3);                                      // Function key - change to level 3
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static uint16_t TermLevel3(char keyboard_ch)
+static uint16_t TermLevel3(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   Level 3:  Original Key was a Function with sequence terminated by 0x7E (~).  However, the function will
   also accept a new [ESC] to allow an escape route in case of corrupted reception.
@@ -228,7 +300,7 @@ static uint16_t TermLevel3(char keyboard_ch)
     return(3);                                      // No change to level
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static uint16_t TermLevel4(char keyboard_ch)
+static uint16_t TermLevel4(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   Level 4:  The original key was PF1-4 and one more character must be ignored.
 \*---------------------------------------------------------------------------------------------------------*/
@@ -236,7 +308,7 @@ static uint16_t TermLevel4(char keyboard_ch)
     return(0);                                  // Return to level 0
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermInsertChar(char keyboard_ch)
+static void TermInsertChar(struct term *term, char keyboard_ch)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if a standard character has been received.  It will try to enter
   the character into the current line under the current cursor position.  The rest of the line will be
@@ -249,39 +321,38 @@ static void TermInsertChar(char keyboard_ch)
 
     if(keyboard_ch >= 0x20)
     {
-        if(term_s.line_end >= term_s.max_line_len)     // If line buffer is full then ring the bell
+        if(term->line_end >= term->max_line_len)     // If line buffer is full then ring the bell
         {
-            fputc(TERM_BELL, term_s.file);
+            TermBell(term);
         }
         else
         {
             // Shift the rest of the line by one character and insert the new keyboard character
 
-            for(i = term_s.line_end++ ; i > term_s.line_idx ; i--)
+            for(i = term->line_end++ ; i > term->line_idx ; i--)
             {
-                term_s.line_buf[i] = term_s.line_buf[i-1];
+                term->line_buf[i] = term->line_buf[i-1];
             }
 
-            term_s.line_buf[term_s.line_idx] = keyboard_ch;
+            term->line_buf[term->line_idx] = keyboard_ch;
 
             // Print the new character and the rest of the line to the terminal
 
-            for(i = term_s.line_idx++ ; i < term_s.line_end ; i++)
-            {
-                fputc(term_s.line_buf[i], term_s.file);
-            }
+            TermEcho(term, "%.*s", (int)(term->line_end - term->line_idx), &term->line_buf[term->line_idx]);
+
+            term->line_idx++;
 
             // If cursor is now offset from true position then shift cursor left again
 
-            if((i = term_s.line_end - term_s.line_idx) > 0)
+            if((i = term->line_end - term->line_idx) > 0)
             {
-                fprintf(term_s.file,TERM_CSI "%hu" TERM_LEFT, i);
+                TermEcho(term, TERM_CSI "%hu" TERM_LEFT, i);
             }
         }
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermNewline(void)
+static void TermNewline(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if Enter or Return have been received.  It skips leading
   white space and enters the line into the command buffer and the line history.  It then calls the users
@@ -293,10 +364,10 @@ static void TermNewline(void)
 
     // Nul terminate the line and skip over leading spaces
 
-    line_len = term_s.line_end;
-    term_s.line_buf[term_s.line_end] = '\0';
+    line_len = term->line_end;
+    term->line_buf[term->line_end] = '\0';
 
-    for(line_p=term_s.line_buf ; *line_p==' ' ; line_p++)
+    for(line_p=term->line_buf ; *line_p==' ' ; line_p++)
     {
         line_len--;
     }
@@ -304,80 +375,85 @@ static void TermNewline(void)
     // If new line is different then store it in the line history buffer
 
     if(line_len > 0 &&
-       (term_s.line_end != term_s.line_len[(term_s.cur_line-1) & LINE_BUFS_MASK] ||
-        memcmp(term_s.line_buf, &term_s.line_bufs[(term_s.cur_line-1) & LINE_BUFS_MASK], term_s.line_end)))
+       (term->line_end != term->line_len[(term->cur_line-1) & LINE_BUFS_MASK] ||
+        memcmp(term->line_buf, &term->line_bufs[(term->cur_line-1) & LINE_BUFS_MASK], term->line_end)))
     {
-        term_s.line_len[term_s.cur_line] = term_s.line_end;
-        memcpy(&term_s.line_bufs[term_s.cur_line], term_s.line_buf, term_s.line_end);
-        term_s.cur_line = (term_s.cur_line + 1) & LINE_BUFS_MASK;
+        term->line_len[term->cur_line] = term->line_end;
+        memcpy(&term->line_bufs[term->cur_line], term->line_buf, term->line_end);
+        term->cur_line = (term->cur_line + 1) & LINE_BUFS_MASK;
     }
 
+    // Show the final state of the line and write the output before the user callback can write to the terminal
+
+    TermRedrawLine(term);
+    TermFlush(term);
+
     // Call user callback function to process line buffer
 
-    term_s.term_line(line_p, line_len);
+    term->term_line(term, line_p, line_len);
 
     // Reset cursor and end of line indexes
 
-    term_s.line_idx = 0;
-    term_s.line_end = 0;
-    term_s.recall_line = term_s.cur_line;
+    term->line_idx = 0;
+    term->line_end = 0;
+    term->recall_line = term->cur_line;
 
     // Move cursor to start of newline and print the prompt character
 
-    printf("\r\n%c", term_s.prompt);
+    TermPrintf(term, "\r\n%c", term->prompt);
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermCursorLeft(void)
+static void TermCursorLeft(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel2() if the Cursor left key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // Move cursor left one column or ring bell if at start of line
 
-    if(term_s.line_idx > 0)
+    if(term->line_idx > 0)
     {
-        fputc(TERM_BACKSPACE, term_s.file);
-        term_s.line_idx--;
+        TermEcho(term, "\b");
+        term->line_idx--;
     }
     else
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermCursorRight(void)
+static void TermCursorRight(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel2() if the Cursor right key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // Move cursor right one column or ring bell if at end of content on the line
 
-    if(term_s.line_idx < term_s.line_end)
+    if(term->line_idx < term->line_end)
     {
-        fputs(TERM_CSI TERM_RIGHT, term_s.file);
-        term_s.line_idx++;
+        TermEcho(term, TERM_CSI TERM_RIGHT);
+        term->line_idx++;
     }
     else
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermStartOfLine(void)
+static void TermStartOfLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if the Ctrl-A key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // If cursor is not already at the start of the line then move cursor left to the start of line
 
-    if(term_s.line_idx > 0)
+    if(term->line_idx > 0)
     {
-        fprintf(term_s.file, TERM_CSI "%hu" TERM_LEFT, term_s.line_idx);
-        term_s.line_idx = 0;
+        TermEcho(term, TERM_CSI "%hu" TERM_LEFT, term->line_idx);
+        term->line_idx = 0;
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermEndOfLine(void)
+static void TermEndOfLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if the Ctrl-E key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
@@ -386,63 +462,63 @@ static void TermEndOfLine(void)
 
     // If cursor is not already at the end of the contents of the line then move cursor to end of contents
 
-    if((shift_right = term_s.line_end - term_s.line_idx) > 0)
+    if((shift_right = term->line_end - term->line_idx) > 0)
     {
-        fprintf(term_s.file, TERM_CSI "%hu" TERM_RIGHT, shift_right);
-        term_s.line_idx = term_s.line_end;
+        TermEcho(term, TERM_CSI "%hu" TERM_RIGHT, shift_right);
+        term->line_idx = term->line_end;
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermDeleteLine(void)
+static void TermDeleteLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if the Ctrl-U key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // Clear line and print prompt
 
-    fprintf(term_s.file, TERM_CLR_LINE "\r%c", term_s.prompt);
+    TermEcho(term, TERM_CLR_LINE "\r%c", term->prompt);
 
-    term_s.line_idx = 0;
-    term_s.line_end = 0;
+    term->line_idx = 0;
+    term->line_end = 0;
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermDeleteLeft(void)
+static void TermDeleteLeft(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if the backspace or delete keys have been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // Delete character to left of cursor or ring bell if at start of line
 
-    if(term_s.line_idx > 0)
+    if(term->line_idx > 0)
     {
-        fputc(TERM_BACKSPACE, term_s.file);
-        term_s.line_idx--;
-        TermShiftRemains();             // Shift remains of the line one character to the left
+        TermEcho(term, "\b");
+        term->line_idx--;
+        TermShiftRemains(term);             // Shift remains of the line one character to the left
     }
     else
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermDeleteRight(void)
+static void TermDeleteRight(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if the Ctrl-D key has been pressed.
 \*---------------------------------------------------------------------------------------------------------*/
 {
     // Delete to right of cursor or ring bell if at end of content on the line
 
-    if(term_s.line_idx < term_s.line_end)
+    if(term->line_idx < term->line_end)
     {
-        TermShiftRemains();             // Shift remains of the line one character to the left
+        TermShiftRemains(term);             // Shift remains of the line one character to the left
     }
     else
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermShiftRemains(void)
+static void TermShiftRemains(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermDeleteLeft() and TermDeleteRight() to shift the remains of the line
   one character to the left.
@@ -450,21 +526,23 @@ static void TermShiftRemains(void)
 {
     uint16_t      i;
 
-    term_s.line_end--;                           // Adjust end of line index
+    term->line_end--;                           // Adjust end of line index
 
     // For the remainder of the line shift characters in buffer and display it
 
-    for(i = term_s.line_idx ; i < term_s.line_end ; i++)
+    for(i = term->line_idx ; i < term->line_end ; i++)
     {
-        fputc( (term_s.line_buf[i] = term_s.line_buf[i+1]), term_s.file);
+        term->line_buf[i] = term->line_buf[i+1];
     }
 
+    TermEcho(term, "%.*s", (int)(term->line_end - term->line_idx), &term->line_buf[term->line_idx]);
+
     // Clear last character and move cursor the required number of columns to the left
 
-    fprintf(term_s.file, " " TERM_CSI "%hu" TERM_LEFT, (uint16_t)(1 + term_s.line_end - term_s.line_idx));
+    TermEcho(term, " " TERM_CSI "%hu" TERM_LEFT, (uint16_t)(1 + term->line_end - term->line_idx));
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermRepeatLine(void)
+static void TermRepeatLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel0() if Ctrl-R is entered.  It recovers the previous line from
   the line history and enters it.
@@ -474,21 +552,21 @@ static void TermRepeatLine(void)
 
     // Calc index of previous line in history and return if empty
 
-    recall_line = (term_s.cur_line - 1) & LINE_BUFS_MASK;
+    recall_line = (term->cur_line - 1) & LINE_BUFS_MASK;
 
-    if(!term_s.line_len[recall_line])
+    if(!term->line_len[recall_line])
     {
         return;
     }
 
     // Recall and process line and adjust current line index to avoid a repeat entry in the history
 
-    term_s.cur_line = recall_line;
-    TermRecallLine(recall_line);
-    TermNewline();
+    term->cur_line = recall_line;
+    TermRecallLine(term, recall_line);
+    TermNewline(term);
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermPreviousLine(void)
+static void TermPreviousLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel2() if cursor up is pressed.  It will recover the previous line from
   the line history buffers.
@@ -498,28 +576,28 @@ static void TermPreviousLine(void)
 
     // If editing current line then save it in the history
 
-    if(term_s.recall_line == term_s.cur_line)
+    if(term->recall_line == term->cur_line)
     {
-        term_s.line_len[term_s.cur_line] = term_s.line_end;
-        memcpy(&term_s.line_bufs[term_s.cur_line], term_s.line_buf, term_s.line_end);
+        term->line_len[term->cur_line] = term->line_end;
+        memcpy(&term->line_bufs[term->cur_line], term->line_buf, term->line_end);
     }
 
     // Adjust line index to previous line and recall the line if it is not empty
 
-    recall_line = (term_s.recall_line - 1) & LINE_BUFS_MASK;
+    recall_line = (term->recall_line - 1) & LINE_BUFS_MASK;
 
-    if(recall_line == term_s.cur_line ||
-       !term_s.line_len[recall_line])
+    if(recall_line == term->cur_line ||
+       !term->line_len[recall_line])
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
     else
     {
-        TermRecallLine(recall_line);
+        TermRecallLine(term, recall_line);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermNextLine(void)
+static void TermNextLine(struct term *term)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermLevel2() if cursor down is pressed.  It will recover the next line from
   the line history buffers.
@@ -527,17 +605,17 @@ static void TermNextLine(void)
 {
     // Recall next line unless already at the most recent line in the history
 
-    if(term_s.recall_line == term_s.cur_line)
+    if(term->recall_line == term->cur_line)
     {
-        fputc(TERM_BELL, term_s.file);
+        TermBell(term);
     }
     else
     {
-        TermRecallLine((term_s.recall_line + 1) & LINE_BUFS_MASK);
+        TermRecallLine(term, (term->recall_line + 1) & LINE_BUFS_MASK);
     }
 }
 /*---------------------------------------------------------------------------------------------------------*/
-static void TermRecallLine(uint16_t recall_line)
+static void TermRecallLine(struct term *term, uint16_t recall_line)
 /*---------------------------------------------------------------------------------------------------------*\
   This function is called from TermRepeatLine(), TermPreviousLine() or TermNextLine() when a history line
   needs to be recalled.
@@ -546,17 +624,134 @@ static void TermRecallLine(uint16_t recall_line)
     // Save recalled line index and recover line length and data
     // If window is now narrower then truncate the recovered line
 
-    term_s.recall_line = recall_line;
-    term_s.line_idx = 
-    term_s.line_end = (term_s.line_len[recall_line] < term_s.max_line_len ?
-                       term_s.line_len[recall_line] : term_s.max_line_len);
+    term->recall_line = recall_line;
+    term->line_idx = 
+    term->line_end = (term->line_len[recall_line] < term->max_line_len ?
+                       term->line_len[recall_line] : term->max_line_len);
 
-    memcpy(term_s.line_buf,&term_s.line_bufs[recall_line],term_s.line_end);
+    memcpy(term->line_buf,&term->line_bufs[recall_line],term->line_end);
 
     // Nul terminate recalled line and display it following the prompt
 
-    term_s.line_buf[term_s.line_end] = '\0';
+    term->line_buf[term->line_end] = '\0';
+
+    TermEcho(term, TERM_CLR_LINE "\r%c%s", term->prompt, term->line_buf);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermRedrawLine(struct term *term)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is called from TermChars() and TermNewline().  If echo was suppressed while the line was
+  edited, it redraws the prompt and the line and places the cursor at term->line_idx.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    uint16_t      shift_left;
+
+    if(term->redraw_f)
+    {
+        term->redraw_f = 0;
+
+        TermPrintf(term, TERM_CLR_LINE "\r%c%.*s", term->prompt, (int)term->line_end, term->line_buf);
 
-    fprintf(term_s.file, TERM_CLR_LINE "\r%c%s", term_s.prompt, term_s.line_buf);
+        if((shift_left = term->line_end - term->line_idx) > 0)
+        {
+            TermPrintf(term, TERM_CSI "%hu" TERM_LEFT, shift_left);
+        }
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermFlush(struct term *term)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function writes the contents of the output buffer to the terminal stream and flushes the stream.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    if(term->out_len > 0)
+    {
+        fwrite(term->out_buf, 1, term->out_len, term->file);
+        term->out_len = 0;
+    }
+
+    fflush(term->file);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermOut(struct term *term, const char *buf, uint16_t len)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function appends characters to the output buffer.  The buffer is only written before the end of
+  the chunk if it would overflow.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    if(term->out_len + len > TERM_OUT_BUF_LEN)
+    {
+        TermFlush(term);
+    }
+
+    memcpy(&term->out_buf[term->out_len], buf, len);
+    term->out_len += len;
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermPutc(struct term *term, char ch)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    TermOut(term, &ch, 1);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermVprintf(struct term *term, const char *format, va_list args)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function formats into the output buffer.  The local buffer is long enough for every format used
+  by libterm since lines are limited to MAX_LINE_LEN characters.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    char          buf[TERM_MAX_LINE_LEN+32];
+    int           len;
+
+    len = vsnprintf(buf, sizeof(buf), format, args);
+
+    if(len > 0)
+    {
+        TermOut(term, buf, len < (int)sizeof(buf) ? len : sizeof(buf) - 1);
+    }
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermPrintf(struct term *term, const char *format, ...)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is used for output that is always written, such as the new line and prompt.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    va_list       args;
+
+    va_start(args, format);
+    TermVprintf(term, format, args);
+    va_end(args);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermEcho(struct term *term, const char *format, ...)
+/*---------------------------------------------------------------------------------------------------------*\
+  This function is used for the echo of line edits.  While a chunk is processed by TermChars() the echo
+  is suppressed and the line is marked to be redrawn instead.
+\*---------------------------------------------------------------------------------------------------------*/
+{
+    va_list       args;
+
+    if(term->batch_f)
+    {
+        term->redraw_f = 1;
+        return;
+    }
+
+    va_start(args, format);
+    TermVprintf(term, format, args);
+    va_end(args);
+}
+/*---------------------------------------------------------------------------------------------------------*/
+static void TermBell(struct term *term)
+/*---------------------------------------------------------------------------------------------------------*/
+{
+    if(term->batch_f)
+    {
+        term->bell_f = 1;
+    }
+    else
+    {
+        TermPutc(term, TERM_BELL);
+    }
 }
 // EOF